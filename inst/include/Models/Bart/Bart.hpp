@@ -45,6 +45,7 @@ namespace BOOM {
     // abstract class because each concrete class of BART model has
     // its own notion of what a "residual" means.
     class ResidualRegressionData;
+    class QuantizedPredictors;
 
     // Because each model has its own class of residuals, each needs
     // its own class of complete data sufficient statistics for
@@ -153,8 +154,18 @@ namespace BOOM {
       // Args:
       //   discrete_distribution_cutoff: The number of unique values a
       //     numeric variable must have before it is considered continuous.
+      //   max_bins: If positive, finalize() also builds a table of at
+      //     most max_bins bin edges that posterior samplers can use to
+      //     store the predictor as a small integer code (see
+      //     QuantizedPredictors).  If the variable has no more than
+      //     max_bins unique values the table is the set of unique
+      //     values, and cutpoints are unaffected.  Otherwise the edges
+      //     are chosen so that the bins hold roughly equal numbers of
+      //     observations, and the variable is treated as discrete with
+      //     the bin edges as its set of potential cutpoints.
       void finalize(int discrete_distribution_cutoff = 20,
-                    ContinuousCutpointStrategy = UNIFORM_CONTINUOUS);
+                    ContinuousCutpointStrategy = UNIFORM_CONTINUOUS,
+                    int max_bins = 0);
 
       // Serialize the value of this variable summary for long term
       // storage.
@@ -184,6 +195,11 @@ namespace BOOM {
       // at node or at any of its descendants.
       bool is_legal_configuration(const TreeNode *node) const;
 
+      // The sorted table of bin edges built by finalize().  Empty if
+      // finalize() was not asked to build one.  Bin edges are not
+      // serialized.
+      const Vector &bin_edges() const {return bin_edges_;}
+
      private:
       // Checks whether finalize() has been called.  Throws an
       // exception if it has not.
@@ -194,6 +210,7 @@ namespace BOOM {
       void check_finalized(const char *function_name) const;
       int variable_number_;
       Vector observed_values_;
+      Vector bin_edges_;
       std::shared_ptr<VariableSummaryImpl> impl_;
     };
 
@@ -441,6 +458,28 @@ namespace BOOM {
       }
 
      private:
+      // Returns true if the observation falls to the left of this
+      // node's cutpoint.
+      bool goes_left(const ResidualRegressionData *dp);
+
+      // Returns the bin code threshold for this node's splitting rule
+      // under 'predictors' (see QuantizedPredictors::threshold).  The
+      // value is cached, and recomputed only after the splitting rule
+      // changes or the data are quantized by a different object.
+      int quantized_threshold(const QuantizedPredictors *predictors);
+
+      // Discard the cached value of quantized_threshold().  Called
+      // whenever which_variable_ or cutpoint_ changes, and when the
+      // node's data are removed.
+      void invalidate_quantized_threshold() {
+        threshold_predictors_ = NULL;
+      }
+
+      // Divide data_ between the (empty) children of this node, and
+      // recursively among their descendants.  If the data carry
+      // quantized predictors the partition is done on the bin codes.
+      void partition_data_to_children();
+
       // For singleton trees, it is possible for a node to be a root and
       // a leaf simultaneously.
       TreeNode *parent_;       // NULL if this is a root.
@@ -461,6 +500,13 @@ namespace BOOM {
       // cutpoint_, and right if x > cutpoint_.
       int which_variable_;         // Used iff this is not a leaf.
       double cutpoint_;            // Used iff this is not a leaf.
+
+      // The cached value of quantized_threshold(), which is valid if
+      // threshold_predictors_ is the QuantizedPredictors it was
+      // computed from.  A NULL threshold_predictors_ means no value is
+      // cached.
+      const QuantizedPredictors *threshold_predictors_;
+      int quantized_threshold_;
     };
 
     inline ostream & operator<<(ostream &out, const TreeNode &node) {
@@ -585,6 +631,12 @@ namespace BOOM {
       // falls through keeps a copy of the pointer.
       void populate_data(ResidualRegressionData *data);
 
+      // Drops a collection of data points through the tree.  This is
+      // equivalent to calling populate_data on each element, but the
+      // data are partitioned one node at a time, which is faster for
+      // large data sets.  The tree should not already hold data.
+      void populate_data(const std::vector<ResidualRegressionData *> &data);
+
       // Removes the data from the nodes in the tree, and deletes the
       // sufficient statistics objects summarizing the data.
       void clear_data_and_delete_suf();
@@ -688,10 +740,24 @@ namespace BOOM {
     // After you're done adding data to the model, call
     // finalize_data() to let the variable summaries know that all
     // data has been observed.
+    //
+    // If max_predictor_bins is positive (at most 65536) then
+    // posterior samplers will store each predictor as a bin code of 8
+    // bits per cell (if the variable has at most 256 bins) or 16 bits,
+    // and use the codes to drop data through the trees.  The codes are
+    // kept in addition to the model's own predictors, so they add to
+    // memory use rather than reduce it.  The gain is speed: dropping
+    // data through a tree scans one column of small codes.  See
+    // VariableSummary::finalize for how the bins are chosen.
     void finalize_data(
         int discrete_distribution_cutoff = 20,
         Bart::ContinuousCutpointStrategy strategy =
-        Bart::UNIFORM_CONTINUOUS);
+        Bart::UNIFORM_CONTINUOUS,
+        int max_predictor_bins = 0);
+
+    // The value of max_predictor_bins passed to finalize_data().
+    // Zero indicates the predictors are not to be quantized.
+    int max_predictor_bins() const {return max_predictor_bins_;}
 
     // Returns the VariableSummary associated with the variable at the
     // given index.
@@ -741,6 +807,7 @@ namespace BOOM {
     // the set of cutpoints available to the model.
     std::vector<Bart::VariableSummary> variable_summaries_;
     std::vector<std::shared_ptr<Bart::Tree> > trees_;
+    int max_predictor_bins_;
   };
 
 }  // namespace BOOM
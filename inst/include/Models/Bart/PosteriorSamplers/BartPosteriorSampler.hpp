@@ -20,6 +20,7 @@
 #define BART_POSTERIOR_SAMPLER_BASE_HPP_
 
 #include <Models/Bart/Bart.hpp>
+#include <Models/Bart/QuantizedPredictors.hpp>
 #include <Models/GaussianModel.hpp>
 #include <Models/PosteriorSamplers/PosteriorSampler.hpp>
 #include <cpputil/math_utils.hpp>
@@ -200,6 +201,14 @@ namespace BOOM {
     // To be called with a new tree.
     void fill_tree_with_residual_data(Bart::Tree *tree);
 
+    // If the model asked for quantized predictors (see
+    // BartModelBase::finalize_data) then store the predictors for
+    // 'data' as bin codes, and point each element of 'data' at its
+    // codes.  Otherwise discard any existing codes.  Element i of
+    // data must be the residual for observation i.
+    void quantize_predictors(
+        const std::vector<Bart::ResidualRegressionData *> &data);
+
     //--------------------------------------------------------------
     // Moves used to implement draw.
 
@@ -321,6 +330,10 @@ namespace BOOM {
     // Functor returning log P(model_->number_of_trees).
     std::function<double(int)> log_prior_number_of_trees_;
 
+    // Compact copies of the predictors, used to drop data through the
+    // trees.  NULL unless the model asked for quantized predictors.
+    std::shared_ptr<Bart::QuantizedPredictors> quantized_predictors_;
+
     // The types of moves (for manipulating a single tree) considered
     // by the Metropolis-Hastings algorithm.
     enum TreeStructureMoveType {
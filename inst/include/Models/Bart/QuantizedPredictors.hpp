@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_BART_QUANTIZED_PREDICTORS_HPP_
+#define BOOM_BART_QUANTIZED_PREDICTORS_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <LinAlg/Vector.hpp>
+#include <LinAlg/VectorView.hpp>
+
+namespace BOOM {
+  namespace Bart {
+    class ResidualRegressionData;
+
+    // A column-wise store of the predictors used to fit a Bart model,
+    // where each predictor value is replaced by a small integer bin
+    // code.  Variable j has a sorted table of bin edges e[0] < e[1] <
+    // ... < e[K-1], and a value x is stored as the number of edges
+    // strictly less than x, so that x in (e[k-1], e[k]] has code k.
+    // Variables with at most 256 bins use one byte per cell, and
+    // those with at most 65536 bins use two.
+    //
+    // If every cutpoint used to split on variable j is one of its bin
+    // edges (or if the edges contain every observed value of variable
+    // j) then x <= cutpoint exactly when code(x) < threshold(j,
+    // cutpoint), so tree nodes can partition their data by comparing
+    // codes without touching the double precision predictors.  The
+    // codes are a second copy of the predictors, made so that the
+    // partitions read less memory; the model keeps its own copy.
+    class QuantizedPredictors {
+     public:
+      // Args:
+      //   bin_edges: Element j is the sorted, duplicate-free vector of
+      //     bin edges for variable j.  Each vector must be non-empty
+      //     and have at most 65536 elements.
+      explicit QuantizedPredictors(const std::vector<Vector> &bin_edges);
+
+      // Append the bin codes for an observation with predictors x.
+      // Values larger than the largest bin edge are placed in the
+      // last bin.
+      void add_observation(const ConstVectorView &x);
+      void add_observation(const Vector &x) {
+        add_observation(ConstVectorView(x));
+      }
+
+      int sample_size() const {return sample_size_;}
+      int number_of_variables() const {return bin_edges_.size();}
+
+      // The number of bytes used to store each value of the given
+      // variable (either 1 or 2).
+      int bytes_per_cell(int variable) const {
+        return bytes_per_cell_[variable];
+      }
+
+      // The bin code for the given variable and observation.
+      int code(int variable, int observation) const {
+        return bytes_per_cell_[variable] == 1
+            ? narrow_codes_[variable][observation]
+            : wide_codes_[variable][observation];
+      }
+
+      // Returns the number of bin edges that are <= cutpoint.  An
+      // observation belongs to the left of the cutpoint if its code is
+      // less than the threshold.
+      int threshold(int variable, double cutpoint) const;
+
+      // Divide 'data' into the observations with code(variable, i) <
+      // threshold, which are appended to 'left', and the rest, which
+      // are appended to 'right'.  The relative order of the data is
+      // preserved.  Each element of data must have been quantized by
+      // *this.
+      void partition(int variable,
+                     int threshold,
+                     const std::vector<ResidualRegressionData *> &data,
+                     std::vector<ResidualRegressionData *> &left,
+                     std::vector<ResidualRegressionData *> &right) const;
+
+     private:
+      std::vector<Vector> bin_edges_;
+      std::vector<int> bytes_per_cell_;
+
+      // Element j of narrow_codes_ is used if bytes_per_cell_[j] is 1,
+      // and element j of wide_codes_ otherwise.
+      std::vector<std::vector<std::uint8_t>> narrow_codes_;
+      std::vector<std::vector<std::uint16_t>> wide_codes_;
+      int sample_size_;
+    };
+
+  }  // namespace Bart
+}  // namespace BOOM
+
+#endif  // BOOM_BART_QUANTIZED_PREDICTORS_HPP_
@@ -28,6 +28,7 @@ namespace BOOM{
     class ProbitSufficientStatistics;
     class LogitSufficientStatistics;
     class PoissonSufficientStatistics;
+    class QuantizedPredictors;
 
     // ResidualRegressionData is used by Bart posterior samplers to
     // associate one or more residuals with RegressionData,
@@ -49,6 +50,19 @@ namespace BOOM{
       // The vector of predictors associated with this observation.
       const Vector &x() const;
 
+      // If the posterior sampler has quantized the predictors then
+      // this observation's predictors are also available as bin codes
+      // in row 'observation_index' of 'predictors'.  Tree nodes use
+      // the codes in place of x() when partitioning data.
+      void set_quantized_predictors(const QuantizedPredictors *predictors,
+                                    int observation_index);
+
+      // Returns NULL if the predictors have not been quantized.
+      const QuantizedPredictors *quantized_predictors() const {
+        return quantized_predictors_;
+      }
+      int observation_index() const {return observation_index_;}
+
       // Adjust the residual at this data point by the specified
       // value.  The notion is
       //
@@ -75,6 +89,8 @@ namespace BOOM{
 
      private:
       const VectorData *predictor_;
+      const QuantizedPredictors *quantized_predictors_;
+      int observation_index_;
     };
 
   }  // namespace Bart
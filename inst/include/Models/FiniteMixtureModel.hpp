@@ -52,6 +52,20 @@ namespace BOOM{
     void class_membership_probability(Ptr<Data>, Vector &ans) const;
     double last_loglike() const;
 
+    // The observed data log likelihood at the current parameters,
+    // with the latent class memberships integrated out.
+    double log_likelihood() const override;
+
+    // The complete data log likelihood log p(y, z | theta), evaluated
+    // at the latent class assignments from the most recent call to
+    // impute_latent_data().  When likelihood_power() is less than 1,
+    // impute_latent_data() tempers this quantity: the class
+    // membership probabilities are raised to likelihood_power(), and
+    // each observation is added to its mixture component and to the
+    // mixing distribution with that weight.  This requires mixture
+    // components that are EmMixtureComponents.
+    double tempered_log_likelihood() const override;
+
     double pdf(dPtr dp, bool logscale) const;
     uint number_of_mixture_components() const;
 
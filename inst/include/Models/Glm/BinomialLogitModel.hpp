@@ -49,6 +49,12 @@ namespace BOOM{
     BinomialLogitModel(const BinomialLogitModel &);
     BinomialLogitModel *clone() const override;
 
+    // Adding or removing data invalidates the packed design matrix
+    // used by log_likelihood().
+    void add_data(Ptr<Data> dp) override;
+    void add_data(Ptr<BinomialRegressionData> dp) override;
+    void clear_data() override;
+
     GlmCoefs & coef() override{return ParamPolicy::prm_ref();}
     const GlmCoefs & coef() const override{return ParamPolicy::prm_ref();}
     Ptr<GlmCoefs> coef_prm() override{return ParamPolicy::prm();}
@@ -69,7 +75,12 @@ namespace BOOM{
     virtual double logp_1(bool y, const Vector &x, bool logscale) const;
 
     // In the following, beta refers to the set of nonzero "included"
-    // coefficients.
+    // coefficients.  The predictors are packed into a single design
+    // matrix the first time the log likelihood is evaluated after data
+    // are added or removed, so the derivatives are computed with
+    // matrix products rather than one outer product per observation.
+    // The success and trial counts are read from the data on each
+    // call, so data augmentation samplers can modify them in place.
     double Loglike(const Vector &beta,
                    Vector &g, Matrix &h, uint nd) const override;
     virtual double log_likelihood(const Vector &beta, Vector *g, Matrix *h,
@@ -84,7 +95,13 @@ namespace BOOM{
     double log_alpha() const;
 
    private:
+    // Copy the predictors from dat() into design_.
+    void refresh_packed_design() const;
+
     double log_alpha_;  // see comments in logistic_regression_model
+
+    mutable Matrix design_;
+    mutable bool packed_design_current_;
   };
 
 }  // namespace BOOM
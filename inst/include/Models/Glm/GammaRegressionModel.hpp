@@ -82,12 +82,30 @@ namespace BOOM {
     GammaRegressionModel(Ptr<UnivParams> alpha, Ptr<GlmCoefs> coefficients);
     GammaRegressionModel * clone() const override;
 
+    // Adding or removing data invalidates the packed design matrix
+    // used by Loglike().
+    void add_data(Ptr<Data> dp) override;
+    void add_data(Ptr<RegressionData> dp) override;
+    void clear_data() override;
+
     // Returns log likelihood and its derivatives as a function of the
-    // concatenated vector [shape_parameter(), coef()].
+    // concatenated vector [shape_parameter(), coef()].  The
+    // derivatives are computed from a packed design matrix, built the
+    // first time this function is called after data are added or
+    // removed.  Other calls do not modify the model, so they may run
+    // concurrently once the design matrix is current.
     double Loglike(const Vector &alpha_beta,
                    Vector &gradient,
                    Matrix &Hessian,
                    uint nderiv) const override;
+
+   private:
+    // Copy the predictors from dat() into design_.
+    void refresh_packed_data() const;
+
+    mutable Matrix design_;
+    mutable Vector counts_;
+    mutable bool packed_data_current_;
   };
 
   //======================================================================
@@ -142,7 +160,20 @@ namespace BOOM {
     // called first.
     void set_dimensions(int number_of_rows, int xdim);
 
+    // The sufficient statistics in contiguous storage.  Row i of
+    // design() is the i'th covariate pattern in map() order, and
+    // element i of counts(), sums(), and sumlogs() are the n(),
+    // sum(), and sumlog() from its GammaSuf.  The packed copy is
+    // rebuilt on demand after the sufficient statistics change.
+    const Matrix &design() const;
+    const Vector &counts() const;
+    const Vector &sums() const;
+    const Vector &sumlogs() const;
+
    private:
+    // Fill the packed copy of the sufficient statistics, if needed.
+    void pack() const;
+
     // If predictors exists in the sufficient statistics map, then
     // return the GammaSuf that it is associated with.  Otherwise,
     // allocate a new, empty GammaSuf, associate it with predictors,
@@ -158,6 +189,12 @@ namespace BOOM {
 
     // Number of distinct covariate (x) patterns.
     int nrow_;
+
+    mutable Matrix design_;
+    mutable Vector counts_;
+    mutable Vector sums_;
+    mutable Vector sumlogs_;
+    mutable bool packed_current_;
   };
 
   // A GammaRegressionModel where the data are stored using
@@ -0,0 +1,60 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_GLM_DERIVATIVE_KERNELS_HPP_
+#define BOOM_GLM_DERIVATIVE_KERNELS_HPP_
+
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/SpdMatrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <LinAlg/Selector.hpp>
+
+namespace BOOM {
+
+  // Kernels for the derivatives of log likelihoods that depend on the
+  // coefficients only through linear predictors eta = X * beta, where
+  // X is a packed design matrix with one row per observation.  If
+  // log likelihood = sum_i f_i(eta_i) then
+  //
+  //   d / dbeta = X^T f'(eta)
+  //   d^2 / dbeta dbeta^T = X^T diag(f''(eta)) X.
+  //
+  // If there are two linear predictors eta = X1 * beta1 and zeta = X2
+  // * beta2 (e.g. in zero-inflated models), the mixed partial
+  // derivative is X1^T diag(d^2 f / deta dzeta) X2.  The functions
+  // here evaluate these with level 3 BLAS on cache-sized blocks of
+  // rows, instead of adding one outer product per observation.
+
+  // Returns X if all variables are included in 'inc'.  Otherwise
+  // fills 'workspace' with the included columns of X and returns it.
+  const Matrix &included_columns(const Matrix &X,
+                                 const Selector &inc,
+                                 Matrix &workspace);
+
+  // Returns X^T * diag(weights) * X.  The weights can have any sign.
+  SpdMatrix weighted_inner_product(const Matrix &X, const Vector &weights);
+
+  // Returns X^T * diag(weights) * Y.  X and Y must have the same
+  // number of rows.
+  Matrix weighted_cross_product(const Matrix &X,
+                                const Vector &weights,
+                                const Matrix &Y);
+
+}  // namespace BOOM
+
+#endif  // BOOM_GLM_DERIVATIVE_KERNELS_HPP_
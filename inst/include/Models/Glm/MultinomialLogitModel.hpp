@@ -78,6 +78,12 @@ namespace BOOM{
     MultinomialLogitModel(const MultinomialLogitModel &rhs);
     MultinomialLogitModel * clone()const override;
 
+    // Adding or removing data invalidates the packed design matrices
+    // used by fill_eta_matrix() and log_likelihood().
+    void add_data(Ptr<Data>) override;
+    void add_data(Ptr<ChoiceData>) override;
+    void clear_data() override;
+
     // coefficient vector: elements corresponding to choice level 0
     // (which are constrained to 0 for identifiability) are omitted.
     // Thus beta() is of dimension ((num_choices-1)*psub + pch)
@@ -173,6 +179,24 @@ namespace BOOM{
                      const Vector &full_beta)const;
     Vector &fill_eta(const ChoiceData &, Vector &ans)const;
 
+    // Fill in the linear predictor for every observation in the data
+    // set.
+    // Args:
+    //   beta: The vector of coefficients, either of dimension
+    //     beta_size(false) or containing only the included
+    //     coefficients.
+    //   eta: On output eta(i, m) is the linear predictor for choice
+    //     level m of observation i, so eta is resized to
+    //     sample_size() x Nchoices().  Column 0 is the baseline
+    //     choice.
+    //
+    // The subject and choice predictors for the whole data set are
+    // packed into contiguous matrices the first time this function is
+    // called after the data change.  The subject contribution is then
+    // a single matrix-matrix product, and the choice contribution a
+    // single matrix-vector product.
+    void fill_eta_matrix(const Vector &beta, Matrix &eta)const;
+
     //----------------------------------------------------------------------
     virtual double pdf(Ptr<Data> dp, bool logscale)const;
     double pdf(const Data * dp, bool logscale)const override;
@@ -214,6 +238,25 @@ namespace BOOM{
     void fill_extended_beta()const;
     void index_out_of_bounds(uint m)const;
 
+    // Pack the predictors from dat() into subject_design_ and
+    // choice_design_.
+    void refresh_packed_design()const;
+
+    // The log likelihood and (if nd > 0) its gradient, computed from
+    // the packed design matrices.  Only handles nd <= 1.
+    double packed_log_likelihood(const Vector &beta,
+                                 Vector &gradient,
+                                 int nd)const;
+
+    // Row i of subject_design_ is Xsubject() for observation i.
+    // Row (m * sample_size() + i) of choice_design_ is Xchoice(m) for
+    // observation i, so choice_design_ * beta_choice() is the
+    // column-major layout of the choice contribution to the
+    // sample_size() x Nchoices() matrix of linear predictors.
+    mutable Matrix subject_design_;
+    mutable Matrix choice_design_;
+    mutable bool packed_design_current_;
+
     mutable Vector wsp_;
     uint nch_;  // number of choices
     uint psub_; // number of subject X variables
@@ -23,6 +23,7 @@
 #include <Models/PosteriorSamplers/Imputer.hpp>
 
 #include <Models/Glm/BinomialLogitModel.hpp>
+#include <Models/Glm/WeightedCrossProductBuffer.hpp>
 #include <Models/Glm/PosteriorSamplers/BinomialLogitDataImputer.hpp>
 #include <Models/MvnBase.hpp>
 #include <cpputil/RefCounted.hpp>
@@ -47,6 +48,10 @@ namespace BOOM {
       void combine(const SufficientStatistics &rhs);
 
       void update(const Vector &x, double weighted_value, double weight);
+
+      // Add the observations staged in buffer.  The staged responses
+      // are weighted_value / weight.  The buffer is not cleared.
+      void update(const WeightedCrossProductBuffer &buffer);
       const SpdMatrix &xtx() const;
       const Vector &xty() const;
       int sample_size() const {return sample_size_;}
@@ -94,13 +99,35 @@ namespace BOOM {
                    RNG *rng = nullptr,
                    RNG &seeding_rng = GlobalRng::rng);
 
+      // Observations are staged in blocks.  When a block fills, the
+      // latent data for the whole block are imputed with a single
+      // call to BinomialLogitDataImputer::impute_batch(), and the
+      // imputed values are added to suf through buffer_.  The last
+      // partial block is handled by finalize_latent_data().
       void impute_latent_data_point(const BinomialRegressionData &data,
                                     SufficientStatistics *suf,
                                     RNG &rng) override;
+      void finalize_latent_data(SufficientStatistics *suf) override;
 
      private:
+      // Impute the latent data for the staged observations, add them
+      // to suf, and empty the block.
+      void impute_block(SufficientStatistics *suf, RNG &rng);
+
       BinomialLogitCltDataImputer binomial_data_imputer_;
       const GlmCoefs *coefficients_;
+      WeightedCrossProductBuffer buffer_;
+
+      // The observations staged for the next call to impute_block().
+      // Only the first block_size_ elements are in use.
+      std::vector<const Vector *> block_predictors_;
+      Vector block_trials_;
+      Vector block_successes_;
+      Vector block_log_odds_;
+      Vector block_weighted_sums_;
+      Vector block_weights_;
+      int block_size_;
+      RNG *block_rng_;
     };
   }  // namespace BinomialLogit
 
@@ -18,6 +18,7 @@
 
 #ifndef BOOM_BINOMIAL_LOGIT_COMPOSITE_SPIKE_SLAB_SAMPLER_HPP_
 #define BOOM_BINOMIAL_LOGIT_COMPOSITE_SPIKE_SLAB_SAMPLER_HPP_
+#include <vector>
 #include <Models/Glm/PosteriorSamplers/BinomialLogitSpikeSlabSampler.hpp>
 #include <Models/MvnBase.hpp>
 #include <Samplers/MoveAccounting.hpp>
@@ -34,19 +35,55 @@ namespace BOOM{
                               int chunk_number)
         : m_(model),
           pri_(prior),
-          start_(chunk_size * chunk_number)
+          start_(chunk_size * chunk_number),
+          use_linear_predictor_(false)
     {
       int nvars = m_->coef().nvars();
       int elements_remaining = nvars - start_;
       chunk_size_ = std::min(chunk_size, elements_remaining);
     }
+
+    // As above, but the log likelihood is evaluated by adjusting a
+    // cached linear predictor for the change in the chunk, which
+    // costs O(nobs * chunk_size) instead of O(nobs * nvars).
+    // Args:
+    //   linear_predictor: Element i is x[i] * beta for observation i,
+    //     evaluated at the model's current coefficients.
+    BinomialLogitLogPostChunk(const BinomialLogitModel *model,
+                              const MvnBase *prior,
+                              int chunk_size,
+                              int chunk_number,
+                              const Vector &linear_predictor);
+
     double operator()(const Vector &beta_chunk)const;
     double operator()(const Vector &beta_chunk, Vector &grad, Matrix &hess, int nd)const;
+
+    // Fill eta with the linear predictor for each observation when
+    // the chunk is set to beta_chunk and the remaining coefficients
+    // are held at their current values.  Only available if the
+    // functor was built from a linear predictor.
+    void fill_linear_predictor(const ConstVectorView &beta_chunk,
+                               Vector &eta) const;
+
    private:
+    // The log likelihood, computed from linear_predictor_offset_.
+    double cached_log_likelihood(const Vector &beta_chunk,
+                                 Vector &grad,
+                                 Matrix &hess,
+                                 int nd) const;
+
     const BinomialLogitModel *m_;
     const MvnBase * pri_;
     int start_;
     int chunk_size_;
+
+    bool use_linear_predictor_;
+    // The positions of the chunk's coefficients in the full vector of
+    // predictors.
+    std::vector<int> chunk_positions_;
+    // The linear predictor with the contribution of the chunk
+    // removed.
+    Vector linear_predictor_offset_;
   };
 
   //======================================================================
@@ -103,6 +140,20 @@ namespace BOOM{
     MoveAccounting move_accounting_;
     Vector sampler_weights_;
 
+    // Element i is x[i] * beta for observation i.  It is valid when
+    // linear_predictor_coefficients_ matches the model's coefficients
+    // and the sample size matches the model's.  Chunk moves update it
+    // in place when they are accepted.
+    Vector linear_predictor_;
+    Vector linear_predictor_coefficients_;
+
+    // Recompute linear_predictor_ from scratch.
+    void refresh_linear_predictor();
+
+    // Recompute linear_predictor_ if the model's coefficients or data
+    // have changed since it was last computed.
+    void ensure_linear_predictor_is_current();
+
     // Compute the size of the largest chunk
     int compute_chunk_size(int max_chunk_size)const;
     int compute_number_of_chunks(int max_chunk_size)const;
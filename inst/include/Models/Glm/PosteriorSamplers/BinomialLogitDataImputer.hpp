@@ -19,6 +19,8 @@
 #ifndef BOOM_BINOMIAL_LOGIT_DATA_IMPUTER_HPP_
 #define BOOM_BINOMIAL_LOGIT_DATA_IMPUTER_HPP_
 
+#include <vector>
+#include <LinAlg/VectorView.hpp>
 #include <Models/Glm/PosteriorSamplers/NormalMixtureApproximation.hpp>
 
 namespace BOOM {
@@ -48,6 +50,34 @@ namespace BOOM {
         double number_of_successes,
         double log_odds) const = 0;
 
+    // Impute the latent data for a batch of observations.  The
+    // observations are imputed in order, so the random numbers are
+    // consumed in the same sequence as a sequence of calls to
+    // impute().  Observations whose trials are imputed individually
+    // are handled by a kernel that evaluates the mixture component
+    // probabilities from a precomputed table, without a virtual call
+    // per observation.
+    //
+    // Args:
+    //   rng:  The random number generator.
+    //   number_of_trials: The number of trials in each observation.
+    //   number_of_successes: The number of successes in each
+    //     observation.
+    //   log_odds:  The log odds of success for each observation.
+    //   information_weighted_sum: On output, element i contains the
+    //     first element of the pair returned by impute() for
+    //     observation i.
+    //   information: On output, element i contains the second element
+    //     of the pair returned by impute() for observation i.
+    //
+    // All arguments must have the same size.
+    void impute_batch(RNG &rng,
+                      const ConstVectorView &number_of_trials,
+                      const ConstVectorView &number_of_successes,
+                      const ConstVectorView &log_odds,
+                      VectorView information_weighted_sum,
+                      VectorView information) const;
+
     // A finite mixture approximation to the logistic distribution.
     static const NormalMixtureApproximation mixture_approximation;
 
@@ -58,12 +88,33 @@ namespace BOOM {
     // clt_threshold ("clt = central limit theorem").
     virtual int clt_threshold() const = 0;
 
+    // Returns true if an observation with the given number of trials
+    // has a latent logit imputed for each trial, and false if the
+    // imputation uses a large sample approximation.
+    virtual bool imputes_individual_trials(double number_of_trials) const = 0;
+
    protected:
     // Adds a human readable message to 'err'.
     void debug_status_message(ostream &err,
                               double number_of_trials,
                               double number_of_successes,
                               double eta) const;
+
+    // Impute a latent logit and a mixture component for each trial in
+    // a single observation.  The return value has the same meaning as
+    // impute().
+    //
+    // Args:
+    //   rng, number_of_trials, number_of_successes, log_odds:  As in
+    //     impute().
+    //   workspace: Storage for the mixture component probabilities.
+    //     It is resized if needed, so it can be reused across calls.
+    std::pair<double, double> impute_individual_trials(
+        RNG &rng,
+        double number_of_trials,
+        double number_of_successes,
+        double log_odds,
+        std::vector<double> &workspace) const;
   };
 
   //=======================================================================
@@ -130,6 +181,10 @@ namespace BOOM {
     // takes place.
     int clt_threshold() const override;
 
+    bool imputes_individual_trials(double number_of_trials) const override {
+      return number_of_trials < clt_threshold_;
+    }
+
    private:
     int clt_threshold_;
   };
@@ -185,16 +240,16 @@ namespace BOOM {
     // The smallest number_of_trials for which approximate
     // augmentation takes place.
     int clt_threshold()const override;
+
+    bool imputes_individual_trials(double number_of_trials) const override {
+      return number_of_trials <= clt_threshold_;
+    }
+
    private:
     int clt_threshold_;
 
-    // Specific cases used to implement the public impute() method.
-    std::pair<double, double> impute_small_sample(
-        RNG &rng,
-        double number_of_trials,
-        double number_of_successes,
-        double eta) const;
-
+    // The large sample case used to implement the public impute()
+    // method.  The small sample case is impute_individual_trials().
     std::pair<double, double> impute_large_sample(
         RNG &rng,
         double number_of_trials,
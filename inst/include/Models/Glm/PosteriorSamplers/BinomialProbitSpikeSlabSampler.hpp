@@ -25,13 +25,58 @@
 #include <Models/Glm/VariableSelectionPrior.hpp>
 #include <Models/Glm/WeightedRegressionModel.hpp>
 #include <Models/MvnBase.hpp>
+#include <Models/PosteriorSamplers/Imputer.hpp>
 #include <Models/PosteriorSamplers/PosteriorSampler.hpp>
 #include <distributions/rng.hpp>
 
 namespace BOOM {
 
+  namespace BinomialProbit {
+    // A worker that imputes the sums of the latent Gaussian data for
+    // a subset of the observations in a binomial probit model, and
+    // accumulates their contribution to X'z.
+    class ImputeWorker : public LatentDataImputerWorker {
+     public:
+      typedef std::vector<Ptr<BinomialRegressionData>>::const_iterator
+      Iterator;
+
+      // Args:
+      //   global_xtz: The complete data sufficient statistic X'z held
+      //     by the sampler.
+      //   global_xtz_mutex:  A mutex protecting global_xtz.
+      //   clt_threshold:  Passed to the BinomialProbitDataImputer.
+      //   coefficients: The coefficients of the model being sampled.
+      //   rng:  A random number generator, or nullptr.
+      //   seeding_rng: If rng is nullptr, a new RNG is created and
+      //     seeded from this one.
+      ImputeWorker(Vector &global_xtz,
+                   std::mutex &global_xtz_mutex,
+                   int clt_threshold,
+                   const GlmCoefs *coefficients,
+                   RNG *rng = nullptr,
+                   RNG &seeding_rng = GlobalRng::rng);
+
+      // Assign this worker the observations in [begin, end).
+      void set_data(Iterator begin, Iterator end);
+
+      void impute_latent_data() override;
+      void combine_complete_data() override;
+
+     private:
+      Vector &global_xtz_;
+      BinomialProbitDataImputer imputer_;
+      const GlmCoefs *coefficients_;
+      Iterator begin_;
+      Iterator end_;
+      Vector xtz_;
+      RNG *rng_;
+      std::unique_ptr<RNG> rng_storage_;
+    };
+  }  // namespace BinomialProbit
+
   class BinomialProbitSpikeSlabSampler
-      : public PosteriorSampler {
+      : public PosteriorSampler,
+        public LatentDataSampler<BinomialProbit::ImputeWorker> {
    public:
     BinomialProbitSpikeSlabSampler(BinomialProbitModel *model,
                                    Ptr<MvnBase> slab_prior,
@@ -52,17 +97,24 @@ namespace BOOM {
     // inclusion indicators will be sampled.
     void limit_model_selection(int max_flips);
 
-    void impute_latent_data();
+    // Impute the latent data using the workers.  Use
+    // set_number_of_workers() to run the workers in parallel.
+    void impute_latent_data() override;
 
     void refresh_xtx();
     WeightedRegSuf complete_data_sufficient_statistics() const;
 
+    // Overrides for LatentDataSampler.
+    Ptr<BinomialProbit::ImputeWorker> create_worker(std::mutex &m) override;
+    void assign_data_to_workers() override;
+    void clear_latent_data() override;
+
    private:
     BinomialProbitModel *model_;
     Ptr<MvnBase> slab_prior_;
     Ptr<VariableSelectionPrior> spike_prior_;
     SpikeSlabSampler spike_slab_;
-    BinomialProbitDataImputer imputer_;
+    int clt_threshold_;
 
     SpdMatrix xtx_;
     Vector xtz_;
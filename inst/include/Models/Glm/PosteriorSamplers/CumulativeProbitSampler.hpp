@@ -21,24 +21,64 @@
 
 #include <Models/Glm/CumulativeProbitModel.hpp>
 #include <Models/Glm/RegressionModel.hpp>
+#include <Models/PosteriorSamplers/Imputer.hpp>
 #include <Models/PosteriorSamplers/PosteriorSampler.hpp>
 #include <Models/MvnBase.hpp>
 
 namespace BOOM{
 
+  namespace CumulativeProbit {
+    // A worker that imputes the latent Gaussian data for a subset of
+    // the observations in a cumulative probit model.
+    class ImputeWorker
+        : public SufstatImputeWorker<OrdinalRegressionData, NeRegSuf> {
+     public:
+      // Args:
+      //   global_suf: The complete data sufficient statistics held by
+      //     the sampler.
+      //   global_suf_mutex:  A mutex protecting global_suf.
+      //   model: The model whose data are being imputed.
+      //   rng:  A random number generator, or nullptr.
+      //   seeding_rng: If rng is nullptr, a new RNG is created and
+      //     seeded from this one.
+      ImputeWorker(NeRegSuf &global_suf,
+                   std::mutex &global_suf_mutex,
+                   const CumulativeProbitModel *model,
+                   RNG *rng = nullptr,
+                   RNG &seeding_rng = GlobalRng::rng);
+
+      void impute_latent_data_point(const OrdinalRegressionData &data,
+                                    NeRegSuf *suf,
+                                    RNG &rng) override;
+
+     private:
+      const CumulativeProbitModel *model_;
+    };
+  }  // namespace CumulativeProbit
+
   class CumulativeProbitSampler
-      : public PosteriorSampler
+      : public PosteriorSampler,
+        public LatentDataSampler<CumulativeProbit::ImputeWorker>
   {
    public:
     CumulativeProbitSampler(CumulativeProbitModel *m,
                             Ptr<MvnBase> beta_prior,
                             RNG &seeding_rng = GlobalRng::rng);
 
-    void impute_latent_data();
+    // Impute the latent data using the workers.  Use
+    // set_number_of_workers() to run the workers in parallel.
+    void impute_latent_data() override;
     void draw_beta();
     void draw_delta();
     void draw() override;
     double logpri() const override;
+
+    // Overrides for LatentDataSampler.
+    Ptr<CumulativeProbit::ImputeWorker> create_worker(
+        std::mutex &m) override;
+    void assign_data_to_workers() override;
+    void clear_latent_data() override;
+
    private:
     CumulativeProbitModel *m_;
     Ptr<MvnBase> beta_prior_;
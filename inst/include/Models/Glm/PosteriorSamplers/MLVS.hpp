@@ -77,6 +77,11 @@ namespace BOOM {
     Ptr<MlvsDataImputer> create_worker(std::mutex &m) override;
     void assign_data_to_workers() override;
 
+    // The complete data sufficient statistics include a cross product
+    // matrix of dimension beta_size(), which is expensive to combine,
+    // so the workers' statistics are summed by tree reduction.
+    void impute_latent_data() override;
+
     // Part of the implementation for draw().
     void draw_beta();
 
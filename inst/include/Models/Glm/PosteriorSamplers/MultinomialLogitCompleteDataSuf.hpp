@@ -46,6 +46,9 @@ namespace BOOM {
       mutable bool sym_;
       double weighted_sum_of_squares_;
 
+      // Workspace for update().
+      Vector choice_xtwu_;
+
       friend void intrusive_ptr_add_ref(CompleteDataSufficientStatistics *w) {
         w->up_count(); }
       friend void intrusive_ptr_release(CompleteDataSufficientStatistics *w) {
@@ -93,6 +93,13 @@ namespace BOOM {
     int compute_number_of_chunks() const;
 
    private:
+    // Recompute linear_predictor_ from scratch.
+    void refresh_linear_predictor();
+
+    // Recompute linear_predictor_ if the model's coefficients or data
+    // have changed since it was last computed.
+    void ensure_linear_predictor_is_current();
+
     MultinomialLogitModel *model_;
     Ptr<MvnBase> prior_;
     Ptr<VariableSelectionPrior> inclusion_prior_;
@@ -101,6 +108,15 @@ namespace BOOM {
     double tdf_;
     double rwm_variance_scale_factor_;
     Vector move_probs_;
+
+    // Row i is the linear predictor for observation i, with one
+    // column per choice level.  It is valid when
+    // linear_predictor_coefficients_ matches the model's coefficients
+    // and the number of rows matches the sample size.  Accepted chunk
+    // moves update it in place, so a sweep through the chunks does
+    // not recompute X * beta for each chunk.
+    Matrix linear_predictor_;
+    Vector linear_predictor_coefficients_;
   };
 
 }  // namespace BOOM
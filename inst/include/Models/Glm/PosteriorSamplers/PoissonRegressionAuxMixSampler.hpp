@@ -48,14 +48,22 @@ namespace BOOM{
         RNG *rng = nullptr,
         RNG &seeding_rng = GlobalRng::rng);
 
+    // Imputed observations are staged in a buffer, which is added to
+    // complete_data_suf when it fills, and by finalize_latent_data().
     void impute_latent_data_point(
         const PoissonRegressionData &data_point,
         WeightedRegSuf *complete_data_suf,
         RNG &rng) override;
+    void finalize_latent_data(WeightedRegSuf *complete_data_suf) override;
 
    private:
+    // Stage an observation, flushing the buffer if it is full.
+    void add_to_buffer(const Vector &x, double y, double weight,
+                       WeightedRegSuf *complete_data_suf);
+
     const GlmCoefs *coefficients_;
     std::unique_ptr<PoissonDataImputer> imputer_;
+    WeightedCrossProductBuffer buffer_;
   };
 
   //----------------------------------------------------------------------
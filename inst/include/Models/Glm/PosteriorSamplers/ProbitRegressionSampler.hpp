@@ -21,11 +21,63 @@
 
 #include <Models/Glm/ProbitRegression.hpp>
 #include <Models/MvnBase.hpp>
+#include <Models/PosteriorSamplers/Imputer.hpp>
 #include <Models/PosteriorSamplers/PosteriorSampler.hpp>
 
 namespace BOOM{
+
+  namespace ProbitRegression {
+    // A worker that imputes the latent Gaussian data for a contiguous
+    // block of rows in the design matrix held by a
+    // ProbitRegressionSampler, and accumulates the block's
+    // contribution to X'z.
+    class ImputeWorker : public LatentDataImputerWorker {
+     public:
+      // Args:
+      //   design: The design matrix owned by the sampler.  Row i is
+      //     the predictor vector for observation i in 'model'.
+      //   model: The model whose data and coefficients are used.
+      //   global_xtz: The complete data sufficient statistic X'z held
+      //     by the sampler.
+      //   global_xtz_mutex:  A mutex protecting global_xtz.
+      //   rng:  A random number generator, or nullptr.
+      //   seeding_rng: If rng is nullptr, a new RNG is created and
+      //     seeded from this one.
+      ImputeWorker(const Matrix &design,
+                   const ProbitRegressionModel *model,
+                   Vector &global_xtz,
+                   std::mutex &global_xtz_mutex,
+                   RNG *rng = nullptr,
+                   RNG &seeding_rng = GlobalRng::rng);
+
+      // Assign this worker the rows begin, ..., end - 1.
+      void set_rows(int begin, int end);
+
+      void impute_latent_data() override;
+      void combine_complete_data() override;
+
+     private:
+      const Matrix &design_;
+      const ProbitRegressionModel *model_;
+      Vector &global_xtz_;
+      int begin_;
+      int end_;
+
+      // Workspace for the linear predictor, the responses and the
+      // latent data in this worker's block, and the block's X'z.
+      Vector eta_;
+      std::vector<bool> responses_;
+      Vector z_;
+      Vector xtz_;
+
+      RNG *rng_;
+      std::unique_ptr<RNG> rng_storage_;
+    };
+  }  // namespace ProbitRegression
+
   class ProbitRegressionSampler
-      : public PosteriorSampler
+      : public PosteriorSampler,
+        public LatentDataSampler<ProbitRegression::ImputeWorker>
   {
    public:
     ProbitRegressionSampler(ProbitRegressionModel *model,
@@ -35,12 +87,24 @@ namespace BOOM{
     double logpri()const override;
 
     // call refresh_xtx when the model has gained or lost data.
-    // Otherwise, it is assumed that xtx_ is fixed between iterations
+    // Otherwise, it is assumed that xtx_ is fixed between iterations.
+    // This also refreshes the stored copy of the design matrix, which
+    // lets the workers compute X * beta and X'z for their blocks with
+    // matrix-vector products.
     void refresh_xtx();
 
-    void impute_latent_data();
+    // Impute the latent data using the workers.  Use
+    // set_number_of_workers() to run the workers in parallel.
+    void impute_latent_data() override;
     const Vector & xtz()const;
     const SpdMatrix & xtx()const;
+
+    // Overrides for LatentDataSampler.
+    Ptr<ProbitRegression::ImputeWorker> create_worker(
+        std::mutex &m) override;
+    void assign_data_to_workers() override;
+    void clear_latent_data() override;
+
    protected:
     virtual void draw_beta();
    private:
@@ -49,6 +113,9 @@ namespace BOOM{
     SpdMatrix xtx_;
     Vector xtz_;
     Vector beta_;
+
+    // Row i is the predictor vector for observation i.
+    Matrix design_;
   };
 }
 
@@ -70,19 +70,25 @@ namespace BOOM {
         : SufstatImputeWorker<RegressionData, WeightedRegSuf>(
               global_suf, global_suf_mutex, rng, seeding_rng),
           coefficients_(coefficients),
-          quantile_complement_(1 - quantile)
+          quantile_complement_(1 - quantile),
+          buffer_(coefficients->nvars_possible())
     {}
 
     double adjusted_observation(double y, double lambda) const {
       return y -  (2 * quantile_complement_ - 1) * lambda;
     }
 
+    // Imputed observations are staged in a buffer, which is added to
+    // suf when it fills, and by finalize_latent_data().
     void impute_latent_data_point(const RegressionData &data_point,
                                   WeightedRegSuf *suf,
                                   RNG &rng) override;
+    void finalize_latent_data(WeightedRegSuf *suf) override;
+
    private:
     const GlmCoefs *coefficients_;
     double quantile_complement_;
+    WeightedCrossProductBuffer buffer_;
   };
 
   //======================================================================
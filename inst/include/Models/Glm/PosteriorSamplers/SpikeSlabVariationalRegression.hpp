@@ -0,0 +1,200 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_SPIKE_SLAB_VARIATIONAL_REGRESSION_HPP_
+#define BOOM_SPIKE_SLAB_VARIATIONAL_REGRESSION_HPP_
+
+#include <Models/Glm/RegressionModel.hpp>
+#include <Models/Glm/VariableSelectionPrior.hpp>
+#include <Models/MvnGivenScalarSigma.hpp>
+#include <Models/GammaModel.hpp>
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/SpdMatrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <distributions/rng.hpp>
+
+namespace BOOM {
+
+  // A mean-field variational approximation to the spike and slab
+  // posterior that BregVsSampler draws from by MCMC.  The prior is
+  //
+  //     beta_j | gamma_j = 1, sigma ~ N(b_j, sigma^2 / omega_j)
+  //     beta_j | gamma_j = 0        = 0
+  //                       gamma_j ~ Bernoulli(pi_j)
+  //                     1/sigma^2 ~ Gamma(df/2, ss/2)
+  //
+  // where b is the mean of the slab, omega is the diagonal of its
+  // (unscaled) precision matrix, and pi are the prior inclusion
+  // probabilities from the spike.  The approximating family is
+  //
+  //    q(beta, gamma, sigma) = q(1/sigma^2) * prod_j q(beta_j, gamma_j)
+  //
+  // with q(1/sigma^2) a Gamma distribution and q(beta_j, gamma_j) a
+  // point mass at zero with probability 1 - alpha_j and
+  // N(mu_j, s2_j) with probability alpha_j.  The approximation is fit
+  // by coordinate ascent on the evidence lower bound (ELBO), using
+  // only the sufficient statistics (XTX, XTy, yTy, n) of the model,
+  // so each sweep costs O(p^2) regardless of the sample size.
+  //
+  // Only the diagonal of the slab precision is used.  If the slab has
+  // a full precision matrix (e.g. a Zellner prior) the approximation
+  // replaces it with independent normals having the same marginal
+  // precisions.  Coefficients with omega_j == 0 (a flat slab) must
+  // have prior inclusion probability 1.
+  //
+  // Coordinate ascent finds a local optimum that can depend on the
+  // starting values, particularly when predictors are correlated.
+  // fit() starts from the current variational parameters, so it can
+  // be warm started from a previous fit or from the model's current
+  // coefficients.  fit_with_restarts() runs several fits from random
+  // starting values in parallel and keeps the best one.
+  class SpikeSlabVariationalRegression {
+   public:
+    // Args:
+    //   model: The regression model supplying the sufficient
+    //     statistics.  The variational parameters are initialized
+    //     from the model's current coefficients and residual variance.
+    //   slab: The conditional prior on the included coefficients,
+    //     given sigma^2.
+    //   residual_precision_prior: Prior on 1/sigma^2.
+    //   spike: Prior on which coefficients are included.
+    SpikeSlabVariationalRegression(
+        RegressionModel *model,
+        const Ptr<MvnGivenScalarSigmaBase> &slab,
+        const Ptr<GammaModelBase> &residual_precision_prior,
+        const Ptr<VariableSelectionPrior> &spike);
+
+    // Run coordinate ascent from the current variational parameters
+    // until the ELBO changes by less than 'tolerance' and no inclusion
+    // probability changes by more than 'tolerance' in a full sweep, or
+    // until 'max_iterations' sweeps have been made.
+    //
+    // Returns the final value of the ELBO.
+    double fit(int max_iterations = 1000, double tolerance = 1e-6);
+
+    // Run 'number_of_restarts' independent fits, each from random
+    // inclusion probabilities, using 'number_of_threads' threads.  The
+    // current variational parameters are used as one additional
+    // starting point.  The fit with the largest ELBO is kept.
+    //
+    // Returns the ELBO of the fit that was kept.
+    double fit_with_restarts(int number_of_restarts,
+                             int number_of_threads,
+                             RNG &rng = GlobalRng::rng,
+                             int max_iterations = 1000,
+                             double tolerance = 1e-6);
+
+    // Warm start the next call to fit().
+    // Args:
+    //   inclusion_probabilities: Starting values for alpha.  Entries
+    //     with prior inclusion probability 0 or 1 are overridden.
+    //   coefficient_means: Starting values for mu.
+    void set_initial_values(const Vector &inclusion_probabilities,
+                            const Vector &coefficient_means);
+
+    // Set the starting values from the current state of the model:
+    // alpha_j is the prior inclusion probability, mu is the model's
+    // coefficient vector, and E(1/sigma^2) is 1 / model->sigsq().
+    void initialize_from_model();
+
+    // Marginal posterior inclusion probabilities, alpha.
+    const Vector &inclusion_probabilities() const { return state_.alpha; }
+
+    // Means and variances of the coefficients given that they are
+    // included.
+    const Vector &coefficient_means() const { return state_.mu; }
+    const Vector &coefficient_variances() const { return state_.s2; }
+
+    // Unconditional posterior means of the coefficients: alpha * mu.
+    Vector posterior_mean() const;
+
+    // Parameters of the Gamma distribution q(1/sigma^2).
+    double residual_precision_shape() const { return state_.shape; }
+    double residual_precision_rate() const { return state_.rate; }
+
+    double elbo() const { return state_.elbo; }
+    int number_of_iterations() const { return state_.iterations; }
+
+    // Draws from the variational approximation in the format produced
+    // by MCMC: each row of the returned matrix is a full-length
+    // coefficient vector, with zeros in the excluded positions.
+    Matrix simulate_coefficients(int ndraws, RNG &rng = GlobalRng::rng) const;
+
+    // Draws of the residual standard deviation sigma from q.
+    Vector simulate_residual_sd(int ndraws, RNG &rng = GlobalRng::rng) const;
+
+    // Set the model to the median probability model (coefficients
+    // with alpha_j >= .5 are included) with coefficients set to their
+    // conditional means, and sigsq set to 1 / E(1/sigma^2).
+    void set_model_parameters();
+
+   private:
+    // The variational parameters, along with the quantities tracking
+    // the progress of the fit.
+    struct State {
+      Vector alpha;
+      Vector mu;
+      Vector s2;
+      double shape;
+      double rate;
+      double elbo;
+      int iterations;
+    };
+
+    // Copy the sufficient statistics and prior parameters into the
+    // members below.  Called at the start of each fit, so that changes
+    // to the data or the priors are picked up.
+    void refresh_inputs();
+
+    // Force the inclusion probabilities of variables that are
+    // certainly in or out of the model.
+    void clamp_inclusion_probabilities(Vector &alpha) const;
+
+    // Run coordinate ascent on 'state'.  Reads only the inputs set by
+    // refresh_inputs(), so independent states can be fit in parallel.
+    void run(State &state, int max_iterations, double tolerance) const;
+
+    // The expected residual sum of squares under q, given r = alpha *
+    // mu and xtx_r = XTX * r.
+    double expected_rss(const State &state, const Vector &r,
+                        const Vector &xtx_r) const;
+
+    double compute_elbo(const State &state, double expected_rss) const;
+
+    RegressionModel *model_;
+    Ptr<MvnGivenScalarSigmaBase> slab_;
+    Ptr<GammaModelBase> residual_precision_prior_;
+    Ptr<VariableSelectionPrior> spike_;
+
+    State state_;
+
+    // Inputs to the fit.
+    SpdMatrix xtx_;
+    Vector xty_;
+    double yty_;
+    double sample_size_;
+    Vector prior_mean_;
+    Vector prior_precision_;
+    Vector prior_inclusion_probabilities_;
+    double prior_df_;
+    double prior_ss_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_SPIKE_SLAB_VARIATIONAL_REGRESSION_HPP_
@@ -0,0 +1,329 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_GLM_SUBSAMPLING_MH_SAMPLER_HPP_
+#define BOOM_GLM_SUBSAMPLING_MH_SAMPLER_HPP_
+
+#include <vector>
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/SpdMatrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <Models/Glm/BinomialLogitModel.hpp>
+#include <Models/Glm/MultinomialLogitModel.hpp>
+#include <Models/Glm/PoissonRegressionModel.hpp>
+#include <Models/MvnBase.hpp>
+#include <Models/PosteriorSamplers/PosteriorSampler.hpp>
+#include <Samplers/MH_Proposals.hpp>
+
+namespace BOOM {
+
+  // A random walk Metropolis sampler for the coefficients of a GLM
+  // with a very large number of observations.  Each proposal is
+  // evaluated on a random subsample of the data instead of the full
+  // data set, so an iteration costs O(batch_size) rather than O(N).
+  // The method is described in Quiroz, Kohn, Villani and Tran (2019),
+  // "Speeding up MCMC by efficient data subsampling", JASA.
+  //
+  // The log likelihood of observation i is a function l_i(eta_i) of
+  // its linear predictor eta_i = X_i * beta, which is a scalar for
+  // most GLMs and a vector for multinomial models.  The control
+  // variate q_i is the second order Taylor expansion of l_i about
+  // the linear predictor at the posterior mode.  The sum of the q_i
+  // is a quadratic function of beta whose coefficients are computed
+  // in one pass through the data when the mode is found.  The log
+  // likelihood is estimated by the difference estimator
+  //
+  //   sum_i q_i(beta) + (N / m) * sum_{j in S} (l_j(beta) - q_j(beta)),
+  //
+  // where S is a sample of m observations drawn with replacement.
+  // Half the estimated variance of the estimator is subtracted, so
+  // that its exponential is approximately unbiased for the
+  // likelihood.
+  //
+  // The subsample is part of the state of the Markov chain.  Each
+  // iteration proposes a new value for one of number_of_blocks()
+  // blocks of the subsample together with the new coefficients (the
+  // block pseudo-marginal method of Tran, Kohn, Quiroz and Villani),
+  // which keeps the estimates for the current and proposed
+  // coefficients strongly correlated.
+  //
+  // The first call to draw() calls find_posterior_mode(), which
+  // evaluates the full data set.  The random walk proposal uses the
+  // curvature of the log posterior at the mode.
+  //
+  // Like the other random walk samplers for GLMs, this sampler
+  // assumes that all the coefficients are included in the model.  It
+  // does not work with spike and slab priors.
+  class SubsamplingMhSampler : public PosteriorSampler {
+   public:
+    // Args:
+    //   prior:  The prior distribution for the coefficients.
+    //   batch_size:  The number of observations in the subsample.
+    //   nu: The degrees of freedom for the multivariate T random walk
+    //     proposal.  If nu <= 0 the proposal is Gaussian.
+    //   seeding_rng: The random number generator used to seed the
+    //     RNG for this sampler.
+    SubsamplingMhSampler(Ptr<MvnBase> prior,
+                         int batch_size,
+                         double nu,
+                         RNG &seeding_rng = GlobalRng::rng);
+
+    void draw() override;
+    double logpri() const override;
+
+    bool can_find_posterior_mode() const override { return true; }
+
+    // Find the mode of the full-data log posterior using Newton's
+    // method, set the model coefficients to the mode, and compute the
+    // control variates.  This evaluates every observation, several
+    // times.
+    void find_posterior_mode(double epsilon = 1e-5) override;
+
+    int batch_size() const { return batch_size_; }
+    void set_batch_size(int batch_size);
+
+    int number_of_blocks() const { return number_of_blocks_; }
+    void set_number_of_blocks(int number_of_blocks);
+
+    // Adjust the batch size during each of the next 'niter' calls to
+    // draw(), so that the estimated variance of the log likelihood
+    // estimate is close to target_variance.  The variance is
+    // estimated from the current subsample.  Changing the batch size
+    // changes the target distribution, so adaptation should be
+    // confined to the burn-in period.  Adaptation will not shrink the
+    // batch below 20 observations.
+    void adapt_batch_size(int niter, double target_variance = 1.0);
+
+    // The estimated variance of the log likelihood estimate for the
+    // current coefficients and subsample.
+    double log_likelihood_variance() const { return variance_; }
+
+    // The fraction of draws that were accepted.
+    double acceptance_rate() const;
+
+    //--------------------------------------------------------------
+    // The interface to the model being sampled.
+
+    // The number of observations in the full data set.
+    virtual int sample_size() const = 0;
+
+    virtual const Vector &coefficients() const = 0;
+    virtual void set_coefficients(const Vector &beta) = 0;
+
+    // Fill 'eta' with the linear predictor for observation i.  It may
+    // include offsets that do not depend on beta.
+    virtual void fill_linear_predictor(
+        int i, const Vector &beta, Vector &eta) const = 0;
+
+    // The log likelihood of observation i, as a function of its linear
+    // predictor.  Additive constants not depending on eta may be
+    // omitted.
+    // Args:
+    //   i:  The index of the observation.
+    //   eta:  The linear predictor for observation i.
+    //   gradient: If nd > 0 then gradient is resized and filled with
+    //     the derivative of the log likelihood with respect to eta.
+    //   Hessian: If nd > 1 then Hessian is resized and filled with
+    //     the second derivative with respect to eta.
+    //   nd:  The number of derivatives to compute.
+    virtual double observation_log_likelihood(int i,
+                                              const Vector &eta,
+                                              Vector &gradient,
+                                              Matrix &Hessian,
+                                              int nd) const = 0;
+
+    // Transform derivatives with respect to the linear predictor for
+    // observation i into derivatives with respect to beta, and add
+    // them to the output arguments.  Adds X_i^T * eta_gradient to
+    // gradient and, if Hessian is non-NULL, adds
+    // X_i^T * eta_Hessian * X_i to *Hessian.
+    virtual void add_coefficient_derivatives(int i,
+                                             const Vector &eta_gradient,
+                                             const Matrix &eta_Hessian,
+                                             Vector &gradient,
+                                             Matrix *Hessian) const = 0;
+
+    // The full data log likelihood, and its derivatives with respect
+    // to beta, computed from the functions above.
+    double full_data_log_likelihood(const Vector &beta,
+                                    Vector &gradient,
+                                    Matrix &Hessian,
+                                    int nd) const;
+
+   private:
+    // The second order Taylor expansion of the log likelihood of a
+    // single observation about its linear predictor at the mode.
+    struct ControlVariate {
+      int observation;
+      double log_likelihood;
+      Vector eta;
+      Vector gradient;
+      Matrix Hessian;
+    };
+
+    // Draw a new observation for subsample position 'slot'.
+    void draw_subsample_slot(int slot);
+
+    // Draw a new subsample, and evaluate the estimate at the current
+    // coefficients.
+    void refresh_subsample();
+
+    // Returns the bias corrected estimate of the log likelihood at
+    // beta, computed from the current subsample.  The variance of the
+    // estimate is returned in 'variance'.
+    double estimate_log_likelihood(const Vector &beta,
+                                   double &variance) const;
+
+    // The first and one-past-the-last subsample positions in 'block'.
+    int block_begin(int block) const;
+    int block_end(int block) const;
+
+    void adapt();
+
+    // The full-data log posterior, used to find the mode.
+    double log_posterior(const Vector &beta,
+                         Vector &gradient,
+                         Matrix &Hessian,
+                         int nd) const;
+
+    Ptr<MvnBase> prior_;
+    double nu_;
+    int batch_size_;
+    int number_of_blocks_;
+    int adaptation_iterations_remaining_;
+    double target_variance_;
+    int min_adapted_batch_size_;
+
+    // The full-data log likelihood and its derivatives at the mode.
+    bool mode_is_current_;
+    Vector mode_;
+    double log_likelihood_at_mode_;
+    Vector gradient_at_mode_;
+    Matrix Hessian_at_mode_;
+    Ptr<MvtRwmProposal> proposal_;
+
+    std::vector<ControlVariate> subsample_;
+
+    // The log likelihood estimate for estimated_coefficients_ on the
+    // current subsample, and its estimated variance.
+    Vector estimated_coefficients_;
+    double log_likelihood_estimate_;
+    double variance_;
+
+    int number_of_draws_;
+    int number_of_acceptances_;
+
+    // Workspace.
+    mutable Vector eta_;
+    mutable Vector eta_gradient_;
+    mutable Matrix eta_Hessian_;
+  };
+
+  //======================================================================
+  class BinomialLogitSubsamplingSampler : public SubsamplingMhSampler {
+   public:
+    BinomialLogitSubsamplingSampler(BinomialLogitModel *model,
+                                    Ptr<MvnBase> prior,
+                                    int batch_size,
+                                    double nu = 3,
+                                    RNG &seeding_rng = GlobalRng::rng);
+
+    int sample_size() const override;
+    const Vector &coefficients() const override;
+    void set_coefficients(const Vector &beta) override;
+    void fill_linear_predictor(
+        int i, const Vector &beta, Vector &eta) const override;
+    double observation_log_likelihood(int i,
+                                      const Vector &eta,
+                                      Vector &gradient,
+                                      Matrix &Hessian,
+                                      int nd) const override;
+    void add_coefficient_derivatives(int i,
+                                     const Vector &eta_gradient,
+                                     const Matrix &eta_Hessian,
+                                     Vector &gradient,
+                                     Matrix *Hessian) const override;
+
+   private:
+    BinomialLogitModel *model_;
+  };
+
+  //======================================================================
+  class PoissonRegressionSubsamplingSampler : public SubsamplingMhSampler {
+   public:
+    PoissonRegressionSubsamplingSampler(PoissonRegressionModel *model,
+                                        Ptr<MvnBase> prior,
+                                        int batch_size,
+                                        double nu = 3,
+                                        RNG &seeding_rng = GlobalRng::rng);
+
+    int sample_size() const override;
+    const Vector &coefficients() const override;
+    void set_coefficients(const Vector &beta) override;
+    void fill_linear_predictor(
+        int i, const Vector &beta, Vector &eta) const override;
+    double observation_log_likelihood(int i,
+                                      const Vector &eta,
+                                      Vector &gradient,
+                                      Matrix &Hessian,
+                                      int nd) const override;
+    void add_coefficient_derivatives(int i,
+                                     const Vector &eta_gradient,
+                                     const Matrix &eta_Hessian,
+                                     Vector &gradient,
+                                     Matrix *Hessian) const override;
+
+   private:
+    PoissonRegressionModel *model_;
+  };
+
+  //======================================================================
+  // The linear predictor for a multinomial logit observation is the
+  // vector of Nchoices() utilities, including the baseline choice.
+  class MultinomialLogitSubsamplingSampler : public SubsamplingMhSampler {
+   public:
+    MultinomialLogitSubsamplingSampler(MultinomialLogitModel *model,
+                                       Ptr<MvnBase> prior,
+                                       int batch_size,
+                                       double nu = 3,
+                                       RNG &seeding_rng = GlobalRng::rng);
+
+    int sample_size() const override;
+    const Vector &coefficients() const override;
+    void set_coefficients(const Vector &beta) override;
+    void fill_linear_predictor(
+        int i, const Vector &beta, Vector &eta) const override;
+    double observation_log_likelihood(int i,
+                                      const Vector &eta,
+                                      Vector &gradient,
+                                      Matrix &Hessian,
+                                      int nd) const override;
+    void add_coefficient_derivatives(int i,
+                                     const Vector &eta_gradient,
+                                     const Matrix &eta_Hessian,
+                                     Vector &gradient,
+                                     Matrix *Hessian) const override;
+
+   private:
+    MultinomialLogitModel *model_;
+    mutable Vector probs_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_GLM_SUBSAMPLING_MH_SAMPLER_HPP_
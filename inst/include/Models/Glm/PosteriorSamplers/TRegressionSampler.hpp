@@ -101,6 +101,10 @@ namespace BOOM {
     Ptr<ScaledChisqModel> weight_model_;
 
     WeightedRegSuf complete_data_sufficient_statistics_;
+
+    // Stages the imputed weights so they can be added to
+    // complete_data_sufficient_statistics_ in blocks.
+    WeightedCrossProductBuffer buffer_;
     GenericGaussianVarianceSampler sigsq_sampler_;
     TDataImputer data_imputer_;
 
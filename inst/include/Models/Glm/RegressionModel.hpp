@@ -169,6 +169,30 @@ namespace BOOM{
     // add_mixture_data(), or any of the flavors of Update().
     void fix_xtx(bool tf = true);
 
+    // Set xtx to the given value, and fix it.
+    void fix_xtx(const SpdMatrix &xtx);
+
+    // Add the sufficient statistics for a group of n observations with
+    // predictor matrix X and response vector y - offset, using
+    // precomputed summaries of the group.  This costs O(p) instead of
+    // the O(n * p) (or O(n * p^2)) needed to add the observations one
+    // at a time.  Because xtx is not updated, it must have been fixed
+    // before calling this function.
+    //
+    // Args:
+    //   xty: X'y
+    //   x_sums: The column sums of X.
+    //   yty: y'y
+    //   ysum: The sum of the elements in y.
+    //   n: The number of observations in the group.
+    //   offset: A constant to be subtracted from each y.
+    void add_offset_group(const Vector &xty,
+                          const Vector &x_sums,
+                          double yty,
+                          double ysum,
+                          double n,
+                          double offset);
+
     void clear() override;
     void add_mixture_data(
         double y, const Vector &x, double prob) override;
@@ -0,0 +1,94 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_GLM_WEIGHTED_CROSS_PRODUCT_BUFFER_HPP_
+#define BOOM_GLM_WEIGHTED_CROSS_PRODUCT_BUFFER_HPP_
+
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/SpdMatrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <LinAlg/VectorView.hpp>
+
+namespace BOOM {
+
+  // Data augmentation samplers for GLM's typically build complete
+  // data sufficient statistics X'WX and X'Wy by adding one weighted
+  // outer product per observation.  A WeightedCrossProductBuffer
+  // stages the rows of X, scaled by sqrt(w), in contiguous storage so
+  // that a block of observations can be added with a single dsyrk
+  // (for X'WX) and dgemv (for X'Wy).
+  //
+  // Typical use:
+  //   WeightedCrossProductBuffer buffer(xdim);
+  //   for (each observation) {
+  //     if (buffer.add(x, y, w)) {
+  //       suf.add_data(buffer);  // or equivalent
+  //       buffer.clear();
+  //     }
+  //   }
+  //   suf.add_data(buffer);
+  //   buffer.clear();
+  class WeightedCrossProductBuffer {
+   public:
+    // Args:
+    //   xdim:  The dimension of the predictor vectors.
+    //   capacity:  The number of observations in a block.
+    explicit WeightedCrossProductBuffer(int xdim, int capacity = 256);
+
+    // Stage an observation.
+    // Args:
+    //   x:  The vector of predictors.
+    //   y:  The (working) response.
+    //   w:  The weight.  Must be non-negative.
+    // Returns:
+    //   true if the buffer is full, in which case it should be
+    //   accumulated and cleared before the next call to add().
+    bool add(const ConstVectorView &x, double y, double w);
+
+    // Add X'WX to the upper triangle of xtwx, and X'Wy to xtwy, for
+    // the staged observations.  The lower triangle of xtwx is not
+    // referenced.
+    void accumulate(SpdMatrix &xtwx, Vector &xtwy) const;
+
+    // Discard the staged observations.
+    void clear();
+
+    int size() const {return size_;}
+    int capacity() const {return scaled_predictors_.nrow();}
+    int xdim() const {return scaled_predictors_.ncol();}
+
+    // Sums over the staged observations of w * y^2 and log(w).
+    double yt_w_y() const {return yt_w_y_;}
+    double sumlogw() const {return sumlogw_;}
+
+   private:
+    // Row i is sqrt(w[i]) * x[i].  Only the first size_ rows are in
+    // use.
+    Matrix scaled_predictors_;
+
+    // Element i is sqrt(w[i]) * y[i].
+    Vector scaled_responses_;
+
+    int size_;
+    double yt_w_y_;
+    double sumlogw_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_GLM_WEIGHTED_CROSS_PRODUCT_BUFFER_HPP_
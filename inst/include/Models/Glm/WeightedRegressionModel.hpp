@@ -21,6 +21,7 @@
 
 #include <Models/Glm/RegressionModel.hpp>
 #include <Models/Glm/Glm.hpp>
+#include <Models/Glm/WeightedCrossProductBuffer.hpp>
 
 namespace BOOM{
 
@@ -51,6 +52,9 @@ namespace BOOM{
     //    virtual void Update(const RegressionData &);
     void Update(const WeightedRegressionData &) override;
     void add_data(const Vector &x, double y, double w);
+    // Add all the observations staged in buffer.  The buffer is not
+    // cleared.
+    void add_data(const WeightedCrossProductBuffer &buffer);
 
     void clear() override;
     virtual uint size()const;  // dimension of beta
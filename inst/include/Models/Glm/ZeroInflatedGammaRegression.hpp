@@ -21,6 +21,7 @@
 
 #include <Models/Policies/CompositeParamPolicy.hpp>
 #include <Models/Policies/PriorPolicy.hpp>
+#include <TargetFun/TargetFun.hpp>
 #include <Models/Glm/BinomialLogitModel.hpp>
 #include <Models/Glm/GammaRegressionModel.hpp>
 
@@ -96,6 +97,22 @@ namespace BOOM {
 
     void mle() override;
 
+    // Log likelihood of the data, and its derivatives, as a function
+    // of [shape_parameter(), included regression coefficients,
+    // included logit coefficients].  The arguments follow the
+    // conventions of PoissonRegressionModel::log_likelihood.  The
+    // likelihood factors into gamma regression and logistic
+    // regression parts, so the Hessian is block diagonal.  Both parts
+    // compute their derivatives from packed design matrices.
+    double log_likelihood(const Vector &parameters,
+                          Vector *gradient = nullptr,
+                          Matrix *hessian = nullptr,
+                          bool reset_derivatives = true) const;
+
+    // log_likelihood(), wrapped as a function object for use with
+    // optimizers and samplers that need derivatives.
+    d2TargetFunPointerAdapter log_likelihood_tf() const;
+
    private:
     Ptr<GammaRegressionModelConditionalSuf> gamma_model_;
     Ptr<BinomialLogitModel> logit_model_;
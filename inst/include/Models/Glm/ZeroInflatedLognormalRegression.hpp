@@ -22,6 +22,7 @@
 #include <Models/Policies/ParamPolicy_3.hpp>
 #include <Models/Policies/IID_DataPolicy.hpp>
 #include <Models/Policies/PriorPolicy.hpp>
+#include <TargetFun/TargetFun.hpp>
 #include <Models/Glm/GlmCoefs.hpp>
 #include <Models/Glm/Glm.hpp>
 #include <Models/Hierarchical/HierarchicalZeroInflatedGammaModel.hpp>
@@ -56,6 +57,12 @@ namespace BOOM {
                                          double zero_threshold = 1e-5);
     ZeroInflatedLognormalRegressionModel * clone() const override;
 
+    // Adding or removing data invalidates the packed design matrix
+    // used by log_likelihood().
+    void add_data(Ptr<Data> dp) override;
+    void add_data(Ptr<RegressionData> dp) override;
+    void clear_data() override;
+
     double expected_value(const Vector &x) const;
     double variance(const Vector &x) const;
     double standard_deviation(const Vector &x) const;
@@ -79,8 +86,46 @@ namespace BOOM {
     HierarchicalZeroInflatedGammaData simulate_sufficient_statistics(
         const Vector &x, int64_t n, RNG &rng = BOOM::GlobalRng::rng) const;
 
+    // Log likelihood of the data as a function of the coefficients,
+    // with sigsq held at its current value.
+    //
+    // Args:
+    //   coefficients: The included regression coefficients followed
+    //     by the included logit coefficients.
+    //   gradient: If non-NULL the gradient is computed and output
+    //     here.  If NULL then no derivative computations are made.
+    //   hessian: If hessian and gradient are both non-NULL the
+    //     hessian is computed and output here.  If NULL then the
+    //     hessian is not computed.
+    //   reset_derivatives: If true then a non-NULL gradient or
+    //     hessian will be resized and set to zero.  If false then a
+    //     non-NULL gradient or hessian will have derivatives of
+    //     log-liklihood added to its input value.  It is an error if
+    //     reset_derivatives is false and the wrong-sized non-NULL
+    //     argument is passed.
+    //
+    // The predictors are packed into a single design matrix the first
+    // time this function is called after data are added or removed,
+    // so the derivatives are computed with matrix products rather
+    // than one outer product per observation.  The Hessian is block
+    // diagonal, because the two sets of coefficients appear in
+    // different factors of the likelihood.
+    double log_likelihood(const Vector &coefficients,
+                          Vector *gradient = nullptr,
+                          Matrix *hessian = nullptr,
+                          bool reset_derivatives = true) const;
+
+    // log_likelihood(), wrapped as a function object for use with
+    // optimizers and samplers that need derivatives.
+    d2TargetFunPointerAdapter log_likelihood_tf() const;
+
    private:
+    // Copy the predictors from dat() into design_.
+    void refresh_packed_design() const;
+
     double zero_threshold_;
+    mutable Matrix design_;
+    mutable bool packed_design_current_;
   };
 
 }
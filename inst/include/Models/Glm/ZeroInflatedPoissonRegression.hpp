@@ -23,6 +23,7 @@
 #include <Models/Policies/ParamPolicy_2.hpp>
 #include <Models/Policies/IID_DataPolicy.hpp>
 #include <Models/Policies/PriorPolicy.hpp>
+#include <TargetFun/TargetFun.hpp>
 #include <Models/ZeroInflatedPoissonModel.hpp>
 
 namespace BOOM {
@@ -88,6 +89,12 @@ namespace BOOM {
     ZeroInflatedPoissonRegressionModel(int dimension);
     ZeroInflatedPoissonRegressionModel * clone() const override;
 
+    // Adding or removing data invalidates the packed design matrix
+    // used by log_likelihood().
+    void add_data(Ptr<Data> dp) override;
+    void add_data(Ptr<ZeroInflatedPoissonRegressionData> dp) override;
+    void clear_data() override;
+
     // Returns the conditional expected value per trial, given the
     // specified vector of predictor variables x.  The conditional
     // expectation is p(x) * lambda(x).
@@ -126,6 +133,55 @@ namespace BOOM {
     //   Aggregated data for the all the requested observations.
     ZeroInflatedPoissonSuf simulate_sufficient_statistics(const Vector &x,
                                                           int64_t n) const;
+
+    // Log likelihood of the observed data, up to a constant that
+    // depends only on the data.  The forced zeros are integrated out,
+    // so no data augmentation is needed.
+    //
+    // Args:
+    //   coefficients: The included Poisson coefficients followed by
+    //     the included logit coefficients.
+    //   gradient: If non-NULL the gradient is computed and output
+    //     here.  If NULL then no derivative computations are made.
+    //   hessian: If hessian and gradient are both non-NULL the
+    //     hessian is computed and output here.  If NULL then the
+    //     hessian is not computed.
+    //   reset_derivatives: If true then a non-NULL gradient or
+    //     hessian will be resized and set to zero.  If false then a
+    //     non-NULL gradient or hessian will have derivatives of
+    //     log-liklihood added to its input value.  It is an error if
+    //     reset_derivatives is false and the wrong-sized non-NULL
+    //     argument is passed.
+    //
+    // The predictors are packed into a single design matrix the first
+    // time this function is called after data are added or removed, so
+    // the derivatives are computed with a few matrix products rather
+    // than one outer product per observation.  The trial and event
+    // counts are read from the data on each call.
+    double log_likelihood(const Vector &coefficients,
+                          Vector *gradient = nullptr,
+                          Matrix *hessian = nullptr,
+                          bool reset_derivatives = true) const;
+
+    // log_likelihood(), wrapped as a function object for use with
+    // optimizers and samplers that need derivatives.
+    d2TargetFunPointerAdapter log_likelihood_tf() const;
+
+    // The log likelihood at the current parameter values.
+    double log_likelihood() const;
+
+    // Set the included coefficients to their maximum likelihood
+    // values using Newton's method.  Returns true if the optimizer
+    // converged, in which case the coefficients are updated.
+    // Otherwise the model is unchanged.
+    bool mle();
+
+   private:
+    // Copy the predictors from dat() into design_.
+    void refresh_packed_design() const;
+
+    mutable Matrix design_;
+    mutable bool packed_design_current_;
   };
 
 } // namespace BOOM
@@ -64,6 +64,9 @@ namespace BOOM{
       uint Nscales()const;
 
       virtual double loglike()const;
+      // The log likelihood of the responses evaluated at Theta in
+      // place of the subject's current value.
+      double loglike(const Vector &Theta)const;
       const string & id()const;
       SpdMatrix xtx()const;
       // returns \sum_i \Beta_i \Beta_i^T for betas
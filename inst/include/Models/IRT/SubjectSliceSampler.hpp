@@ -21,6 +21,7 @@
 #include <TargetFun/TargetFun.hpp>
 #include <Models/PosteriorSamplers/PosteriorSampler.hpp>
 #include <Models/ParamTypes.hpp>
+#include <LinAlg/SpdMatrix.hpp>
 
 namespace BOOM{
   class SliceSampler;
@@ -49,12 +50,28 @@ namespace BOOM{
       SubjectSliceSampler * clone()const;
       void draw() override;
       double logpri() const override;
+
+      // Evaluate the slice sampler's candidate points in batches on
+      // the given number of threads.  The batched target evaluates
+      // the prior through its mean() and siginv(), and the items
+      // through response_prob(), without writing Theta into the
+      // subject.  If n <= 1 candidates are evaluated one at a time.
+      void set_number_of_threads(int n);
+
     private:
       Ptr<Subject> sub;
       Ptr<SubjectPrior> pri;
       SubjectTF target;
       Ptr<SliceSampler> sam;
       Vector Theta;
+
+      // Prior moments used by the batched target, refreshed at the
+      // start of each draw.
+      Vector prior_mean_;
+      SpdMatrix prior_siginv_;
+      double prior_ldsi_;
+      int number_of_threads_;
+      double parallel_logp(const Vector &theta)const;
     };
   }  // namespace IRT
 }  // namespace BOOM
@@ -203,13 +203,62 @@ namespace BOOM {
 
   };
   //======================================================================
-  class LoglikeModel : public MLE_Model {
+  // A mix-in for models whose likelihood can be "tempered" by raising
+  // it to a power between 0 and 1, so that the posterior becomes
+  // p(theta) * p(y | theta)^power.  Tempered copies of a model are
+  // used by ReplicaExchangeDriver to help MCMC escape local modes.
+  //
+  // The power is only a hook.  A PosteriorSampler must consult
+  // likelihood_power() for tempering to have any effect.
+  // ReplicaExchangeDriver checks can_be_tempered() and refuses models
+  // whose samplers do not.
+  class TemperableModel : virtual public Model {
+   public:
+    TemperableModel() : likelihood_power_(1.0) {}
+
+    double likelihood_power() const { return likelihood_power_; }
+
+    // Args:
+    //   power: The exponent applied to the likelihood.  Must be in
+    //     [0, 1].  A power of 1 gives the usual posterior.  A power of
+    //     0 gives the prior.
+    virtual void set_likelihood_power(double power);
+
+    // Returns true if sample_posterior() respects likelihood_power().
+    // The default implementation returns true if the model has at
+    // least one sampling method, and every sampling method can temper
+    // the likelihood.  Models that override sample_posterior()
+    // directly should override this function as well.
+    virtual bool can_be_tempered() const;
+
+    // The untempered log likelihood evaluated at the current model
+    // parameters (and latent data, if any).  The default
+    // implementation throws an exception.
+    virtual double log_likelihood() const;
+
+    // The log of the likelihood factor that the samplers raise to
+    // likelihood_power().  This is the quantity used to compute swap
+    // probabilities in parallel tempering.  The default is
+    // log_likelihood().  Latent variable models whose samplers temper
+    // the complete data likelihood p(y, z | theta) should return its
+    // log, evaluated at the current latent data.
+    virtual double tempered_log_likelihood() const {
+      return log_likelihood();
+    }
+
+   private:
+    double likelihood_power_;
+  };
+
+  //======================================================================
+  class LoglikeModel : public MLE_Model,
+                       virtual public TemperableModel {
    public:
     // Evaluate log likelihood at the given parameter vector.
     virtual double loglike(const Vector &theta)const = 0;
 
     // Evaluate log likelihood with the current set of model parameters.
-    virtual double log_likelihood() const {
+    double log_likelihood() const override {
       return loglike(vectorize_params(true));
     }
 
@@ -248,7 +297,11 @@ namespace BOOM {
     }
   };
   //======================================================================
-  class LatentVariableModel : virtual public Model {
+  // Latent variable models can be tempered, but they must override
+  // log_likelihood() to return the observed data log likelihood, and
+  // be given samplers that can temper the likelihood, before a
+  // ReplicaExchangeDriver can use them.
+  class LatentVariableModel : virtual public TemperableModel {
    public:
     virtual void impute_latent_data(RNG &rng) = 0;
   };
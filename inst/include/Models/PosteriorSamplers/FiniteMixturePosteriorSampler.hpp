@@ -39,6 +39,20 @@ namespace BOOM{
       return ans;
     }
 
+    // The model tempers its complete data likelihood by adding
+    // weighted data to the mixture components, which must therefore
+    // be EmMixtureComponents.
+    bool can_temper_likelihood() const override {
+      for (int s = 0; s < model_->number_of_mixture_components(); ++s) {
+        const FiniteMixtureModel *model = model_;
+        if (!dynamic_cast<const EmMixtureComponent *>(
+                model->mixture_component(s))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
     void draw() override{
       model_->impute_latent_data(rng());
       model_->mixing_distribution()->sample_posterior();
@@ -19,8 +19,10 @@
 #ifndef BOOM_LATENT_DATA_IMPUTER_HPP
 #define BOOM_LATENT_DATA_IMPUTER_HPP
 
-#include <memory>
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #include <future>
 
@@ -172,11 +174,17 @@ namespace BOOM {
                                           SUFFICIENT_STATISTICS *suf,
                                           RNG &rng) = 0;
 
+    // Called once impute_latent_data_point() has been called for each
+    // data point.  Workers that stage imputed data before adding it to
+    // suf (e.g. to add it in blocks) should add the remainder here.
+    virtual void finalize_latent_data(SUFFICIENT_STATISTICS *suf) {}
+
     void impute_latent_data() override {
       suf_->clear();
       for (Iterator it = observed_data_begin_; it != observed_data_end_; ++it) {
         impute_latent_data_point(**it, suf_.get(), *rng_);
       }
+      finalize_latent_data(suf_.get());
     };
 
     void combine_complete_data() override {
@@ -185,6 +193,16 @@ namespace BOOM {
       global_suf_.combine(*suf_);
     }
 
+    // Add the local sufficient statistics held by 'other' to the
+    // local sufficient statistics held by this worker.  Neither
+    // worker's global sufficient statistics are touched, so no lock
+    // is needed as long as no other thread is using either worker.
+    // This is the pairwise step of
+    // LatentDataSampler::impute_latent_data_by_tree_reduction().
+    void absorb(const SufstatImputeWorker &other) {
+      suf_->combine(*other.suf_);
+    }
+
    private:
     Ptr<SUFFICIENT_STATISTICS> suf_;
     SUFFICIENT_STATISTICS  &global_suf_;
@@ -222,20 +240,28 @@ namespace BOOM {
 
     // Impute the latent data.
     void impute_latent_data() {
-      if (pool_.no_threads()) {
-        for (int i = 0; i < workers_.size(); ++i) {
+      pool_.run_jobs(workers_.size(), [this](int i) {
           workers_[i]->impute_latent_data();
           workers_[i]->combine_complete_data();
-        }
-      } else {
-        std::vector<std::future<void> > jobs;
-        for (int i = 0; i < workers_.size(); ++i) {
-          jobs.emplace_back(pool_.submit(workers_[i]->callback()));
-        }
-        for (int i = 0; i < jobs.size(); ++i) {
-          jobs[i].get();
-        }
+        });
+    }
+
+    // Impute the latent data into each worker's local repository,
+    // without combining it with the global complete data.
+    void impute_local_latent_data() {
+      std::vector<std::function<void(void)>> jobs;
+      for (int i = 0; i < workers_.size(); ++i) {
+        LatentDataImputerWorker *worker = workers_[i].get();
+        jobs.push_back([worker]() {worker->impute_latent_data();});
       }
+      run(jobs);
+    }
+
+    // Run a set of independent jobs in the thread pool, or
+    // sequentially if there are no background threads.  Returns when
+    // all the jobs have finished.
+    void run(const std::vector<std::function<void(void)>> &jobs) {
+      pool_.run_jobs(jobs.size(), [&jobs](int i) { jobs[i](); });
     }
 
    private:
@@ -308,7 +334,9 @@ namespace BOOM {
     // okay) call reassign_data_each_time() so that the workers
     // continue to have access to valid data.  This might be necessary
     // if the model is used as a mixture component in a finite mixture
-    // model, for example.
+    // model, for example.  It is also needed by samplers that set up
+    // their workers in the constructor, because data are commonly
+    // added to the model after the sampler is created.
     //
     // Args:
     //   reassign: If true then call assign_data_to_workers each time
@@ -334,6 +362,39 @@ namespace BOOM {
    protected:
     std::vector<Ptr<WORKER>> &workers() {return workers_;}
 
+    // An alternative to impute_latent_data() for workers whose local
+    // complete data is expensive to combine.  Rather than having each
+    // worker lock the global repository and add its local complete
+    // data in turn, the local repositories are summed pairwise in
+    // parallel (worker i absorbs worker i + 1, then worker i absorbs
+    // worker i + 2, and so on), so only log2(number of workers)
+    // combination steps are on the critical path.  The total is then
+    // combined with the global repository by the first worker.
+    //
+    // Child classes opt in by overriding impute_latent_data() to call
+    // this function.  WORKER must have a method absorb(const WORKER &),
+    // which adds the other worker's local complete data to its own.
+    void impute_latent_data_by_tree_reduction() {
+      if (latent_data_fixed_) return;
+      clear_latent_data();
+      if (reassign_data_each_time_) {
+        assign_data_to_workers();
+      }
+      imputer_.impute_local_latent_data();
+      for (size_t stride = 1; stride < workers_.size(); stride *= 2) {
+        std::vector<std::function<void(void)>> jobs;
+        for (size_t i = 0; i + stride < workers_.size(); i += 2 * stride) {
+          WORKER *target = workers_[i].get();
+          const WORKER *source = workers_[i + stride].get();
+          jobs.push_back([target, source]() {target->absorb(*source);});
+        }
+        imputer_.run(jobs);
+      }
+      if (!workers_.empty()) {
+        workers_[0]->combine_complete_data();
+      }
+    }
+
    private:
     // If this flag is set then latent data will not be changed from
     // its current values.
@@ -0,0 +1,195 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_MULTI_CHAIN_RUNNER_HPP_
+#define BOOM_MULTI_CHAIN_RUNNER_HPP_
+
+#include <functional>
+#include <vector>
+#include <Models/ModelTypes.hpp>
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <cpputil/Ptr.hpp>
+#include <cpputil/ThreadTools.hpp>
+#include <distributions/rng.hpp>
+#include <stats/mcmc_convergence.hpp>
+
+namespace BOOM {
+
+  // Runs several MCMC chains for the same model, optionally in
+  // parallel, monitoring split R-hat and effective sample size for
+  // each element of vectorize_params() as the chains run.  The
+  // diagnostics are accumulated as the draws arrive (see
+  // StreamingConvergenceDiagnostics), so the cost of each check does
+  // not grow with the length of the chains.  Sampling
+  // stops when every parameter meets the convergence criteria, or
+  // when the maximum number of iterations is reached.
+  //
+  // Each chain is a clone() of a prototype model.  Because clone()
+  // does not copy data, priors, or posterior samplers, the caller
+  // supplies a ChainSetup function that completes each clone.  The
+  // setup function receives an RNG that is unique to the chain, which
+  // should be used as the 'seeding_rng' for any PosteriorSampler
+  // objects it creates, so that each chain has its own random number
+  // stream.
+  //
+  // The idiom is
+  //
+  //   MultiChainRunner runner(
+  //       prototype, 4,
+  //       [&data](Model *chain, RNG &seeding_rng) {
+  //         MyModel *model = dynamic_cast<MyModel *>(chain);
+  //         for (const auto &dp : data) model->add_data(dp);
+  //         model->set_method(new MySampler(model, prior, seeding_rng));
+  //       });
+  //   runner.set_initial_value_perturbation(
+  //       [&prior](Model *chain, RNG &rng) {
+  //         ... draw chain's parameters from a widened prior ...
+  //       });
+  //   runner.set_number_of_threads(4);
+  //   runner.run(10000, 1000);
+  //   if (runner.converged()) { ... use runner.draws(chain) ... }
+  //
+  // NOTE: Chains running in separate threads must not share mutable
+  // state, including GlobalRng::rng.  Samplers that draw from the
+  // global RNG (rather than their own rng()) should be run with a
+  // single thread.
+  class MultiChainRunner {
+   public:
+    typedef std::function<void(Model *chain, RNG &seeding_rng)> ChainSetup;
+
+    // A function that moves a chain away from its starting values,
+    // e.g. by drawing its parameters from an overdispersed version of
+    // the prior.
+    typedef std::function<void(Model *chain, RNG &rng)>
+    InitialValuePerturbation;
+
+    // Args:
+    //   prototype: The model to be cloned.  Each chain begins at the
+    //     prototype's current parameter values, unless an initial
+    //     value perturbation is set.
+    //   number_of_chains: The number of chains to run.  Must be at
+    //     least 1.  At least 2 chains are recommended, because R-hat
+    //     is most informative when comparing independent chains.
+    //   setup: A function that assigns data and posterior samplers to
+    //     each clone.
+    //   seeding_rng: The RNG used to seed the RNG for each chain.
+    MultiChainRunner(const Ptr<Model> &prototype,
+                     int number_of_chains,
+                     const ChainSetup &setup,
+                     RNG &seeding_rng = GlobalRng::rng);
+
+    // Set the number of worker threads.  If n <= 1 the chains run
+    // sequentially in the calling thread.
+    void set_number_of_threads(int n);
+
+    // Sampling stops once split R-hat is below max_rhat and the
+    // effective sample size is above min_effective_sample_size for
+    // every parameter.
+    void set_convergence_criteria(double max_rhat,
+                                  double min_effective_sample_size);
+
+    // The number of iterations each chain runs between checks of the
+    // convergence diagnostics.
+    void set_check_interval(int iterations);
+
+    // At the start of each call to run(), before burn-in, 'perturb' is
+    // called on each chain with an RNG belonging to that chain.  R-hat
+    // compares chains with one another, so chains that all start from
+    // the same point can appear to have converged before they have
+    // explored the posterior.  Starting values that are overdispersed
+    // relative to the posterior are recommended.
+    void set_initial_value_perturbation(
+        const InitialValuePerturbation &perturb);
+
+    // Run the chains until convergence, or until each chain has run
+    // max_iterations post-burn-in iterations.
+    //
+    // Args:
+    //   max_iterations: The maximum number of iterations, per chain,
+    //     to record.
+    //   burn: The number of iterations to discard from the start of
+    //     each chain.  Discarded iterations are not monitored.
+    //
+    // Returns:
+    //   The number of iterations recorded for each chain.
+    int run(int max_iterations, int burn = 0);
+
+    // True if the convergence criteria were met at the most recent
+    // check.
+    bool converged() const { return converged_; }
+
+    // Split R-hat and effective sample size for each element of
+    // vectorize_params(), as of the most recent check.
+    const Vector &rhat() const { return rhat_; }
+    const Vector &effective_sample_size() const {
+      return effective_sample_size_;
+    }
+
+    int number_of_chains() const { return chains_.size(); }
+    int number_of_iterations() const { return number_of_iterations_; }
+
+    // The recorded draws from the specified chain.  Rows are
+    // iterations, and columns correspond to elements of
+    // vectorize_params().
+    Matrix draws(int chain) const;
+
+    // The model object for the specified chain, which holds the most
+    // recent draw.
+    Ptr<Model> chain(int i) { return chains_[i]; }
+
+   private:
+    // Run chain i for the given number of iterations.  If 'record' is
+    // true then the draws are stored.
+    void run_chain(int i, int iterations, bool record);
+
+    // Run each chain for the given number of iterations, in parallel
+    // if there are threads available.
+    void run_all_chains(int iterations, bool record);
+
+    // Recompute rhat_ and effective_sample_size_ from the streaming
+    // diagnostics, and update converged_.
+    void update_diagnostics();
+
+    std::vector<Ptr<Model>> chains_;
+    std::vector<RNG> chain_rngs_;
+    InitialValuePerturbation perturb_;
+    int parameter_dimension_;
+
+    // draws_[i] contains the draws for chain i, stored by iteration,
+    // so that element (t, j) is at position t * parameter_dimension_ + j.
+    std::vector<std::vector<double>> draws_;
+
+    // diagnostics_[j] monitors element j of vectorize_params().
+    std::vector<StreamingConvergenceDiagnostics> diagnostics_;
+    int number_of_iterations_;
+
+    double max_rhat_;
+    double min_effective_sample_size_;
+    int check_interval_;
+
+    bool converged_;
+    Vector rhat_;
+    Vector effective_sample_size_;
+
+    ThreadWorkerPool pool_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_MULTI_CHAIN_RUNNER_HPP_
@@ -61,6 +61,15 @@ namespace BOOM{
       return false;
     }
 
+    // Returns true if draw() targets prior * likelihood^power, where
+    // power is the likelihood_power() of the TemperableModel being
+    // sampled.  Samplers that ignore the likelihood power must leave
+    // this false, so that tempered replicas are not silently run at
+    // power 1.
+    virtual bool can_temper_likelihood() const {
+      return false;
+    }
+
     // The default implementations of the following three functions
     // throw an exception through report_error().
     virtual void find_posterior_mode(double epsilon = 1e-5);
@@ -0,0 +1,154 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_REPLICA_EXCHANGE_DRIVER_HPP_
+#define BOOM_REPLICA_EXCHANGE_DRIVER_HPP_
+
+#include <functional>
+#include <vector>
+#include <Models/ModelTypes.hpp>
+#include <LinAlg/Vector.hpp>
+#include <cpputil/Ptr.hpp>
+#include <cpputil/ThreadTools.hpp>
+#include <distributions/rng.hpp>
+
+namespace BOOM {
+
+  // Parallel tempering (replica exchange MCMC) for models with
+  // multimodal posteriors.  Several copies ("replicas") of a model are
+  // run at a ladder of likelihood powers
+  //
+  //   1 = beta[0] > beta[1] > ... > beta[K-1] > 0.
+  //
+  // Replica k targets p(theta) * p(y | theta)^beta[k], so replicas
+  // with small beta move easily between modes.  After each iteration,
+  // in which every replica calls sample_posterior() (concurrently if
+  // threads are available), swaps are proposed between replicas at
+  // neighboring levels of the ladder, alternating between even and
+  // odd pairs.  Draws from the replica at beta = 1 (the "cold chain")
+  // are draws from the posterior.
+  //
+  // Replicas are clones of a prototype model, which must inherit from
+  // TemperableModel, completed by a caller-supplied setup function as
+  // in MultiChainRunner.  The posterior samplers assigned by the setup
+  // function must respect the model's likelihood_power() (see
+  // TemperableModel::can_be_tempered(), which the constructor
+  // checks), and the model must implement tempered_log_likelihood()
+  // (by default log_likelihood()), which is used to compute the swap
+  // probabilities.
+  //
+  // FiniteMixtureModel is tempered through its complete data
+  // likelihood, which FiniteMixturePosteriorSampler supports when
+  // every mixture component is an EmMixtureComponent.  Hidden Markov
+  // models and PoissonClusterProcess are not TemperableModels.
+  class ReplicaExchangeDriver {
+   public:
+    typedef std::function<void(Model *replica, RNG &seeding_rng)> ReplicaSetup;
+
+    // Args:
+    //   prototype: The model to be cloned.  Each replica begins at
+    //     the prototype's current parameter values.
+    //   number_of_replicas: The number of rungs on the temperature
+    //     ladder.  Must be at least 2.
+    //   setup: A function that assigns data and posterior samplers to
+    //     each clone.  The RNG argument should be used to seed any
+    //     samplers the setup function creates.
+    //   seeding_rng: The RNG used to seed the per-replica RNG's.
+    //
+    // The initial ladder is geometric, with beta[K-1] = 0.01.
+    ReplicaExchangeDriver(const Ptr<TemperableModel> &prototype,
+                          int number_of_replicas,
+                          const ReplicaSetup &setup,
+                          RNG &seeding_rng = GlobalRng::rng);
+
+    // Set the number of worker threads.  If n <= 1 the replicas are
+    // updated sequentially in the calling thread.
+    void set_number_of_threads(int n);
+
+    // Set the likelihood powers for each rung of the ladder.  The
+    // first element must be 1, and the elements must be strictly
+    // decreasing and positive.
+    void set_ladder(const Vector &likelihood_powers);
+    const Vector &ladder() const { return ladder_; }
+
+    // If okay_to_adapt is true then the spacing of the ladder is
+    // adjusted after each round of swaps, aiming for the target swap
+    // acceptance rate between each pair of neighbors (Miasojedow,
+    // Moulines and Vihola, 2013).  The amount of adaptation diminishes
+    // over time, but adaptation is best restricted to burn-in.
+    void allow_ladder_adaptation(bool okay_to_adapt,
+                                 double target_swap_rate = 0.234);
+
+    // Update every replica, then propose swaps between neighbors.
+    void iterate();
+
+    // The replica currently at the top of the ladder (beta = 1).
+    Ptr<TemperableModel> cold_chain() { return replicas_[level_[0]]; }
+
+    // The replica currently at the specified level of the ladder.
+    Ptr<TemperableModel> replica_at_level(int level) {
+      return replicas_[level_[level]];
+    }
+
+    // The fraction of swaps accepted between levels k and k+1, for
+    // each k.
+    Vector swap_acceptance_rates() const;
+
+    int number_of_replicas() const { return replicas_.size(); }
+
+   private:
+    // Call sample_posterior() on every replica, and record each
+    // replica's log likelihood.
+    void update_replicas();
+
+    // Propose swaps between neighboring levels.
+    void propose_swaps();
+
+    // Adjust the ladder based on the most recent swap acceptance
+    // probabilities.
+    void adapt_ladder(const Vector &acceptance_probabilities);
+
+    // Assign each replica the likelihood power for its current level.
+    void set_replica_powers();
+
+    std::vector<Ptr<TemperableModel>> replicas_;
+
+    // level_[k] is the index (in replicas_) of the replica at level k
+    // of the ladder.
+    std::vector<int> level_;
+
+    // The untempered log likelihood of each replica (indexed as in
+    // replicas_), as of the most recent update.
+    Vector log_likelihood_;
+
+    Vector ladder_;
+
+    bool adapt_ladder_;
+    double target_swap_rate_;
+    int number_of_swap_rounds_;
+    bool even_round_;
+    std::vector<int> swap_attempts_;
+    std::vector<int> swap_successes_;
+
+    RNG rng_;
+    ThreadWorkerPool pool_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_REPLICA_EXCHANGE_DRIVER_HPP_
@@ -166,6 +166,11 @@ namespace BOOM{
     Vector operator*(const ConstVectorView &v) const override;
 
     Vector Tmult(const Vector &v) const override;
+
+    void multiply(VectorView lhs, const ConstVectorView &rhs) const override;
+    void Tmult(VectorView lhs, const ConstVectorView &rhs) const override;
+    void multiply_inplace(VectorView x) const override;
+
     void sandwich_inplace(SpdMatrix &P) const override;
     Matrix & add_to(Matrix &P) const override;
    private:
@@ -214,6 +219,10 @@ namespace BOOM{
     Vector operator*(const ConstVectorView &v) const override;
 
     Vector Tmult(const Vector &x) const override;
+
+    void multiply(VectorView lhs, const ConstVectorView &rhs) const override;
+    void Tmult(VectorView lhs, const ConstVectorView &rhs) const override;
+
     Matrix & add_to(Matrix &P) const override;
    private:
     // See the fragility comments in AccumulatorTransitionMatrix.
@@ -323,7 +332,7 @@ namespace BOOM{
     state_variance_matrix(int t) const override;
 
     void simulate_initial_state(VectorView v) const override;
-    Vector simulate_state_error(int t) const override;
+    void simulate_state_error(RNG &rng, VectorView eta, int t) const override;
 
     Vector initial_state_mean() const override;
     SpdMatrix initial_state_variance() const override;
@@ -0,0 +1,162 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_MULTI_SERIES_KALMAN_FILTER_HPP_
+#define BOOM_MULTI_SERIES_KALMAN_FILTER_HPP_
+
+#include <vector>
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/SpdMatrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <LinAlg/VectorView.hpp>
+#include <Models/StateSpace/StateSpaceModelBase.hpp>
+#include <cpputil/Ptr.hpp>
+#include <cpputil/ThreadTools.hpp>
+
+namespace BOOM {
+
+  // Runs the Kalman filter (the sparse_scalar_kalman_update
+  // recursion) for a collection of scalar time series that share a
+  // common state space structure, but have their own data and
+  // parameters.  This is the situation when a model with the same
+  // trend and seasonal components is fit to each of many series.
+  //
+  // Each series is described by its own StateSpaceModelBase, built
+  // from the usual StateModel classes, which supplies the series'
+  // data, observation variance, state variance and initial state
+  // distribution.  The transition matrices T[t] and observation
+  // vectors Z[t] are structural, so they are taken from the first
+  // model and must be shared by all the others.  Each series is
+  // checked against the first at every time point where the first
+  // model's T[t] or Z[t] changes, and an error is reported if they
+  // differ.  In practice this rules out state models with
+  // parameterized transitions, such as ArStateModel,
+  // SemilocalLinearTrend, or DynamicRegressionStateModel.  The state
+  // variance matrices are re-read from the series models at the time
+  // points where the first model's state variance matrix changes
+  // (e.g. at the boundary of a seasonal cycle), so time variation in
+  // RQR[t] must also be structural.  The series models must not share
+  // state models with one another.
+  //
+  // Rather than filtering the series one at a time, the filter
+  // divides the series into batches and runs the recursion for all
+  // the series in a batch in lockstep.  The filter state for a batch
+  // is stored with the series index innermost, so every step of the
+  // recursion is a loop over contiguous arrays that the compiler can
+  // vectorize, and the nonzero elements of the shared T[t] and Z[t]
+  // are visited once per batch rather than once per series.  Batches
+  // are independent, so they can be filtered in parallel.
+  class MultiSeriesKalmanFilter {
+   public:
+    // Args:
+    //   series_models: One model for each series.  All models must
+    //     have the same state dimension and time dimension.
+    explicit MultiSeriesKalmanFilter(
+        const std::vector<Ptr<StateSpaceModelBase>> &series_models);
+
+    // Filter the batches using 'n' threads.  If n <= 1 the batches
+    // are filtered in the calling thread.
+    void set_number_of_threads(int n);
+
+    // Set the number of series that are filtered together.
+    void set_batch_size(int batch_size);
+
+    // By default the filter keeps the state variance at the end of
+    // each series, and discards the one-step prediction errors and
+    // their variances.  Both can be large when there are many series.
+    void store_final_state_variance(bool store) {
+      store_final_state_variance_ = store;
+    }
+    void store_prediction_errors(bool store) {
+      store_prediction_errors_ = store;
+    }
+
+    // Run the filter for all series, using the current data and
+    // parameters of the series models.
+    void filter();
+
+    int number_of_series() const { return series_models_.size(); }
+    int state_dimension() const { return state_dimension_; }
+    int time_dimension() const { return time_dimension_; }
+
+    // The log likelihood of each series, as of the most recent call to
+    // filter().
+    double log_likelihood(int series) const {
+      return log_likelihood_[series];
+    }
+    const Vector &log_likelihoods() const { return log_likelihood_; }
+
+    // The predictive distribution of the state one period past the
+    // end of each series, given all of the series' data.
+    ConstVectorView final_state_mean(int series) const {
+      return final_state_mean_.col(series);
+    }
+    const SpdMatrix &final_state_variance(int series) const;
+
+    // The one-step prediction errors v[t] and their variances F[t]
+    // for each series.  Only available if store_prediction_errors(true)
+    // was set before the most recent call to filter().  Elements
+    // corresponding to missing observations are zero.
+    ConstVectorView prediction_errors(int series) const;
+    ConstVectorView forecast_variances(int series) const;
+
+   private:
+    // The nonzero elements of T[t], or of Z[t] if 'col' is empty.
+    struct SparseEntries {
+      std::vector<int> row;
+      std::vector<int> col;
+      std::vector<double> value;
+    };
+
+    // Record the shared T[t] and Z[t] for every time point, and the
+    // time points where RQR[t] changes.  Consecutive time points with
+    // the same matrices share a single SparseEntries entry.  Reports an
+    // error if another series disagrees with series 0 at a time point
+    // where T[t] or Z[t] changes.
+    void record_shared_structure();
+
+    // Filter the series first, ..., last - 1.
+    void filter_batch(int first, int last);
+
+    std::vector<Ptr<StateSpaceModelBase>> series_models_;
+    int state_dimension_;
+    int time_dimension_;
+    int batch_size_;
+
+    std::vector<SparseEntries> transition_matrices_;
+    std::vector<int> transition_index_;
+    std::vector<SparseEntries> observation_vectors_;
+    std::vector<int> observation_index_;
+    std::vector<bool> state_variance_changes_;
+
+    bool store_final_state_variance_;
+    bool store_prediction_errors_;
+    Vector log_likelihood_;
+    Matrix final_state_mean_;
+    std::vector<SpdMatrix> final_state_variance_;
+
+    // Element (t, s) is the result for series s at time t.
+    Matrix prediction_errors_;
+    Matrix forecast_variances_;
+
+    ThreadWorkerPool pool_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_MULTI_SERIES_KALMAN_FILTER_HPP_
@@ -135,6 +135,10 @@ namespace BOOM{
   //     variance of y[t] given Y[t-1], produced by the Kalman filter.
   //   forecast_error: The one step forecast error
   //     y[t] - E(y[t] | Y[t-1]), produced by the Kalman filter.
+  //   workspace: Temporary storage with at least twice as many
+  //     elements as scaled_residual_r.  Its contents on exit are
+  //     unspecified.  Callers running the recursion over many time
+  //     points should allocate it once.
   //
   // Side effects:
   //   This function is called to produce updates of scaled_residual_r
@@ -149,7 +153,8 @@ namespace BOOM{
       const Vector &kalman_gain_K,
       const SparseVector &observation_matrix_Z,
       double forecast_variance,
-      double forecast_error);
+      double forecast_error,
+      VectorView workspace);
 
 }  // namespace BOOM
 #endif// BOOM_SPARSE_KALMAN_TOOLS_HPP
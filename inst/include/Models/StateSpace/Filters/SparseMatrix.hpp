@@ -247,6 +247,11 @@ namespace BOOM{
   //  0  0  0  1 .... 0
   // A row of -1's at the top, then an identity matrix with a column
   // of 0's appended on the right hand side.
+  //
+  // Multiplication by this matrix is a sum and a shift, so the
+  // contribution of a seasonal block of dimension S-1 to T * P * T'
+  // costs O(S * m) for a state of total dimension m, rather than the
+  // O(S^2 * m) needed for a dense block.
   class SeasonalStateSpaceMatrix : public SparseMatrixBlock {
    public:
     SeasonalStateSpaceMatrix(int number_of_seasons);
@@ -260,6 +265,9 @@ namespace BOOM{
     void Tmult(VectorView lhs, const ConstVectorView &rhs) const override;
     // x = (*this) * x;
     void multiply_inplace(VectorView x) const override;
+    // m = m * this->transpose().  Works on whole columns of m, which
+    // are contiguous, rather than on its rows.
+    void matrix_transpose_premultiply_inplace(SubMatrix m) const override;
     void add_to(SubMatrix block) const override;
     Matrix dense() const override;
    private:
@@ -743,6 +751,24 @@ namespace BOOM{
 
     virtual Vector Tmult(const Vector &v) const = 0;
 
+    // The following output-parameter versions of the multiplication
+    // operators write their results into preallocated storage.  The
+    // default implementations call the corresponding Vector-valued
+    // operators and copy the results, so they allocate.  Child
+    // classes used in the Kalman recursions should override them with
+    // allocation-free versions.
+    //
+    // lhs and rhs must not refer to overlapping storage.
+    //
+    // lhs = this * rhs
+    virtual void multiply(VectorView lhs, const ConstVectorView &rhs) const;
+
+    // lhs = this->transpose() * rhs
+    virtual void Tmult(VectorView lhs, const ConstVectorView &rhs) const;
+
+    // Replace x with this * x.  Only works with square matrices.
+    virtual void multiply_inplace(VectorView x) const;
+
     // Replace the argument P with
     //   this * P * this.transpose()
     // This only works with square matrices.  Non-square matrices will throw.
@@ -754,6 +780,12 @@ namespace BOOM{
     // This only works with square matrices.  Non-square matrices will throw.
     virtual void sandwich_inplace_transpose(SpdMatrix &P) const;
 
+    // Same as above, but the temporary storage needed by the
+    // computation is taken from 'workspace', which must have at least
+    // ncol() elements.  Its contents on exit are unspecified.
+    virtual void sandwich_inplace_transpose(SpdMatrix &P,
+                                            VectorView workspace) const;
+
     // Returns *this * P * this->transpose().
     // This is a valid call, even if *this is non-square.
     virtual SpdMatrix sandwich(const SpdMatrix &P) const;
@@ -798,6 +830,13 @@ namespace BOOM{
     Vector operator*(const ConstVectorView &v) const override;
 
     Vector Tmult(const Vector &r) const override;
+
+    void multiply(VectorView lhs, const ConstVectorView &rhs) const override;
+    void Tmult(VectorView lhs, const ConstVectorView &rhs) const override;
+
+    // Requires each block to be square.
+    void multiply_inplace(VectorView x) const override;
+
     // P -> this * P * this.transpose()
     void sandwich_inplace(SpdMatrix &P) const override;
     void sandwich_inplace_submatrix(SubMatrix P) const override;
@@ -71,6 +71,14 @@ namespace BOOM{
     // Replaces m with (m + scale * this * this->transpose()).
     void add_outer_product(SpdMatrix &m, double scale = 1.0) const;
 
+    // Replaces m with
+    //   m + scale * (x * this->transpose() + this * x.transpose()).
+    // Only the rows and columns of m corresponding to nonzero
+    // elements of *this are touched, and nothing is allocated.
+    void add_symmetric_outer_product(SpdMatrix &m,
+                                     const ConstVectorView &x,
+                                     double scale = 1.0) const;
+
     // Returns this.transpose() * P * this, which is sum_{i,j} P(i,j)
     // * this[i] * this[j]
     double sandwich(const SpdMatrix &P)const;
@@ -86,10 +94,16 @@ namespace BOOM{
     int size_;
     void check_index(int n)const;
     friend class SparseVectorReturnProxy;
+    friend void multiply(VectorView ans, const SpdMatrix &P,
+                         const SparseVector &v);
   };
 
   Vector operator*(const SpdMatrix &P, const SparseVector &v);
   Vector operator*(const SubMatrix P, const SparseVector &v);
+
+  // Sets ans = P * v, without allocating.  ans must have P.nrow()
+  // elements.
+  void multiply(VectorView ans, const SpdMatrix &P, const SparseVector &v);
   ostream & operator<<(ostream &, const SparseVector &v);
 
 }  // namespace BOOM
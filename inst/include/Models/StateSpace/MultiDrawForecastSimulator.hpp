@@ -0,0 +1,106 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_STATE_SPACE_MULTI_DRAW_FORECAST_SIMULATOR_HPP_
+#define BOOM_STATE_SPACE_MULTI_DRAW_FORECAST_SIMULATOR_HPP_
+
+#include <functional>
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <Models/StateSpace/StateSpaceModelBase.hpp>
+#include <cpputil/ThreadTools.hpp>
+#include <distributions/rng.hpp>
+
+namespace BOOM {
+  namespace StateSpace {
+
+    // Simulates forecast paths from a state space model for each of a
+    // collection of saved posterior draws of the model parameters and
+    // the final state.
+    //
+    // Forecasting one draw at a time through the model means swapping
+    // each draw's parameters into the model and allocating new vectors
+    // at every time step.  This class divides the draws among a set of
+    // threads.  Each thread works on its own clone of the model, with
+    // its own random number generator and preallocated state buffers,
+    // and writes its forecasts directly into the rows of the result.
+    class MultiDrawForecastSimulator {
+     public:
+      // A function giving the contribution to the forecast mean from
+      // sources other than the state (e.g. a regression), for a model
+      // holding one draw of the parameters.  The function must return
+      // a vector of length 'horizon', and must not modify anything
+      // other than its return value.
+      typedef std::function<Vector(const StateSpaceModelBase &model,
+                                   int horizon)> MeanOffset;
+
+      // Args:
+      //   model: The model to be forecast.  The model is not modified.
+      //     Forecasts start one period after model->time_dimension().
+      //   number_of_threads: The number of threads to use.  If <= 1
+      //     the forecasts are simulated in the calling thread.
+      //   seeding_rng: The random number generator used to seed the
+      //     generators for each thread.
+      explicit MultiDrawForecastSimulator(
+          const StateSpaceModelBase *model,
+          int number_of_threads = 1,
+          RNG &seeding_rng = GlobalRng::rng);
+
+      void set_number_of_threads(int n);
+      void set_mean_offset(const MeanOffset &offset) { mean_offset_ = offset; }
+
+      // Args:
+      //   horizon:  The number of time periods to forecast.
+      //   parameter_draws: Each row is a draw of the model parameters,
+      //     in the order produced by vectorize_params(true).
+      //   final_states: Each row is the corresponding draw of the state
+      //     at the final time point of the training data.
+      // Returns:
+      //   A matrix with a row for each draw and a column for each time
+      //   period in the forecast.
+      Matrix simulate_forecasts(int horizon,
+                                const Matrix &parameter_draws,
+                                const Matrix &final_states);
+
+     private:
+      // Simulate forecasts for draws first, ..., last - 1 using 'model'.
+      void simulate_draws(StateSpaceModelBase &model,
+                          RNG &rng,
+                          int horizon,
+                          const Matrix &parameter_draws,
+                          const Matrix &final_states,
+                          int first,
+                          int last,
+                          Matrix &forecasts) const;
+
+      const StateSpaceModelBase *model_;
+      RNG *seeding_rng_;
+      MeanOffset mean_offset_;
+      ThreadWorkerPool pool_;
+    };
+
+    // Returns a matrix with a row for each element of 'probs' and a
+    // column for each column of 'draws'.  Element (i, j) is the
+    // probs[i] quantile of column j, interpolated linearly between
+    // order statistics (type 7 in R's quantile function).
+    Matrix forecast_quantiles(const Matrix &draws, const Vector &probs);
+
+  }  // namespace StateSpace
+}  // namespace BOOM
+
+#endif  // BOOM_STATE_SPACE_MULTI_DRAW_FORECAST_SIMULATOR_HPP_
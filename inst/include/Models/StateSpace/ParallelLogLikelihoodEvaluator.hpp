@@ -0,0 +1,120 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_STATE_SPACE_PARALLEL_LOG_LIKELIHOOD_EVALUATOR_HPP_
+#define BOOM_STATE_SPACE_PARALLEL_LOG_LIKELIHOOD_EVALUATOR_HPP_
+
+#include <mutex>
+#include <vector>
+#include <LinAlg/Vector.hpp>
+#include <Models/StateSpace/StateSpaceModelBase.hpp>
+#include <cpputil/Ptr.hpp>
+#include <cpputil/ThreadTools.hpp>
+
+namespace BOOM {
+  namespace StateSpaceUtils {
+
+    // Evaluates the log likelihood of a state space model, and its
+    // derivatives, at arbitrary parameter vectors without modifying
+    // the model.
+    //
+    // LogLikelihoodEvaluator swaps the requested parameters into the
+    // model for the duration of each evaluation, so two evaluations
+    // cannot run at the same time.  This class instead evaluates each
+    // parameter vector on a private clone of the model.  Clones are
+    // created on demand and reused, so the cost of cloning is paid
+    // once per thread rather than once per evaluation.  The clones
+    // share the model's data, which is only read during evaluation.
+    //
+    // All the evaluate_* member functions may be called concurrently
+    // from different threads, e.g. by the starting points of a
+    // multi-start optimization.  The versions taking a vector of
+    // parameter vectors divide the work among the evaluator's own
+    // threads.
+    //
+    // The clones reflect the model's data and structure (but not its
+    // parameters) at the time they are made.  If the model's data or
+    // state models change, a new evaluator should be created.
+    class ParallelLogLikelihoodEvaluator {
+     public:
+      // Args:
+      //   model: The model whose log likelihood is to be evaluated.
+      //     The model is not modified, and must outlive the evaluator.
+      //   number_of_threads: The number of threads to use for the
+      //     vectorized evaluate_* functions.  If <= 1 then evaluation
+      //     takes place in the calling thread.
+      explicit ParallelLogLikelihoodEvaluator(
+          const StateSpaceModelBase *model, int number_of_threads = 1);
+
+      void set_number_of_threads(int n);
+
+      // Args:
+      //   parameters: A vector of model parameters in the same order
+      //     as produced by vectorize_params(true).
+      double evaluate_log_likelihood(const Vector &parameters) const;
+
+      // Args:
+      //   parameters: As above.
+      //   gradient: Will be resized and filled with the derivatives of
+      //     log likelihood with respect to the parameters.
+      // Returns:
+      //   The value of log likelihood at the specified parameters.
+      double evaluate_log_likelihood_derivatives(const Vector &parameters,
+                                                 Vector &gradient) const;
+
+      // Evaluate the log likelihood at each element of 'parameters'.
+      Vector evaluate_log_likelihood(
+          const std::vector<Vector> &parameters) const;
+
+      // Evaluate the log likelihood and its gradient at each element of
+      // 'parameters'.  'gradients' is resized to match.
+      Vector evaluate_log_likelihood_derivatives(
+          const std::vector<Vector> &parameters,
+          std::vector<Vector> &gradients) const;
+
+     private:
+      // Remove an idle clone from the pool, creating one if none is
+      // available, and return it to the pool when finished.
+      Ptr<StateSpaceModelBase> checkout_model() const;
+      void return_model(const Ptr<StateSpaceModelBase> &model) const;
+
+      // Holds a checked out clone, and returns it to the pool when it
+      // goes out of scope, even if the evaluation throws.
+      class ModelCheckout {
+       public:
+        explicit ModelCheckout(const ParallelLogLikelihoodEvaluator *owner);
+        ~ModelCheckout();
+        ModelCheckout(const ModelCheckout &rhs) = delete;
+        ModelCheckout &operator=(const ModelCheckout &rhs) = delete;
+        StateSpaceModelBase *operator->() const { return model_.get(); }
+
+       private:
+        const ParallelLogLikelihoodEvaluator *owner_;
+        Ptr<StateSpaceModelBase> model_;
+      };
+
+      const StateSpaceModelBase *model_;
+      mutable std::mutex mutex_;
+      mutable std::vector<Ptr<StateSpaceModelBase>> idle_models_;
+      mutable ThreadWorkerPool pool_;
+    };
+
+  }  // namespace StateSpaceUtils
+}  // namespace BOOM
+
+#endif  // BOOM_STATE_SPACE_PARALLEL_LOG_LIKELIHOOD_EVALUATOR_HPP_
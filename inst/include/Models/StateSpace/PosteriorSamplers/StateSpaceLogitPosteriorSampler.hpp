@@ -21,12 +21,14 @@
 
 #include <Models/StateSpace/StateSpaceLogitModel.hpp>
 #include <Models/StateSpace/PosteriorSamplers/StateSpacePosteriorSampler.hpp>
+#include <Models/StateSpace/PosteriorSamplers/TimeSeriesImputeWorker.hpp>
 #include <Models/Glm/PosteriorSamplers/BinomialLogitSpikeSlabSampler.hpp>
 #include <Models/Glm/PosteriorSamplers/BinomialLogitDataImputer.hpp>
 
 namespace BOOM {
   class StateSpaceLogitPosteriorSampler
-      : public StateSpacePosteriorSampler {
+      : public StateSpacePosteriorSampler,
+        public LatentDataSampler<StateSpace::TimeSeriesImputeWorker> {
    public:
 
     // Args:
@@ -51,6 +53,13 @@ namespace BOOM {
     // parameters.
     void impute_nonstate_latent_data() override;
 
+    // Overrides for LatentDataSampler.  Use set_number_of_workers() to
+    // impute the latent data in parallel.
+    Ptr<StateSpace::TimeSeriesImputeWorker> create_worker(
+        std::mutex &m) override;
+    void clear_latent_data() override {}
+    void assign_data_to_workers() override;
+
     // Clear the complete_data_sufficient_statistics for the logistic
     // regression model.
     void clear_complete_data_sufficient_statistics();
@@ -63,6 +72,15 @@ namespace BOOM {
     void update_complete_data_sufficient_statistics(int t);
 
    private:
+    // Impute the latent Gaussians and their precisions for the observations at time t.  This is
+    // the work done by each TimeSeriesImputeWorker, so it must only
+    // modify data at time t.
+    void impute_latent_data_at_time(int t, RNG &rng);
+
+    // The state contribution to each observation, computed by
+    // impute_nonstate_latent_data() before the workers run.
+    Vector state_means_;
+
     StateSpaceLogitModel *model_;
     Ptr<BinomialLogitSpikeSlabSampler> observation_model_sampler_;
     BinomialLogitCltDataImputer data_imputer_;
@@ -21,12 +21,14 @@
 
 #include <Models/StateSpace/StateSpacePoissonModel.hpp>
 #include <Models/StateSpace/PosteriorSamplers/StateSpacePosteriorSampler.hpp>
+#include <Models/StateSpace/PosteriorSamplers/TimeSeriesImputeWorker.hpp>
 #include <Models/Glm/PosteriorSamplers/PoissonRegressionSpikeSlabSampler.hpp>
 #include <Models/Glm/PosteriorSamplers/PoissonDataImputer.hpp>
 
 namespace BOOM {
   class StateSpacePoissonPosteriorSampler
-      : public StateSpacePosteriorSampler {
+      : public StateSpacePosteriorSampler,
+        public LatentDataSampler<StateSpace::TimeSeriesImputeWorker> {
    public:
 
     // Args:
@@ -46,9 +48,18 @@ namespace BOOM {
         RNG &seeding_rng = GlobalRng::rng);
 
     // Impute the latent Gaussian observations and variances at each
-    // data point.
+    // data point.  The first call is single threaded, because it may
+    // add entries to the mixture table shared by all
+    // PoissonDataImputer objects.
     void impute_nonstate_latent_data() override;
 
+    // Overrides for LatentDataSampler.  Use set_number_of_workers() to
+    // impute the latent data in parallel.
+    Ptr<StateSpace::TimeSeriesImputeWorker> create_worker(
+        std::mutex &m) override;
+    void clear_latent_data() override {}
+    void assign_data_to_workers() override;
+
     // Clear the complete_data_sufficient_statistics for the Poisson
     // regression model.
     void clear_complete_data_sufficient_statistics();
@@ -61,9 +72,22 @@ namespace BOOM {
     void update_complete_data_sufficient_statistics(int t);
 
    private:
+    // Impute the latent Gaussians and their precisions for the observations at time t.  This is
+    // the work done by each TimeSeriesImputeWorker, so it must only
+    // modify data at time t.
+    void impute_latent_data_at_time(int t, RNG &rng);
+
+    // The state contribution to each observation, computed by
+    // impute_nonstate_latent_data() before the workers run.
+    Vector state_means_;
+
     StateSpacePoissonModel *model_;
     Ptr<PoissonRegressionSpikeSlabSampler> observation_model_sampler_;
     PoissonDataImputer data_imputer_;
+
+    // Set once the latent data have been imputed a single time, after
+    // which the shared mixture table is safe to use from many threads.
+    bool mixture_table_is_initialized_;
   };
 }
 
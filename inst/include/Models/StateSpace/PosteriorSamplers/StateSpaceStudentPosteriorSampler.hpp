@@ -22,12 +22,14 @@
 #include <Models/Glm/WeightedRegressionModel.hpp>
 #include <Models/StateSpace/StateSpaceStudentRegressionModel.hpp>
 #include <Models/StateSpace/PosteriorSamplers/StateSpacePosteriorSampler.hpp>
+#include <Models/StateSpace/PosteriorSamplers/TimeSeriesImputeWorker.hpp>
 #include <Models/Glm/PosteriorSamplers/TRegressionSpikeSlabSampler.hpp>
 
 namespace BOOM {
 
   class StateSpaceStudentPosteriorSampler
-      : public StateSpacePosteriorSampler {
+      : public StateSpacePosteriorSampler,
+        public LatentDataSampler<StateSpace::TimeSeriesImputeWorker> {
    public:
     StateSpaceStudentPosteriorSampler(
         StateSpaceStudentRegressionModel *model,
@@ -37,6 +39,13 @@ namespace BOOM {
     // Impute the latent variances at each data point.
     void impute_nonstate_latent_data() override;
 
+    // Overrides for LatentDataSampler.  Use set_number_of_workers() to
+    // impute the latent data in parallel.
+    Ptr<StateSpace::TimeSeriesImputeWorker> create_worker(
+        std::mutex &m) override;
+    void clear_latent_data() override {}
+    void assign_data_to_workers() override;
+
     // Clear the complete_data_sufficient_statistics for the weighted
     // regression model.
     void clear_complete_data_sufficient_statistics();
@@ -49,6 +58,15 @@ namespace BOOM {
     void update_complete_data_sufficient_statistics(int t);
 
    private:
+    // Impute the latent weights for the observations at time t.  This is
+    // the work done by each TimeSeriesImputeWorker, so it must only
+    // modify data at time t.
+    void impute_latent_data_at_time(int t, RNG &rng);
+
+    // The state contribution to each observation, computed by
+    // impute_nonstate_latent_data() before the workers run.
+    Vector state_means_;
+
     StateSpaceStudentRegressionModel *model_;
     Ptr<TRegressionSpikeSlabSampler> observation_model_sampler_;
     TDataImputer data_imputer_;
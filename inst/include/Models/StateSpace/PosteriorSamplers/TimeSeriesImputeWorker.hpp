@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_STATE_SPACE_TIME_SERIES_IMPUTE_WORKER_HPP_
+#define BOOM_STATE_SPACE_TIME_SERIES_IMPUTE_WORKER_HPP_
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <Models/PosteriorSamplers/Imputer.hpp>
+#include <Models/StateSpace/StateSpaceModelBase.hpp>
+#include <LinAlg/Vector.hpp>
+#include <distributions/rng.hpp>
+
+namespace BOOM {
+  namespace StateSpace {
+
+    // A LatentDataImputerWorker that imputes the non-state latent data
+    // (e.g. the latent Gaussians in a logit or Poisson model) for a
+    // contiguous block of time points in a state space model.
+    //
+    // Given the state and the model parameters the latent data at
+    // different time points are conditionally independent, so blocks
+    // can be imputed in parallel.  The imputation for a single time
+    // point is a callback supplied by the posterior sampler that owns
+    // the worker.  The imputed values are stored in the model's data
+    // points, each of which is owned by a single worker, so there is
+    // nothing to combine afterwards.  The complete data sufficient
+    // statistics are accumulated when the state is imputed.
+    class TimeSeriesImputeWorker : public LatentDataImputerWorker {
+     public:
+      // Args:
+      //   impute: impute(t, rng) imputes the latent data for time
+      //     point t.  It must not write to anything shared with other
+      //     time points.
+      //   mutex:  Passed to the LatentDataImputerWorker base class.
+      //   rng: A random number generator, or nullptr.  If nullptr then
+      //     the worker creates its own RNG.
+      //   seeding_rng: If a new random number generator must be
+      //     created, then this RNG will be used to seed it.
+      TimeSeriesImputeWorker(const std::function<void(int, RNG &)> &impute,
+                             std::mutex &mutex,
+                             RNG *rng = nullptr,
+                             RNG &seeding_rng = GlobalRng::rng)
+          : LatentDataImputerWorker(mutex),
+            impute_(impute),
+            begin_(0),
+            end_(0)
+      {
+        if (!rng) {
+          rng_storage_.reset(new RNG(seed_rng(seeding_rng)));
+          rng_ = rng_storage_.get();
+        } else {
+          rng_ = rng;
+        }
+      }
+
+      // Assign this worker the time points begin, ..., end - 1.
+      void set_time_range(int begin, int end) {
+        begin_ = begin;
+        end_ = end;
+      }
+
+      void impute_latent_data() override {
+        for (int t = begin_; t < end_; ++t) {
+          impute_(t, *rng_);
+        }
+      }
+
+      void combine_complete_data() override {}
+
+     private:
+      std::function<void(int, RNG &)> impute_;
+      int begin_;
+      int end_;
+      RNG *rng_;
+      std::unique_ptr<RNG> rng_storage_;
+    };
+
+    // Divide the time points in 'data' among the workers in contiguous
+    // blocks, so that each worker gets about the same number of
+    // observations.  DATA can be any of the multiplexed data types with
+    // a sample_size() method.
+    template <class DATA>
+    void assign_time_points_to_workers(
+        const std::vector<Ptr<DATA>> &data,
+        std::vector<Ptr<TimeSeriesImputeWorker>> &workers) {
+      int number_of_workers = workers.size();
+      if (number_of_workers == 0) return;
+      double total_sample_size = 0;
+      for (int t = 0; t < data.size(); ++t) {
+        total_sample_size += data[t]->sample_size();
+      }
+      double target = total_sample_size / number_of_workers;
+      int begin = 0;
+      int worker = 0;
+      double cumulative_sample_size = 0;
+      for (int t = 0; t < data.size(); ++t) {
+        cumulative_sample_size += data[t]->sample_size();
+        if (cumulative_sample_size >= (worker + 1) * target
+            && worker + 1 < number_of_workers) {
+          workers[worker++]->set_time_range(begin, t + 1);
+          begin = t + 1;
+        }
+      }
+      workers[worker++]->set_time_range(begin, data.size());
+      for (; worker < number_of_workers; ++worker) {
+        workers[worker]->set_time_range(data.size(), data.size());
+      }
+    }
+
+    // Returns the state contribution Z[t]' * alpha[t] to the mean of
+    // the observations at each time point t.  Workers should read these
+    // values rather than call observation_matrix(), because some state
+    // models (e.g. holidays) fill lookup tables on demand there.
+    inline Vector state_means(const StateSpaceModelBase &model) {
+      Vector ans(model.time_dimension());
+      for (int t = 0; t < ans.size(); ++t) {
+        ans[t] = model.observation_matrix(t).dot(model.state(t));
+      }
+      return ans;
+    }
+
+  }  // namespace StateSpace
+}  // namespace BOOM
+
+#endif  // BOOM_STATE_SPACE_TIME_SERIES_IMPUTE_WORKER_HPP_
@@ -0,0 +1,137 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_STATE_SPACE_REGRESSION_PREDICTION_CACHE_HPP_
+#define BOOM_STATE_SPACE_REGRESSION_PREDICTION_CACHE_HPP_
+
+#include <functional>
+#include <vector>
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/Vector.hpp>
+#include <LinAlg/VectorView.hpp>
+#include <Models/Glm/GlmCoefs.hpp>
+#include <cpputil/Ptr.hpp>
+
+namespace BOOM {
+  namespace StateSpace {
+
+    // Stores the regression contribution x * beta for every
+    // observation in a state space model with a regression component,
+    // so that the Kalman filter can obtain adjusted observations
+    // without recomputing x * beta on each pass through the data.
+    //
+    // The predictors from all time points are stacked into a single
+    // design matrix, so refreshing the predictions is a single
+    // matrix-vector multiplication.  The owning model calls observe()
+    // so that the predictions are invalidated when the coefficients
+    // change (GlmCoefs signals changes to both the coefficient values
+    // and the set of included coefficients), and the design is
+    // cleared when data are added or removed.  Writing through the
+    // non-const GlmCoefs::Beta(i) does not signal, so callers doing so
+    // must invalidate the cache.
+    //
+    // The cache is not thread safe.  predictions() fills the cache
+    // lazily, and owning models call it from const member functions,
+    // so concurrent const calls on the same model race.  Use a
+    // separate clone of the model in each thread.
+    class RegressionPredictionCache {
+     public:
+      RegressionPredictionCache();
+
+      // Discard the design matrix and the predictions.
+      void clear_design() {
+        design_is_current_ = false;
+        predictions_are_current_ = false;
+      }
+
+      // Mark the predictions as out of date, e.g. because the
+      // regression coefficients have changed.
+      void invalidate_predictions() { predictions_are_current_ = false; }
+
+      bool design_is_current() const { return design_is_current_; }
+
+      // Keep the cache current by observing the owning model.
+      // Args:
+      //   coefficients: The regression coefficients.  Changes to them
+      //     invalidate the predictions.
+      //   data_policy: The owning model's IID_DataPolicy.  Adding or
+      //     removing data clears the design.
+      template <class DATA_POLICY>
+      void observe(const Ptr<GlmCoefs> &coefficients,
+                   DATA_POLICY &data_policy) {
+        coefficients->add_observer([this]() {this->invalidate_predictions();});
+        data_policy.add_observer([this]() {this->clear_design();});
+      }
+
+      // Build the design matrix.
+      // Args:
+      //   sample_sizes: The number of observations at each time point.
+      //   predictors: predictors(t, i) returns the vector of predictors
+      //     for observation i at time t.
+      void set_design(
+          const std::vector<int> &sample_sizes,
+          const std::function<const Vector &(int, int)> &predictors);
+
+      // Returns x * beta for each observation at time t, recomputing
+      // the predictions for all time points if they are out of date.
+      // The design must be current.
+      ConstVectorView predictions(int t, const GlmCoefs &coefficients);
+
+      // As above, but the design is first built from 'data' if it is
+      // not current.
+      // Args:
+      //   t: The time point whose predictions are desired.
+      //   data: The owning model's data, with one element per time
+      //     point.  DATA must have a sample_size() member.
+      //   predictors: predictors(data[t], i) returns the vector of
+      //     predictors for observation i at time t.
+      //   coefficients: The regression coefficients.
+      template <class DATA, class PREDICTORS>
+      ConstVectorView predictions(int t,
+                                  const std::vector<Ptr<DATA>> &data,
+                                  const PREDICTORS &predictors,
+                                  const GlmCoefs &coefficients) {
+        if (!design_is_current_) {
+          std::vector<int> sample_sizes(data.size());
+          for (int s = 0; s < data.size(); ++s) {
+            sample_sizes[s] = data[s]->sample_size();
+          }
+          set_design(sample_sizes,
+                     [&data, &predictors](int s, int i) -> const Vector & {
+                       return predictors(*data[s], i);
+                     });
+        }
+        return predictions(t, coefficients);
+      }
+
+     private:
+      Matrix design_;
+
+      // The observations at time t occupy rows row_start_[t] through
+      // row_start_[t + 1] - 1 of design_.
+      std::vector<int> row_start_;
+
+      Vector predictions_;
+      bool design_is_current_;
+      bool predictions_are_current_;
+    };
+
+  }  // namespace StateSpace
+}  // namespace BOOM
+
+#endif  // BOOM_STATE_SPACE_REGRESSION_PREDICTION_CACHE_HPP_
@@ -20,6 +20,7 @@
 #define BOOM_HOLIDAY_HPP_
 
 #include <map>
+#include <mutex>
 #include <cpputil/Date.hpp>
 
 namespace BOOM{
@@ -64,6 +65,11 @@ namespace BOOM{
 
     // Indicates whether this holiday is active on the given date.
     virtual bool active(const Date &arbitrary_date)const;
+
+    // If the holiday is active on the given date, returns the number
+    // of days since the start of the influence window containing it.
+    // Otherwise returns -1.
+    int window_position(const Date &arbitrary_date)const;
   };
 
   // A factory function that will create a holiday based on its name.
@@ -109,6 +115,10 @@ namespace BOOM{
     int days_before_;
     int days_after_;
     typedef int Year;
+    // The lookup tables are filled on demand.  A holiday can be shared
+    // by clones of a state model running in different threads, so
+    // access to the tables is guarded by a mutex.
+    mutable std::mutex table_mutex_;
     mutable std::map<Year, Date> date_lookup_table_;
     mutable std::map<Year, Date> earliest_influence_by_year_;
     mutable std::map<Year, Date> latest_influence_by_year_;
@@ -37,7 +37,7 @@ namespace BOOM{
 
     uint state_dimension() const override;
     uint state_error_dimension() const override {return 1;}
-    void simulate_state_error(VectorView eta, int t)const override;
+    void simulate_state_error(RNG &rng, VectorView eta, int t) const override;
     void simulate_initial_state(VectorView eta)const override;
 
     Ptr<SparseMatrixBlock> state_transition_matrix(int t) const override;
@@ -20,6 +20,7 @@
 #define BOOM_RANDOM_WALK_HOLIDAY_STATE_MODEL_HPP_
 
 #include <memory>
+#include <vector>
 #include <cpputil/Date.hpp>
 #include <Models/StateSpace/StateModels/StateModel.hpp>
 #include <Models/ZeroMeanGaussianModel.hpp>
@@ -48,6 +49,12 @@ namespace BOOM {
   // the holiday influences).  The transition matrix is always the
   // identity.  The error variance matrix is sigma^2 * outer(e[t]),
   // where e[t] is column t of the identity matrix.
+  //
+  // Whether t is in the holiday window, and where, is looked up in a
+  // table indexed by t that is filled from the holiday calendar the
+  // first time each t is requested.  The table is discarded when
+  // time_zero changes, so the calendar computations are done once per
+  // time point rather than on every pass of the Kalman filter.
   class RandomWalkHolidayStateModel :
       public StateModel,
       public ZeroMeanGaussianModel{
@@ -59,16 +66,20 @@ namespace BOOM {
     //   time_zero: The date at t = 0, where t is an integer number of
     //     days.
     RandomWalkHolidayStateModel(Holiday *holiday, const Date &time_zero);
+    RandomWalkHolidayStateModel(const RandomWalkHolidayStateModel &rhs);
     RandomWalkHolidayStateModel * clone() const override;
     void observe_state(const ConstVectorView then,
                        const ConstVectorView now,
                        int time_now) override;
 
+    // Fills the window position table for times 0, ..., max_time - 1.
+    void observe_time_dimension(int max_time) override;
+
     uint state_dimension() const override;
     uint state_error_dimension() const override {
       return 1;
     }
-    void simulate_state_error(VectorView eta, int t) const override;
+    void simulate_state_error(RNG &rng, VectorView eta, int t) const override;
 
     Ptr<SparseMatrixBlock> state_transition_matrix(int t) const override;
     Ptr<SparseMatrixBlock> state_variance_matrix(int t) const override;
@@ -88,6 +99,20 @@ namespace BOOM {
     void set_time_zero(const Date &time_zero);
 
    private:
+    // Returns the position of time t in the holiday window (the number
+    // of days since the start of the window), or -1 if the holiday is
+    // not active at time t.
+    int window_position(int t) const;
+
+    // Extend window_position_table_ so that it covers at least the
+    // times 0, ..., size - 1.
+    void extend_window_position_table(int size) const;
+
+    // Create the variance matrices used when the holiday is active.
+    // They are views of Sigsq_prm(), so they must be rebuilt when the
+    // model is copied.
+    void build_active_state_variance_matrices();
+
     // TODO(stevescott): Make this a unique_ptr once available.
     std::shared_ptr<Holiday> holiday_;
     Date time_zero_;
@@ -98,6 +123,9 @@ namespace BOOM {
 
     std::vector<Ptr<SingleSparseDiagonalElementMatrixParamView> >
     active_state_variance_matrix_;
+
+    // Element t is window_position(t), for t = 0, ..., size() - 1.
+    mutable std::vector<int> window_position_table_;
   };
 
 }  // namespace BOOM
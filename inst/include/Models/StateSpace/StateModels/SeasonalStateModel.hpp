@@ -26,6 +26,16 @@
 namespace BOOM{
 
   // StateModel for describing evolving seasonal effects.
+  //
+  // The state for this model has dimension nseasons - 1.  The
+  // transition matrix is a SeasonalStateSpaceMatrix, so each Kalman
+  // filter step costs O(nseasons * m), where m is the total state
+  // dimension, plus the O(m^2) cost of the state variance update that
+  // any state model pays.  With a long cycle (e.g. a day-of-year effect
+  // with nseasons = 365) the O(m^2) term dominates.  In that case a
+  // TrigStateModel using a few low frequency harmonics of the same
+  // period is usually a much cheaper description of a smooth seasonal
+  // pattern.
   class SeasonalStateModel
       : public ZeroMeanGaussianModel,
         public StateModel
@@ -51,7 +61,7 @@ namespace BOOM{
                        int t) override;
     uint state_dimension() const override;
     uint state_error_dimension() const override {return 1;}
-    void simulate_state_error(VectorView eta, int t) const override;
+    void simulate_state_error(RNG &rng, VectorView eta, int t) const override;
 
     Ptr<SparseMatrixBlock> state_transition_matrix(int t) const override;
     Ptr<SparseMatrixBlock> state_variance_matrix(int t) const override;
@@ -22,6 +22,7 @@
 #include <LinAlg/VectorView.hpp>
 #include <Models/StateSpace/Filters/SparseVector.hpp>
 #include <Models/StateSpace/Filters/SparseMatrix.hpp>
+#include <distributions/rng.hpp>
 #include <uint.hpp>
 
 namespace BOOM{
@@ -104,8 +105,10 @@ namespace BOOM{
         const ConstVectorView &state_error_mean,
         const ConstSubMatrix &state_error_variance);
 
-    // Simulates the state eror at time t, for moving to time t+1.
-    virtual void simulate_state_error(VectorView eta, int t) const = 0;
+    // Simulates the state eror at time t, for moving to time t+1,
+    // using the supplied random number generator.
+    virtual void simulate_state_error(
+        RNG &rng, VectorView eta, int t) const = 0;
     virtual void simulate_initial_state(VectorView eta) const;
 
     virtual Ptr<SparseMatrixBlock> state_transition_matrix(int t) const = 0;
@@ -37,6 +37,16 @@ namespace BOOM {
   //   T[t]     = Identity matrix.
   //   Q[t]     = diagonal variance matrix for the changes in the
   //              coefficients.
+  //
+  // With frequencies 1, 2, ..., k and an integer period S this is a
+  // reduced rank version of SeasonalStateModel(S): using every
+  // harmonic up to S / 2 spans the same set of seasonal patterns as
+  // the S - 1 dimensional seasonal state.  The state dimension is 2k
+  // and T[t] is the identity, so a Kalman filter step costs O(k * m)
+  // for a state of total dimension m, plus the O(m^2) state variance
+  // update.  A handful of harmonics is enough to model a smooth annual
+  // cycle in daily data, where the equivalent seasonal model would
+  // have 364 state elements.
   class TrigStateModel
       : public StateModel,
         public IndependentMvnModel {
@@ -61,7 +71,7 @@ namespace BOOM {
         const ConstVectorView &state_error_mean,
         const ConstSubMatrix &state_error_variance) override;
 
-    void simulate_state_error(VectorView eta, int t) const override;
+    void simulate_state_error(RNG &rng, VectorView eta, int t) const override;
 
     Ptr<SparseMatrixBlock> state_transition_matrix(int t) const override {
       return state_transition_matrix_;
@@ -20,6 +20,7 @@
 #define BOOM_STATE_SPACE_LOGIT_MODEL_HPP_
 
 #include <Models/StateSpace/StateSpaceNormalMixture.hpp>
+#include <Models/StateSpace/RegressionPredictionCache.hpp>
 #include <Models/Policies/IID_DataPolicy.hpp>
 #include <Models/Policies/PriorPolicy.hpp>
 #include <Models/Glm/BinomialLogitModel.hpp>
@@ -93,6 +94,9 @@ namespace BOOM {
       double latent_data_variance(int observation) const;
       double latent_data_value(int observation) const;
       double adjusted_observation(const GlmCoefs &coefficients) const;
+      // The same as adjusted_observation(coefficients), but with x * beta
+      // for each observation supplied by 'predictions'.
+      double adjusted_observation(const ConstVectorView &predictions) const;
       double latent_data_overall_variance() const;
 
       void set_state_model_offset(double offset);
@@ -221,6 +225,14 @@ namespace BOOM {
     // filter if the parameters change values.
     void setup();
 
+    // Returns x * beta for each observation at time t, using
+    // prediction_cache_.
+    ConstVectorView regression_predictions(int t) const;
+
+    // Holds x * beta for every observation.  Invalidated by observers
+    // on the regression coefficients and on the data.
+    mutable StateSpace::RegressionPredictionCache prediction_cache_;
+
     Ptr<BinomialLogitModel> observation_model_;
   };
 
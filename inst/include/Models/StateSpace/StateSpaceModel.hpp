@@ -82,6 +82,26 @@ namespace BOOM{
     // state.
     Vector simulate_forecast(int n, const Vector &final_state);
 
+    // Simulate the next 'horizon' time periods for each of a set of
+    // saved posterior draws.  The model's parameters are not changed.
+    // Args:
+    //   horizon:  The number of time periods to forecast.
+    //   parameter_draws: Each row is a draw of the model parameters, in
+    //     the order produced by vectorize_params(true).
+    //   final_states: Each row is the corresponding draw of the state
+    //     at the last time point in the training data.
+    //   number_of_threads: The number of threads to use.
+    //   quantiles: If nonempty, the forecast quantiles corresponding
+    //     to these probabilities are returned instead of the draws.
+    // Returns:
+    //   A matrix with a row for each draw (or each element of
+    //   'quantiles') and a column for each time period.
+    Matrix simulate_forecasts(int horizon,
+                              const Matrix &parameter_draws,
+                              const Matrix &final_states,
+                              int number_of_threads = 1,
+                              const Vector &quantiles = Vector()) const;
+
     // Simulate the next n time periods given current parameters and a
     // specified set of observed data.  Uses negative_infinity() as a
     // signal for missing data.
@@ -232,6 +232,12 @@ namespace BOOM{
     // Args:
     //   parameters: The vector of model parameters in the same order
     //     as produced by vectorize_params(true).
+    //
+    // The evaluation takes place on a private clone of the model, so
+    // the model is not modified and this function may be called from
+    // several threads at once.  Callers evaluating many parameter
+    // vectors should use StateSpaceUtils::ParallelLogLikelihoodEvaluator
+    // directly, which reuses its clones.
     double log_likelihood(const Vector &parameters) const;
 
     // Evaluate the log likelihood function and its derivatives as a
@@ -245,6 +251,9 @@ namespace BOOM{
     //     intialized to zero.
     // Returns:
     //   The value of log likelihood at the specified parameters.
+    //
+    // Like log_likelihood(parameters), this evaluates a private clone
+    // of the model, so it may be called from several threads at once.
     double log_likelihood_derivatives(const Vector &parameters,
                                       Vector &gradient) const;
 
@@ -283,14 +292,29 @@ namespace BOOM{
                              int t) const;
     Vector simulate_next_state(const Vector &current_state, int t) const;
 
+    // As above, but using the supplied random number generator, so that
+    // independent simulations can run in parallel.
+    void simulate_next_state(RNG &rng,
+                             const ConstVectorView last,
+                             VectorView next,
+                             int t) const;
+
     // Simulates the error for the state at time t+1.  (Using the
     // notation of Durbin and Koopman, this uses the model matrices
     // indexed as t.)
     //
-    // Returns a vector of size state_dimension().  If the model
-    // matrices are not full rank then some elements of this vector
-    // will be deterministic functions of other elements.
-    virtual Vector simulate_state_error(int t) const;
+    // Args:
+    //   rng:  The random number generator to use for the simulation.
+    //   eta: A vector of size state_dimension() that will be filled
+    //     with the simulated error.  If the model matrices are not
+    //     full rank then some elements of eta will be deterministic
+    //     functions of other elements.
+    //   t:  The time index of the error.
+    virtual void simulate_state_error(RNG &rng, VectorView eta, int t) const;
+
+    // Returns a vector of size state_dimension(), simulated using the
+    // global random number generator.
+    Vector simulate_state_error(int t) const;
 
     //------- Accessors for getting at state comopnents -----------
     ConstVectorView final_state() const;
@@ -507,7 +531,6 @@ namespace BOOM{
     void initialize_final_kalman_storage() const;
     void kalman_filter_is_not_current() {
       kalman_filter_is_current_ = false;
-      mcmc_kalman_storage_is_current_ = false;
     }
 
     // A helper function used to implement average_over_latent_data().
@@ -562,7 +585,8 @@ namespace BOOM{
 
     // Simulate fake data from the model, given current model
     // parameters, as part of Durbin and Koopman's state-simulation
-    // algorithm.
+    // algorithm, and run the Kalman filter on the difference between
+    // the observed and simulated data.
     void simulate_forward();
 
     double simulate_adjusted_observation(int t);
@@ -577,9 +601,11 @@ namespace BOOM{
     //   Durbin and Koopman's r0.
     Vector smooth_disturbances_fast(std::vector<LightKalmanStorage> &filter);
 
-    void propagate_disturbances(const Vector &r0_plus,
-                                const Vector &r0_hat,
-                                bool observe = true);
+    // Add E(alpha | y - y_+) to the simulated state, given the output
+    // of smooth_disturbances_fast().  If 'observe' is true then the
+    // state models and observation model are notified of the new
+    // state.
+    void propagate_disturbances(const Vector &r0, bool observe = true);
 
     //----------------------------------------------------------------------
     // data starts here
@@ -627,13 +653,6 @@ namespace BOOM{
     // state_is_fixed_ is for use in debugging.  If it is set then the
     // state will be held constant in the data imputation.
     bool state_is_fixed_;
-    bool mcmc_kalman_storage_is_current_;
-
-    // Supplemental storage is for filtering simulated observations
-    // for Durbin and Koopman's simulation smoother.
-    Vector supplemental_a_;
-    SpdMatrix supplemental_P_;
-    std::vector<LightKalmanStorage> supplemental_kalman_storage_;
 
     // final_kalman_storage_ holds the output of the Kalman filter.
     // It is for situations where we don't need to store the whole
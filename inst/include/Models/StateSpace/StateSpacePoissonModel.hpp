@@ -20,6 +20,7 @@
 #define BOOM_STATE_SPACE_POISSON_MODEL_HPP_
 
 #include <Models/StateSpace/StateSpaceNormalMixture.hpp>
+#include <Models/StateSpace/RegressionPredictionCache.hpp>
 #include <Models/Policies/IID_DataPolicy.hpp>
 #include <Models/Policies/PriorPolicy.hpp>
 #include <Models/Glm/PoissonRegressionModel.hpp>
@@ -120,6 +121,9 @@ namespace BOOM {
       double latent_data_value(int observation) const;
 
       double adjusted_observation(const GlmCoefs &coefficients) const;
+      // The same as adjusted_observation(coefficients), but with x * beta
+      // for each observation supplied by 'predictions'.
+      double adjusted_observation(const ConstVectorView &predictions) const;
       double latent_data_overall_variance() const;
 
       void set_state_model_offset(double offset);
@@ -206,6 +210,19 @@ namespace BOOM {
         const Vector &final_state);
 
    private:
+    // Sets observers on the model parameters and the data, so that the
+    // Kalman filter and prediction_cache_ are invalidated when they
+    // change.
+    void setup();
+
+    // Returns x * beta for each observation at time t, using
+    // prediction_cache_.
+    ConstVectorView regression_predictions(int t) const;
+
+    // Holds x * beta for every observation.  Invalidated by observers
+    // on the regression coefficients and on the data.
+    mutable StateSpace::RegressionPredictionCache prediction_cache_;
+
     Ptr<PoissonRegressionModel> observation_model_;
   };
 
@@ -19,6 +19,7 @@
 #define BOOM_STATE_SPACE_REGRESSION_HPP_
 
 #include <Models/StateSpace/StateSpaceModelBase.hpp>
+#include <Models/StateSpace/RegressionPredictionCache.hpp>
 #include <Models/StateSpace/StateModels/StateModel.hpp>
 #include <Models/StateSpace/Filters/SparseVector.hpp>
 #include <Models/StateSpace/Filters/SparseMatrix.hpp>
@@ -49,6 +50,9 @@ namespace BOOM{
       void add_data(Ptr<RegressionData> dp) {regression_data_.push_back(dp);}
 
       double adjusted_observation(const GlmCoefs &coefficients) const;
+      // The same as adjusted_observation(coefficients), but with x * beta
+      // for each observation supplied by 'predictions'.
+      double adjusted_observation(const ConstVectorView &predictions) const;
       int sample_size() const {return regression_data_.size();}
       const RegressionData &regression_data(int i) const;
       Ptr<RegressionData> regression_data_ptr(int i);
@@ -103,6 +107,13 @@ namespace BOOM{
 
     void observe_data_given_state(int t) override;
 
+    // Clears the complete data sufficient statistics.  The summaries
+    // of the predictors are refreshed if the missing status of any
+    // time point has changed since they were computed, and the
+    // summaries involving the responses are recomputed, so that
+    // responses modified in place are picked up.
+    void clear_client_data() override;
+
     // Forecast the next nrow(newX) time steps given the current data,
     // using the Kalman filter.  The first column of Matrix is the mean
     // of the forecast.  The second column is the standard errors.
@@ -113,6 +124,27 @@ namespace BOOM{
     Vector simulate_forecast(const Matrix &newX, const Vector &final_state);
     Vector simulate_forecast(const Matrix &newX);
 
+    // Simulate the next nrow(newX) time periods for each of a set of
+    // saved posterior draws.  The model's parameters are not changed.
+    // Args:
+    //   newX: The predictors for the forecast period, with one row per
+    //     time period.
+    //   parameter_draws: Each row is a draw of the model parameters, in
+    //     the order produced by vectorize_params(true).
+    //   final_states: Each row is the corresponding draw of the state
+    //     at the last time point in the training data.
+    //   number_of_threads: The number of threads to use.
+    //   quantiles: If nonempty, the forecast quantiles corresponding
+    //     to these probabilities are returned instead of the draws.
+    // Returns:
+    //   A matrix with a row for each draw (or each element of
+    //   'quantiles') and a column for each time period.
+    Matrix simulate_forecasts(const Matrix &newX,
+                              const Matrix &parameter_draws,
+                              const Matrix &final_states,
+                              int number_of_threads = 1,
+                              const Vector &quantiles = Vector()) const;
+
     // Contribution of the regression model to the overall mean of y at each
     // time point.  In the case of multiplexed data, the average regression
     // contribution for each time point is computed (averaging across
@@ -146,6 +178,51 @@ namespace BOOM{
 
     // Initialization work common to several constructors
     void setup();
+
+    // Mark data_summaries_ as stale, and release the xtx matrix in the
+    // regression model's sufficient statistics, which will be fixed
+    // again when the summaries are refreshed.
+    void invalidate_data_summaries();
+
+    // Returns x * beta for each observation at time t, using
+    // prediction_cache_.
+    ConstVectorView regression_predictions(int t) const;
+
+    // Holds x * beta for every observation.  Invalidated by observers
+    // on the regression coefficients and on the data.
+    mutable StateSpace::RegressionPredictionCache prediction_cache_;
+
+    // Recompute data_summaries_, and fix the xtx matrix in the
+    // regression model's sufficient statistics at the cross product of
+    // the predictors from the non-missing time points.
+    void refresh_data_summaries();
+
+    // Recompute the xty, yty, and ysum elements of data_summaries_,
+    // which must already be sized to match the data.  This is
+    // O(n * xdim), cheaper than refreshing xtx.
+    void refresh_response_summaries();
+
+    // Summaries of the regression data at a single time point.  The
+    // state contributes a common offset to each response at time t,
+    // so given these summaries (and a fixed xtx) the complete data
+    // sufficient statistics can be updated in O(xdim) per time point.
+    struct DataSummary {
+      Vector xty;      // X'y
+      Vector x_sums;   // X'1
+      double yty;      // y'y
+      double ysum;     // 1'y
+      double n;        // Number of observations.
+      bool observed;   // Whether y[t] was observed when summarized.
+    };
+    std::vector<DataSummary> data_summaries_;
+
+    // False if data has been added or cleared since data_summaries_
+    // was last computed.  Observers are not placed on individual data
+    // points, which are shared with clones of the model.  Changes to
+    // missing status are detected by clear_client_data(), which also
+    // recomputes the response summaries.  Predictors modified in place
+    // are not detected.
+    bool data_summaries_are_current_;
   };
 
 }  // namespace BOOM
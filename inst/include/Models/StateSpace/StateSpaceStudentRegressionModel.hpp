@@ -20,6 +20,7 @@
 #define BOOM_STATE_SPACE_STUDENT_REGRESSION_MODEL_HPP_
 
 #include <Models/StateSpace/StateSpaceNormalMixture.hpp>
+#include <Models/StateSpace/RegressionPredictionCache.hpp>
 #include <Models/Glm/TRegression.hpp>
 #include <Models/Policies/IID_DataPolicy.hpp>
 #include <Models/Policies/PriorPolicy.hpp>
@@ -57,6 +58,9 @@ namespace BOOM {
       void set_weight(double weight, int observation);
 
       double adjusted_observation(const GlmCoefs &coefficients) const;
+      // The same as adjusted_observation(coefficients), but with x * beta
+      // for each observation supplied by 'predictions'.
+      double adjusted_observation(const ConstVectorView &predictions) const;
       double sum_of_weights() const;
 
       double state_model_offset() const {return state_model_offset_;}
@@ -132,6 +136,15 @@ namespace BOOM {
     // Sets up observers on model parameters, so that the Kalman
     // filter knows when it needs to be recomputed.
     void set_observers();
+
+    // Returns x * beta for each observation at time t, using
+    // prediction_cache_.
+    ConstVectorView regression_predictions(int t) const;
+
+    // Holds x * beta for every observation.  Invalidated by observers
+    // on the regression coefficients and on the data.
+    mutable StateSpace::RegressionPredictionCache prediction_cache_;
+
     Ptr<TRegressionModel> observation_model_;
   };
 
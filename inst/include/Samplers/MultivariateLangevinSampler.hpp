@@ -0,0 +1,154 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_MULTIVARIATE_LANGEVIN_SAMPLER_HPP_
+#define BOOM_MULTIVARIATE_LANGEVIN_SAMPLER_HPP_
+
+#include <cpputil/Ptr.hpp>
+#include <Samplers/Sampler.hpp>
+#include <TargetFun/TargetFun.hpp>
+#include <LinAlg/Matrix.hpp>
+#include <LinAlg/SpdMatrix.hpp>
+#include <LinAlg/Vector.hpp>
+
+namespace BOOM {
+
+  // A Metropolis adjusted Langevin algorithm (MALA) that updates all
+  // coordinates of its argument in a single block.  Each draw costs
+  // two evaluations of the target and its gradient (one at the
+  // current value and one at the proposal), no matter the dimension.
+  // Compare this with UnivariateLangevinSampler, which updates one
+  // coordinate at a time.
+  //
+  // The proposal is
+  //
+  //   x* ~ N(x + 0.5 * h * M * grad(x), h * M),
+  //
+  // where h is the step size and M is a positive definite
+  // "preconditioning" matrix, which should resemble the posterior
+  // variance of x.  M defaults to the identity.
+  class MultivariateLangevinSampler : public Sampler {
+   public:
+    // Args:
+    //   logf: The log of the target density, which must be able to
+    //     compute its gradient.
+    //   xdim:  The dimension of the argument to logf.
+    //   initial_step_size: The initial value of the step size h.
+    //   rng: The random number generator to use for the simulation.
+    MultivariateLangevinSampler(Ptr<dTargetFun> logf,
+                                int xdim,
+                                double initial_step_size,
+                                RNG *rng = nullptr);
+
+    Vector draw(const Vector &x) override;
+
+    double step_size() const { return step_size_; }
+    void set_step_size(double step_size);
+
+    // Set the preconditioning matrix M to the given value.  M should
+    // be an approximation to the variance of the target distribution.
+    void set_preconditioner(const SpdMatrix &M);
+    const SpdMatrix &preconditioner() const { return preconditioner_; }
+
+    // NOTE: Adaptation is an experimental feature.  Adaptive MCMC
+    // algorithms only preserve the target distribution if the amount
+    // of adaptation diminishes over time, which is the case for the
+    // adaptation schedule used here.
+    //
+    // If okay_to_adapt is true then the step size is adjusted after
+    // each draw by a Robbins-Monro update on log(h), aiming for the
+    // target acceptance rate.  The default is no adaptation.
+    void allow_adaptation(bool okay_to_adapt);
+
+    // If okay_to_adapt is true then the preconditioning matrix will be
+    // periodically reset to the running covariance matrix of the
+    // chain, once enough draws have been observed.  The default is no
+    // adaptation.
+    //
+    // Args:
+    //   okay_to_adapt: Flag indicating whether the preconditioner
+    //     should be adapted.
+    //   update_frequency: The number of draws between updates to the
+    //     preconditioner.
+    void allow_preconditioner_adaptation(bool okay_to_adapt,
+                                         int update_frequency = 100);
+
+    // The acceptance rate that adaptive step size selection aims for.
+    // The default is 0.574, which is asymptotically optimal for MALA
+    // (Roberts and Rosenthal 1998).
+    void set_target_acceptance_rate(double rate);
+
+    // The fraction of proposals accepted since the sampler was
+    // created.
+    double acceptance_rate() const;
+
+    // Log density of the target, and its gradient, at x.
+    double logf(const Vector &x) const { return (*logf_)(x); }
+    double logf(const Vector &x, Vector &gradient) const {
+      return (*logf_)(x, gradient);
+    }
+
+   private:
+    // The log of the proposal density of 'to' given 'from', up to a
+    // constant that does not depend on 'to' or 'from'.
+    double log_proposal_density(const Vector &to,
+                                const Vector &from,
+                                const Vector &from_gradient) const;
+
+    // Returns the mean of the proposal distribution given x and the
+    // gradient of logf at x.
+    Vector proposal_mean(const Vector &x, const Vector &gradient) const;
+
+    // Adds x to the running mean and covariance of the chain, and
+    // updates the preconditioner if it is time to do so.
+    void update_running_moments(const Vector &x);
+
+    // Adjust the step size in response to the probability of
+    // accepting the most recent proposal.
+    void adapt_step_size(double log_acceptance_ratio);
+
+    Ptr<dTargetFun> logf_;
+    double step_size_;
+
+    SpdMatrix preconditioner_;
+    // Lower Cholesky triangle of the preconditioner.
+    Matrix preconditioner_chol_;
+
+    bool adapt_step_size_;
+    bool adapt_preconditioner_;
+    int preconditioner_update_frequency_;
+    double target_acceptance_rate_;
+
+    int number_of_draws_;
+    int number_of_accepted_draws_;
+
+    // Running moments of the chain used to adapt the preconditioner.
+    int number_of_observed_draws_;
+    Vector running_mean_;
+    SpdMatrix running_sum_of_squares_;
+
+    // The current value of the chain, with the target's value and
+    // gradient at that point.
+    Vector current_x_;
+    double current_logp_;
+    Vector current_gradient_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_MULTIVARIATE_LANGEVIN_SAMPLER_HPP_
@@ -20,17 +20,57 @@
 
 #include <Samplers/Sampler.hpp>
 #include <LinAlg/Vector.hpp>
+#include <LinAlg/Matrix.hpp>
+#include <cpputil/ThreadTools.hpp>
 #include <functional>
+#include <memory>
 
 namespace BOOM{
 
   typedef std::function<double(const Vector &)> Func;
 
+  // A function that evaluates a log density at each row of its
+  // argument, returning a vector with one element per row.
+  typedef std::function<Vector(const Matrix &)> BatchFunc;
+
+  // Converts a Func into a BatchFunc that divides the rows of its
+  // argument among a pool of threads.  The Func must be safe to call
+  // from several threads at once, so it cannot (for example) write
+  // parameter values into a shared model object.
+  class ParallelBatchTarget {
+   public:
+    ParallelBatchTarget(const Func &f, int number_of_threads);
+    Vector operator()(const Matrix &points) const;
+
+   private:
+    Func f_;
+    // Held by a shared_ptr so the target can be copied into a
+    // std::function.
+    std::shared_ptr<ThreadWorkerPool> pool_;
+  };
+
   class SliceSampler : public Sampler{
   public:
     SliceSampler(Func F, bool unimodal=false);
     Vector draw(const Vector &x) override;
 
+    // Evaluate the log density at up to 'batch_size' candidate points
+    // at once while searching for the slice endpoints and while
+    // shrinking the slice.  The candidate points for each batch are
+    // generated under the assumption that the search continues, and
+    // the results are then consumed in order, so the draws have
+    // exactly the same distribution as the one-point-at-a-time
+    // algorithm.  Evaluations past the point where the search stops
+    // are wasted, which is worth it when the per-call overhead of the
+    // target dominates, or when the batch is evaluated in parallel.
+    //
+    // Args:
+    //   batch_logp: Evaluates the same log density as the Func passed
+    //     to the constructor, at each row of a matrix.
+    //   batch_size: The maximum number of points per batch.  If
+    //     batch_size <= 1 the batch target is ignored.
+    void set_batch_target(const BatchFunc &batch_logp, int batch_size);
+
   private:
     // lo and hi, last_position_, and random_direction_ define slice boundaries.
     // The "left" edge of the slice is last_position_ - lo_ * random_direction_.
@@ -60,10 +100,18 @@ namespace BOOM{
 
     bool unimodal_;
     Func logp_;
+    BatchFunc batch_logp_;
+    int batch_size_;
+
     void doubling(bool);
     void contract(double lam, double p);
     void find_limits();
 
+    // Batched versions of find_limits() and of the shrinkage step in
+    // draw().
+    void find_limits_batched();
+    Vector draw_from_slice_batched();
+
     // Point "random_direction_" in a uniformly chosen random direction.
     void set_random_direction();
 
@@ -199,6 +199,13 @@ namespace BOOM {
       return res;
     }
 
+    // Run job(0), ..., job(number_of_jobs - 1) on the threads in the
+    // pool, or sequentially in the calling thread if the pool has no
+    // threads.  Returns once every job has finished.  If any job
+    // throws, the first exception is rethrown in the calling thread
+    // after all the jobs have finished.
+    void run_jobs(int number_of_jobs, const std::function<void(int)> &job);
+
     // Returns true() if there are currently no threads available to
     // do work.  Worker threads can be added by calling add_threads().
     bool no_threads() const {
@@ -38,6 +38,9 @@ namespace BOOM {
     // truncated normal distribution given x>a>0.
    public:
     TnSampler(double a);              // Set the truncation point.
+    // Discard the current envelope and start over with truncation
+    // point a, reusing the storage held by this object.
+    void reset(double a);
     double draw(RNG & );              // simluate a value
     void add_point(double x);         // adds the point to the hull
     double f(double x)const;          // log of the target distribution
@@ -134,6 +137,26 @@ namespace BOOM {
   double rtrun_norm_mt(RNG &, double mu, double sigma,
                        double cutpoint, bool positive_support = true);
 
+  // Fills 'output' with independent draws from the N(mu, sigma^2)
+  // distribution truncated to (cutpoint, infinity) if
+  // positive_support is true, or (-infinity, cutpoint) otherwise.
+  // The draws share a single adaptive rejection envelope, which is
+  // refined as the draws proceed, instead of building a new envelope
+  // for each draw as repeated calls to rtrun_norm_mt() would.
+  void rtrun_norm_mt(RNG &rng, double mu, double sigma, double cutpoint,
+                     bool positive_support, VectorView output);
+
+  // Element i of 'output' is a draw from the N(mu[i], sigma^2)
+  // distribution truncated to (cutpoint, infinity) if
+  // positive_support[i] is true, or (-infinity, cutpoint) otherwise.
+  // The draws are the same as a sequence of calls to rtrun_norm_mt(),
+  // but the storage for the rejection envelope is reused across
+  // elements.
+  void rtrun_norm_mt(RNG &rng, const ConstVectorView &mu, double sigma,
+                     double cutpoint,
+                     const std::vector<bool> &positive_support,
+                     VectorView output);
+
   double dtrun_norm(double, double, double, double,
                     bool low=true, bool log=false);
   double dtrun_norm_2(double, double, double, double, double, bool log=false);
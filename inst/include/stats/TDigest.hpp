@@ -0,0 +1,114 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_STATS_TDIGEST_HPP_
+#define BOOM_STATS_TDIGEST_HPP_
+
+#include <vector>
+#include <LinAlg/Vector.hpp>
+#include <LinAlg/VectorView.hpp>
+
+namespace BOOM {
+
+  // A mergeable, bounded-memory summary of a stream of real numbers,
+  // from which quantiles and CDF values can be computed.  This is the
+  // "merging t-digest" of Dunning and Ertl (2019, arXiv:1902.04023).
+  //
+  // The data are summarized by a sorted set of weighted centroids.
+  // Centroids near the tails hold few observations, and centroids
+  // near the median hold many, so extreme quantiles are estimated
+  // with small relative error.  The number of centroids is bounded by
+  // a small multiple of the compression parameter, regardless of how
+  // many observations are added.
+  //
+  // Unlike IQagent, two digests can be merged, so draws summarized on
+  // different threads or by different MCMC chains can be combined
+  // into a single summary.  Unlike ECDF, the raw data are not stored,
+  // so cdf() and quantile() are approximate, but memory use does not
+  // grow with the number of draws.
+  class TDigest {
+   public:
+    // Args:
+    //   compression: Larger values give more accurate quantiles at
+    //     the cost of more centroids.  The digest holds at most about
+    //     2 * compression centroids.
+    explicit TDigest(double compression = 100);
+
+    // Add one observation, or a batch of observations.
+    void add(double x, double weight = 1.0);
+    void add_batch(const std::vector<double> &x);
+    void add_batch(const ConstVectorView &x);
+
+    // Combine the observations summarized by 'other' with those
+    // summarized by *this.
+    void merge(const TDigest &other);
+
+    // The estimated quantile corresponding to probability 'prob'.
+    // Throws an exception if the digest is empty.
+    double quantile(double prob) const;
+
+    // The estimated fraction of observations less than or equal to x.
+    double cdf(double x) const;
+
+    // Total weight (number of observations, for unit weights)
+    // summarized by the digest.
+    double total_weight() const;
+
+    double min() const { return min_; }
+    double max() const { return max_; }
+    bool empty() const { return total_weight() <= 0; }
+
+    // Returns the number of centroids in the compressed summary.
+    int number_of_centroids() const;
+
+    // Discard all observations.
+    void clear();
+
+    // Serialization.  The state of the digest is written to a Vector
+    // with layout [compression, min, max, number_of_centroids,
+    // means..., weights...].  A digest restored using deserialize()
+    // produces the same quantiles and CDF values as the original.
+    Vector serialize() const;
+    void deserialize(const ConstVectorView &state);
+
+   private:
+    // Merge the buffer of unprocessed observations into the
+    // centroids.
+    void compress() const;
+
+    double compression_;
+
+    // The centroids, sorted by mean.  These and the buffer are
+    // mutable so that the const query functions can compress the
+    // buffer before answering.
+    mutable std::vector<double> means_;
+    mutable std::vector<double> weights_;
+
+    // Observations that have been added but not yet merged into the
+    // centroids.
+    mutable std::vector<double> buffer_means_;
+    mutable std::vector<double> buffer_weights_;
+    int max_buffer_size_;
+
+    double min_;
+    double max_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_STATS_TDIGEST_HPP_
@@ -0,0 +1,119 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef BOOM_STATS_MCMC_CONVERGENCE_HPP_
+#define BOOM_STATS_MCMC_CONVERGENCE_HPP_
+
+#include <vector>
+#include <LinAlg/VectorView.hpp>
+
+namespace BOOM {
+
+  // Convergence diagnostics for a scalar quantity tracked by several
+  // MCMC chains.  Each element of 'chains' holds the draws from one
+  // chain, in the order they were produced.  All chains must have the
+  // same length, which must be at least 4.
+  //
+  // Both diagnostics split each chain into its first and second
+  // halves, and treat the halves as separate chains, so that a chain
+  // that is still drifting looks like two chains that disagree (Gelman
+  // et al., Bayesian Data Analysis, 3rd edition, section 11.4).
+
+  // Returns the split potential scale reduction factor (split R-hat).
+  // Values near 1 indicate convergence.  If every draw is identical
+  // the return value is 1.
+  double split_rhat(const std::vector<ConstVectorView> &chains);
+
+  // Returns the effective sample size of the pooled draws, based on
+  // the combined autocorrelations of the split chains, truncated using
+  // Geyer's initial monotone sequence estimator.  If every draw is
+  // identical the return value is the total number of draws.
+  double effective_sample_size(const std::vector<ConstVectorView> &chains);
+
+  //======================================================================
+  // Tracks split R-hat and the effective sample size of a scalar
+  // quantity drawn by several chains, without storing the draws.
+  // Each chain's draws are summarized in batches of consecutive draws,
+  // each holding a count, a mean, and a sum of squared deviations.
+  // When a chain has 2 * max_batches complete batches, adjacent
+  // batches are merged and the batch size doubles.  Memory use and the
+  // cost of computing the diagnostics therefore stay bounded however
+  // long the chains run.
+  //
+  // Split R-hat is computed exactly from the batches, splitting each
+  // chain at a batch boundary (the oldest batch is ignored if the
+  // number of batches is odd).  The effective sample size uses a
+  // batch means estimate of each chain's asymptotic variance, with
+  // batches of roughly sqrt(n) draws.  Draws in an incomplete batch
+  // are not used until the batch fills.
+  //
+  // Draws for different chains may be added from different threads,
+  // provided each chain is fed by only one thread at a time.
+  class StreamingConvergenceDiagnostics {
+   public:
+    // Args:
+    //   number_of_chains:  The number of chains being monitored.
+    //   max_batches: Each chain keeps between max_batches and 2 *
+    //     max_batches complete batches, once it has enough draws.
+    explicit StreamingConvergenceDiagnostics(int number_of_chains = 1,
+                                             int max_batches = 32);
+
+    // Discard all draws.
+    void clear();
+
+    // Add the next draw from the specified chain.
+    void add(int chain, double value);
+
+    // The number of draws from the specified chain that are summarized
+    // in complete batches.
+    int number_of_draws(int chain) const;
+
+    // Split R-hat, as in split_rhat() above.  Returns infinity if any
+    // chain has fewer than 4 complete batches.
+    double split_rhat() const;
+
+    // The effective sample size of the pooled draws.  Returns 0 if any
+    // chain has fewer than 4 complete batches.
+    double effective_sample_size() const;
+
+   private:
+    struct Batch {
+      Batch() : count(0), mean(0), sum_of_squares(0) {}
+      void add(double value);
+      void combine(const Batch &rhs);
+      double count;
+      double mean;
+      double sum_of_squares;
+    };
+
+    struct ChainSummary {
+      ChainSummary() : batch_size(1) {}
+      std::vector<Batch> batches;
+      Batch current;
+      int batch_size;
+    };
+
+    bool enough_batches() const;
+
+    int max_batches_;
+    std::vector<ChainSummary> chains_;
+  };
+
+}  // namespace BOOM
+
+#endif  // BOOM_STATS_MCMC_CONVERGENCE_HPP_
@@ -22,6 +22,7 @@
 #include <cstdlib>
 
 #include <Models/Bart/Bart.hpp>
+#include <Models/Bart/QuantizedPredictors.hpp>
 #include <Models/Bart/ResidualRegressionData.hpp>
 #include <cpputil/math_utils.hpp>
 #include <cpputil/report_error.hpp>
@@ -67,6 +68,40 @@ namespace BOOM {
       return *it;
     }
 
+    // Returns a sorted table of at most max_bins distinct bin edges
+    // for the sorted vector 'values'.  If 'values' contains no more
+    // than max_bins distinct elements then they are all returned.
+    // Otherwise the edges are empirical quantiles of 'values', so the
+    // bins hold roughly equal numbers of observations.  The largest
+    // value is always an edge.
+    Vector quantile_bin_edges(const Vector &sorted_values, int max_bins) {
+      Vector ans;
+      int n = sorted_values.size();
+      if (n == 0) {
+        return ans;
+      }
+      int number_of_unique_values = 1;
+      for (int i = 1; i < n; ++i) {
+        number_of_unique_values += sorted_values[i] != sorted_values[i - 1];
+      }
+      if (number_of_unique_values <= max_bins) {
+        ans.reserve(number_of_unique_values);
+        std::unique_copy(sorted_values.begin(), sorted_values.end(),
+                         std::back_inserter(ans));
+        return ans;
+      }
+      ans.reserve(max_bins);
+      for (int k = 1; k <= max_bins; ++k) {
+        int position = static_cast<int>(
+            std::ceil(static_cast<double>(k) * n / max_bins)) - 1;
+        double edge = sorted_values[position];
+        if (ans.empty() || edge > ans.back()) {
+          ans.push_back(edge);
+        }
+      }
+      return ans;
+    }
+
     }  // namespace
 
     //----------------------------------------------------------------------
@@ -95,8 +130,14 @@ namespace BOOM {
     //----------------------------------------------------------------------
     void VariableSummary::finalize(
         int discrete_distribution_cutoff,
-        ContinuousCutpointStrategy strategy) {
+        ContinuousCutpointStrategy strategy,
+        int max_bins) {
       observed_values_.sort();
+      if (max_bins > 0) {
+        bin_edges_ = quantile_bin_edges(observed_values_, max_bins);
+      } else {
+        bin_edges_.clear();
+      }
       Vector::iterator end =
           std::unique(observed_values_.begin(), observed_values_.end());
 
@@ -132,6 +173,12 @@ namespace BOOM {
         impl_.reset(new DiscreteVariableSummary(variable_number_,
                                                 observed_values_));
       }
+      if (max_bins > 0 && number_of_unique_values > max_bins) {
+        // The predictor will be coarsened, so the only cutpoints that
+        // can be used are the bin edges.
+        impl_.reset(new DiscreteVariableSummary(variable_number_,
+                                                bin_edges_));
+      }
       observed_values_.clear();
     }
 
@@ -471,7 +518,9 @@ namespace BOOM {
           depth_(parent_ ? 1 + parent_->depth() : 0),
           mean_(mean_value),
           which_variable_(-1),             // needs to be set
-          cutpoint_(BOOM::infinity())      // needs to be set
+          cutpoint_(BOOM::infinity()),     // needs to be set
+          threshold_predictors_(NULL),
+          quantized_threshold_(0)
     {}
 
     //----------------------------------------------------------------------
@@ -677,10 +726,12 @@ namespace BOOM {
     //----------------------------------------------------------------------
     void TreeNode::set_variable(int variable_index) {
       which_variable_ = variable_index;
+      invalidate_quantized_threshold();
     }
 
     void TreeNode::set_cutpoint(double cutpoint) {
       cutpoint_ = cutpoint;
+      invalidate_quantized_threshold();
     }
 
     //----------------------------------------------------------------------
@@ -713,6 +764,9 @@ namespace BOOM {
     //----------------------------------------------------------------------
     void TreeNode::clear_data_and_delete_suf(bool recursive) {
       data_.clear();
+      // The data may come back quantized by a new object at the same
+      // address, so the cached threshold can't be trusted.
+      invalidate_quantized_threshold();
       if (!!suf_) {
         suf_.reset();
       }
@@ -763,14 +817,33 @@ namespace BOOM {
 
     //----------------------------------------------------------------------
     void TreeNode::drop_data_to_subtree(ResidualRegressionData *dp) {
-      const Vector &x(dp->x());
-      if (x[which_variable_] <= cutpoint_) {
+      if (goes_left(dp)) {
         left_child_->populate_data(dp, true);
       } else {
         right_child_->populate_data(dp, true);
       }
     }
 
+    //----------------------------------------------------------------------
+    bool TreeNode::goes_left(const ResidualRegressionData *dp) {
+      const QuantizedPredictors *predictors = dp->quantized_predictors();
+      if (predictors) {
+        return predictors->code(which_variable_, dp->observation_index())
+            < quantized_threshold(predictors);
+      } else {
+        return dp->x()[which_variable_] <= cutpoint_;
+      }
+    }
+
+    //----------------------------------------------------------------------
+    int TreeNode::quantized_threshold(const QuantizedPredictors *predictors) {
+      if (predictors != threshold_predictors_) {
+        quantized_threshold_ = predictors->threshold(which_variable_, cutpoint_);
+        threshold_predictors_ = predictors;
+      }
+      return quantized_threshold_;
+    }
+
     //----------------------------------------------------------------------
     void TreeNode::refresh_subtree_data() {
       if (is_leaf()) {
@@ -778,15 +851,44 @@ namespace BOOM {
       }
       left_child_->clear_data_and_suf(true);
       right_child_->clear_data_and_suf(true);
-      for (int i = 0; i < data_.size(); ++i) {
-        drop_data_to_subtree(data_[i]);
+      partition_data_to_children();
+    }
+
+    //----------------------------------------------------------------------
+    // Each child receives its data in the same order as it would from
+    // calling drop_data_to_subtree on each element of data_, so
+    // sufficient statistics accumulate identically either way.
+    void TreeNode::partition_data_to_children() {
+      if (is_leaf() || data_.empty()) {
+        return;
       }
+      const QuantizedPredictors *predictors = data_[0]->quantized_predictors();
+      if (predictors) {
+        predictors->partition(which_variable_,
+                              quantized_threshold(predictors),
+                              data_,
+                              left_child_->data_,
+                              right_child_->data_);
+      } else {
+        for (int i = 0; i < data_.size(); ++i) {
+          ResidualRegressionData *dp = data_[i];
+          if (dp->x()[which_variable_] <= cutpoint_) {
+            left_child_->data_.push_back(dp);
+          } else {
+            right_child_->data_.push_back(dp);
+          }
+        }
+      }
+      left_child_->partition_data_to_children();
+      right_child_->partition_data_to_children();
     }
 
     //----------------------------------------------------------------------
     void TreeNode::swap_splitting_rule(TreeNode *other) {
       std::swap(which_variable_, other->which_variable_);
       std::swap(cutpoint_, other->cutpoint_);
+      invalidate_quantized_threshold();
+      other->invalidate_quantized_threshold();
     }
 
     //----------------------------------------------------------------------
@@ -1107,6 +1209,13 @@ namespace BOOM {
       root_->populate_data(data, true);
     }
 
+    //----------------------------------------------------------------------
+    void Tree::populate_data(
+        const std::vector<ResidualRegressionData *> &data) {
+      root_->data_.insert(root_->data_.end(), data.begin(), data.end());
+      root_->partition_data_to_children();
+    }
+
     //----------------------------------------------------------------------
     void Tree::clear_data_and_delete_suf() {
       root_->clear_data_and_delete_suf(true);
@@ -1187,6 +1296,7 @@ namespace BOOM {
 
   //======================================================================
   BartModelBase::BartModelBase(int number_of_trees, double mean)
+      : max_predictor_bins_(0)
   {
     create_trees(number_of_trees, mean);
   }
@@ -1195,7 +1305,8 @@ namespace BOOM {
   BartModelBase::BartModelBase(const BartModelBase &rhs)
       : Model(rhs),
         variable_summaries_(rhs.variable_summaries_),
-        trees_(rhs.trees_)
+        trees_(rhs.trees_),
+        max_predictor_bins_(rhs.max_predictor_bins_)
   {
     for (int i = 0; i < trees_.size(); ++i) {
       trees_[i].reset(new Bart::Tree(*(rhs.trees_[i])));
@@ -1263,11 +1374,19 @@ namespace BOOM {
   //----------------------------------------------------------------------
   void BartModelBase::finalize_data(
         int discrete_distribution_cutoff,
-        Bart::ContinuousCutpointStrategy strategy) {
+        Bart::ContinuousCutpointStrategy strategy,
+        int max_predictor_bins) {
+    if (max_predictor_bins < 0 || max_predictor_bins == 1
+        || max_predictor_bins > 65536) {
+      report_error("max_predictor_bins must be 0 (no quantization), or "
+                   "between 2 and 65536.");
+    }
     for (int i = 0; i < number_of_variables(); ++i) {
       variable_summaries_[i].finalize(discrete_distribution_cutoff,
-                                      strategy);
+                                      strategy,
+                                      max_predictor_bins);
     }
+    max_predictor_bins_ = max_predictor_bins;
   }
 
   //----------------------------------------------------------------------
@@ -1280,6 +1399,8 @@ namespace BOOM {
   void BartModelBase::set_variable_summaries(
       const std::vector<Bart::SerializedVariableSummary> &serialized) {
     variable_summaries_.clear();
+    // Bin edges are not serialized, so predictors cannot be quantized.
+    max_predictor_bins_ = 0;
     variable_summaries_.reserve(serialized.size());
     for (int i = 0; i < serialized.size(); ++i) {
       variable_summaries_.push_back(Bart::VariableSummary(serialized[i]));
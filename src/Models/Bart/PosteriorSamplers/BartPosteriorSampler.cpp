@@ -16,6 +16,7 @@
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
 */
 
+#include <Models/Bart/QuantizedPredictors.hpp>
 #include <Models/Bart/ResidualRegressionData.hpp>
 #include <Models/Bart/PosteriorSamplers/BartPosteriorSampler.hpp>
 #include <distributions.hpp>
@@ -236,11 +237,14 @@ namespace BOOM {
     if (residual_size() != model_->sample_size()) {
       clear_residuals();
       clear_data_from_trees();
+      std::vector<Bart::ResidualRegressionData *> data;
+      data.reserve(model_->sample_size());
       for (int i = 0; i < model_->sample_size(); ++i) {
-        Bart::ResidualRegressionData *data = create_and_store_residual(i);
-        for (int j = 0; j < model_->number_of_trees(); ++j) {
-          model_->tree(j)->populate_data(data);
-        }
+        data.push_back(create_and_store_residual(i));
+      }
+      quantize_predictors(data);
+      for (int j = 0; j < model_->number_of_trees(); ++j) {
+        model_->tree(j)->populate_data(data);
       }
       for (int i = 0; i < model_->number_of_trees(); ++i) {
         model_->tree(i)->populate_sufficient_statistics(create_suf());
@@ -250,8 +254,30 @@ namespace BOOM {
 
   //----------------------------------------------------------------------
   void BartPosteriorSamplerBase::fill_tree_with_residual_data(Tree *tree) {
+    std::vector<Bart::ResidualRegressionData *> data;
+    data.reserve(residual_size());
     for (int i = 0; i < residual_size(); ++i) {
-      tree->populate_data(residual(i));
+      data.push_back(residual(i));
+    }
+    tree->populate_data(data);
+  }
+
+  //----------------------------------------------------------------------
+  void BartPosteriorSamplerBase::quantize_predictors(
+      const std::vector<Bart::ResidualRegressionData *> &data) {
+    if (model_->max_predictor_bins() <= 0) {
+      quantized_predictors_.reset();
+      return;
+    }
+    std::vector<Vector> bin_edges;
+    bin_edges.reserve(model_->number_of_variables());
+    for (int j = 0; j < model_->number_of_variables(); ++j) {
+      bin_edges.push_back(model_->variable_summary(j).bin_edges());
+    }
+    quantized_predictors_.reset(new Bart::QuantizedPredictors(bin_edges));
+    for (int i = 0; i < data.size(); ++i) {
+      quantized_predictors_->add_observation(data[i]->x());
+      data[i]->set_quantized_predictors(quantized_predictors_.get(), i);
     }
   }
 
@@ -0,0 +1,113 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/Bart/QuantizedPredictors.hpp>
+#include <algorithm>
+#include <limits>
+#include <Models/Bart/ResidualRegressionData.hpp>
+#include <cpputil/report_error.hpp>
+
+namespace BOOM {
+  namespace Bart {
+    namespace {
+      template <class CODE>
+      void partition_column(
+          const std::vector<CODE> &codes,
+          int threshold,
+          const std::vector<ResidualRegressionData *> &data,
+          std::vector<ResidualRegressionData *> &left,
+          std::vector<ResidualRegressionData *> &right) {
+        for (int i = 0; i < data.size(); ++i) {
+          ResidualRegressionData *dp = data[i];
+          if (codes[dp->observation_index()] < threshold) {
+            left.push_back(dp);
+          } else {
+            right.push_back(dp);
+          }
+        }
+      }
+    }  // namespace
+
+    QuantizedPredictors::QuantizedPredictors(
+        const std::vector<Vector> &bin_edges)
+        : bin_edges_(bin_edges),
+          bytes_per_cell_(bin_edges.size()),
+          narrow_codes_(bin_edges.size()),
+          wide_codes_(bin_edges.size()),
+          sample_size_(0)
+    {
+      for (int j = 0; j < bin_edges_.size(); ++j) {
+        int number_of_bins = bin_edges_[j].size();
+        if (number_of_bins == 0) {
+          report_error("Each variable needs at least one bin edge.");
+        }
+        if (number_of_bins
+            <= 1 + int(std::numeric_limits<std::uint8_t>::max())) {
+          bytes_per_cell_[j] = 1;
+        } else if (number_of_bins
+                   <= 1 + int(std::numeric_limits<std::uint16_t>::max())) {
+          bytes_per_cell_[j] = 2;
+        } else {
+          report_error("Too many bin edges for a quantized predictor.");
+        }
+      }
+    }
+
+    //----------------------------------------------------------------------
+    void QuantizedPredictors::add_observation(const ConstVectorView &x) {
+      if (x.size() != bin_edges_.size()) {
+        report_error("Wrong sized predictor vector passed to "
+                     "QuantizedPredictors::add_observation.");
+      }
+      for (int j = 0; j < x.size(); ++j) {
+        const Vector &edges(bin_edges_[j]);
+        int code = std::lower_bound(edges.begin(), edges.end(), x[j])
+            - edges.begin();
+        code = std::min<int>(code, edges.size() - 1);
+        if (bytes_per_cell_[j] == 1) {
+          narrow_codes_[j].push_back(code);
+        } else {
+          wide_codes_[j].push_back(code);
+        }
+      }
+      ++sample_size_;
+    }
+
+    //----------------------------------------------------------------------
+    int QuantizedPredictors::threshold(int variable, double cutpoint) const {
+      const Vector &edges(bin_edges_[variable]);
+      return std::upper_bound(edges.begin(), edges.end(), cutpoint)
+          - edges.begin();
+    }
+
+    //----------------------------------------------------------------------
+    void QuantizedPredictors::partition(
+        int variable,
+        int threshold,
+        const std::vector<ResidualRegressionData *> &data,
+        std::vector<ResidualRegressionData *> &left,
+        std::vector<ResidualRegressionData *> &right) const {
+      if (bytes_per_cell_[variable] == 1) {
+        partition_column(narrow_codes_[variable], threshold, data, left, right);
+      } else {
+        partition_column(wide_codes_[variable], threshold, data, left, right);
+      }
+    }
+
+  }  // namespace Bart
+}  // namespace BOOM
@@ -23,7 +23,9 @@ namespace BOOM {
   namespace Bart {
 
     ResidualRegressionData::ResidualRegressionData(const VectorData *x)
-        : predictor_(x)
+        : predictor_(x),
+          quantized_predictors_(NULL),
+          observation_index_(-1)
     {}
 
     //----------------------------------------------------------------------
@@ -31,6 +33,13 @@ namespace BOOM {
       return predictor_->value();
     }
 
+    //----------------------------------------------------------------------
+    void ResidualRegressionData::set_quantized_predictors(
+        const QuantizedPredictors *predictors, int observation_index) {
+      quantized_predictors_ = predictors;
+      observation_index_ = observation_index;
+    }
+
     //----------------------------------------------------------------------
     void ResidualRegressionData::subtract_from_residual(double value) {
       add_to_residual(-value);
@@ -18,6 +18,7 @@
 
 #include <Models/FiniteMixtureModel.hpp>
 #include <cpputil/lse.hpp>
+#include <cpputil/report_error.hpp>
 #include <distributions.hpp>
 
 #include <functional>
@@ -88,6 +89,33 @@ namespace BOOM{
     last_loglike_ = 0;
     const std::vector<Ptr<MixtureComponent> > &mod(mixture_components_);
     Ptr<MultinomialModel> mix(mixing_dist_);
+
+    // A tempered model adds each observation to its component with
+    // weight equal to the likelihood power.
+    double power = likelihood_power();
+    std::vector<EmMixtureComponent *> weighted_components;
+    if (power != 1.0) {
+      for (uint s = 0; s < S; ++s) {
+        EmMixtureComponent *component =
+            dynamic_cast<EmMixtureComponent *>(mod[s].get());
+        if (!component) {
+          report_error("A tempered FiniteMixtureModel requires mixture "
+                       "components that are EmMixtureComponents.");
+        }
+        weighted_components.push_back(component);
+      }
+    }
+    auto assign = [&](uint h, const Ptr<Data> &dp,
+                      const Ptr<CategoricalData> &cd) {
+      if (power == 1.0) {
+        mod[h]->add_data(dp);
+        mix->add_data(cd);
+      } else {
+        weighted_components[h]->add_mixture_data(dp, power);
+        mix->add_mixture_data(cd, power);
+      }
+    };
+
     clear_component_data();
     for (uint i=0; i<n; ++i) {
       dPtr dp = d[i];
@@ -100,8 +128,7 @@ namespace BOOM{
         class_membership_probabilities_.row(i) = 0;
         class_membership_probabilities_(i, source) = 1.0;
         cd->set(source);
-        mix->add_data(cd);
-        mod[source]->add_data(dp);
+        assign(source, dp, cd);
         continue;
       } else {
         for (uint s=0; s<S; ++s) {
@@ -109,12 +136,12 @@ namespace BOOM{
         }
       }
       last_loglike_ += lse(wsp_);
+      if (power != 1.0) wsp_ *= power;
       wsp_.normalize_logprob();
       class_membership_probabilities_.row(i) = wsp_;
       uint h = rmulti_mt(rng, wsp_);
       cd->set(h);
-      mod[h]->add_data(dp);
-      mix->add_data(cd);
+      assign(h, dp, cd);
     }
   }
 
@@ -131,6 +158,32 @@ namespace BOOM{
   double FMM::last_loglike() const {
     return last_loglike_;}
 
+  double FMM::log_likelihood() const {
+    const std::vector<Ptr<Data> > &d(dat());
+    double ans = 0;
+    for (uint i = 0; i < d.size(); ++i) {
+      if (!d[i]->missing()) {
+        ans += pdf(d[i], true);
+      }
+    }
+    return ans;
+  }
+
+  double FMM::tempered_log_likelihood() const {
+    const std::vector<Ptr<Data> > &d(dat());
+    const std::vector<Ptr<CategoricalData> > &hvec(latent_data());
+    const Vector &log_pi(logpi());
+    double ans = 0;
+    for (uint i = 0; i < d.size(); ++i) {
+      int h = hvec[i]->value();
+      ans += log_pi[h];
+      if (!d[i]->missing()) {
+        ans += mixture_components_[h]->pdf(d[i].get(), true);
+      }
+    }
+    return ans;
+  }
+
   void FMM::set_observers() {
     mixing_dist_->Pi_prm()->add_observer([this]() {this->observe_pi();});
     logpi_current_ = false;
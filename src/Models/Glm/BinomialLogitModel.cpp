@@ -16,6 +16,7 @@
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
 */
 #include <Models/Glm/BinomialLogitModel.hpp>
+#include <Models/Glm/GlmDerivativeKernels.hpp>
 #include <distributions.hpp>
 #include <stats/logit.hpp>
 #include <cpputil/math_utils.hpp>
@@ -29,22 +30,26 @@ namespace BOOM{
 
   BLM::BinomialLogitModel(uint beta_dim, bool all)
       : ParamPolicy(new GlmCoefs(beta_dim, all)),
-        log_alpha_(0)
+        log_alpha_(0),
+        packed_design_current_(false)
   {}
 
   BLM::BinomialLogitModel(const Vector &beta)
       : ParamPolicy(new GlmCoefs(beta)),
-        log_alpha_(0)
+        log_alpha_(0),
+        packed_design_current_(false)
   {}
 
   BLM::BinomialLogitModel(Ptr<GlmCoefs> beta)
       : ParamPolicy(beta),
-        log_alpha_(0)
+        log_alpha_(0),
+        packed_design_current_(false)
   {}
 
   BLM::BinomialLogitModel(const Matrix &X, const Vector &y, const Vector &n)
       : ParamPolicy(new GlmCoefs(X.ncol())),
-        log_alpha_(0)
+        log_alpha_(0),
+        packed_design_current_(false)
       {
         int nr = nrow(X);
         for(int i = 0; i < nr; ++i){
@@ -63,11 +68,26 @@ namespace BOOM{
         ParamPolicy(rhs),
         DataPolicy(rhs),
         PriorPolicy(rhs),
-        log_alpha_(rhs.log_alpha_) {}
+        log_alpha_(rhs.log_alpha_),
+        packed_design_current_(false) {}
 
   BLM* BinomialLogitModel::clone()const{
     return new BinomialLogitModel(*this);}
 
+  void BLM::add_data(Ptr<Data> dp) {
+    add_data(DAT(dp));
+  }
+
+  void BLM::add_data(Ptr<BRD> dp) {
+    packed_design_current_ = false;
+    DataPolicy::add_data(dp);
+  }
+
+  void BLM::clear_data() {
+    packed_design_current_ = false;
+    DataPolicy::clear_data();
+  }
+
   namespace {
     // Compute the probability of success (or failure) at a value of x.
     // Args:
@@ -159,35 +179,52 @@ namespace BOOM{
         }
       }
     }
+    if (!packed_design_current_) refresh_packed_design();
+    Matrix workspace;
+    const Matrix &X(xdim() == beta.size()
+                    ? design_
+                    : included_columns(design_, coef().inc(), workspace));
+    int nobs = data.size();
+    Vector eta(nobs, 0.0);
+    if (nobs > 0 && beta.size() > 0) {
+      X.mult(beta, eta);
+    }
+    Vector residual(g ? nobs : 0);
+    Vector weights(h ? nobs : 0);
     double ans = 0;
-    bool all_coefficients_included = (xdim() == beta.size());
-    const Selector &inc(coef().inc());
-    for(int i = 0; i < data.size(); ++i){
+    for(int i = 0; i < nobs; ++i){
       // y and n had been defined as uint's but y-n*p was computing
       // -n, which overflowed
       int y = data[i]->y();
       int n = data[i]->n();
-      const Vector & x(data[i]->x());
-      Vector reduced_x;
-      if (!all_coefficients_included) {
-        reduced_x = inc.select(x);
-      }
-      ConstVectorView X(all_coefficients_included ? x : reduced_x);
-
-      double eta = beta.dot(X) - log_alpha_;
-      double p = logit_inv(eta);
-      double loglike = dbinom(y, n, p, true);
-      ans += loglike;
+      double p = logit_inv(eta[i] - log_alpha_);
+      ans += dbinom(y, n, p, true);
       if (g) {
-        g->axpy(X, y-n*p);  // g += (y-n*p) * x;
+        residual[i] = y - n * p;
         if (h) {
-          h->add_outer(X, X, -n*p*(1-p)); // h += -npq * x x^T
+          weights[i] = -n * p * (1 - p);
         }
       }
     }
+    if (g && nobs > 0 && beta.size() > 0) {
+      *g += X.Tmult(residual);  // g += X^T (y - n * p)
+      if (h) {
+        *h += weighted_inner_product(X, weights);  // h += -X^T npq X
+      }
+    }
     return ans;
   }
 
+
+  void BLM::refresh_packed_design() const {
+    const BLM::DatasetType &data(dat());
+    design_.resize(data.size(), xdim());
+    for (int i = 0; i < data.size(); ++i) {
+      design_.row(i) = data[i]->x();
+    }
+    packed_design_current_ = true;
+  }
+
   d2TargetFunPointerAdapter BLM::log_likelihood_tf() const {
     return d2TargetFunPointerAdapter(
         [this](const Vector &x,
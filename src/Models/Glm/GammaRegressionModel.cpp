@@ -17,7 +17,9 @@
 */
 
 #include <Models/Glm/GammaRegressionModel.hpp>
+#include <Models/Glm/GlmDerivativeKernels.hpp>
 #include <distributions.hpp>
+#include <cpputil/report_error.hpp>
 
 #include <LinAlg/Vector.hpp>
 #include <LinAlg/VectorView.hpp>
@@ -84,110 +86,153 @@ namespace BOOM {
 
   GammaRegressionModel::GammaRegressionModel(
       int xdim)
-      : GammaRegressionModelBase(xdim)
+      : GammaRegressionModelBase(xdim),
+        packed_data_current_(false)
   {}
   GammaRegressionModel::GammaRegressionModel(
       double shape_parameter, const Vector &coefficients)
-      : GammaRegressionModelBase(shape_parameter, coefficients)
+      : GammaRegressionModelBase(shape_parameter, coefficients),
+        packed_data_current_(false)
   {}
   GammaRegressionModel::GammaRegressionModel(
       Ptr<UnivParams> alpha, Ptr<GlmCoefs> coefficients)
-      : GammaRegressionModelBase(alpha, coefficients)
+      : GammaRegressionModelBase(alpha, coefficients),
+        packed_data_current_(false)
   {}
 
   GammaRegressionModel * GammaRegressionModel::clone() const {
     return new GammaRegressionModel(*this);
   }
 
+  void GammaRegressionModel::add_data(Ptr<Data> dp) {
+    add_data(DAT(dp));
+  }
+
+  void GammaRegressionModel::add_data(Ptr<RegressionData> dp) {
+    packed_data_current_ = false;
+    DataPolicy::add_data(dp);
+  }
+
+  void GammaRegressionModel::clear_data() {
+    packed_data_current_ = false;
+    DataPolicy::clear_data();
+  }
+
   namespace {
-    void initialize_log_likelihood_computation(
+    // The likelihood for a gamma(a, b) observation is
+    // (b^a / Gamma (a)) y^{a-1} exp{-b * y}.
+    // Reparameterizing to b = a/mu gives...
+    //
+    // L = [a^a / (mu^a Gamma(a))] y^{a-1} exp{- a * y / mu}
+    //  So on the log scale this gives
+    //
+    //  \ell = a * log(a) - a * log(mu) - lgamma(a) + (a-1) * log(y) - a * y/mu
+    //
+    // Row i of 'design' is a vector of predictors shared by counts[i]
+    // observations, with sum sums[i] and sum of logs sumlogs[i].
+    // With eta = log(mu) = X * beta and r[i] = sums[i] / mu[i], the
+    // derivatives with respect to beta are
+    //
+    //   gradient = a * X^T (r - n)
+    //    Hessian = -a * X^T diag(r) X,
+    //
+    // and the cross derivative with respect to (a, beta) is X^T (r - n).
+    double packed_gamma_log_likelihood(
+        const Matrix &full_design,
+        const Vector &counts,
+        const Vector &sums,
+        const Vector &sumlogs,
         const Vector &alpha_beta,
+        const Selector &inc,
         Vector &gradient,
         Matrix &Hessian,
-        uint nd,
-        double &digamma_alpha,
-        double &trigamma_alpha) {
+        uint nd) {
       double alpha = alpha_beta[0];
-      if (nd > 0) {
-        gradient.resize(alpha_beta.size());
-        gradient = 0;
-        digamma_alpha = digamma(alpha);
-        if (nd > 1) {
-          Hessian.resize(alpha_beta.size(), alpha_beta.size());
-          Hessian = 0;
-          trigamma_alpha = trigamma(alpha);
-        }
+      ConstVectorView beta(alpha_beta, 1);
+      Matrix workspace;
+      const Matrix &design(beta.size() == full_design.ncol()
+                           ? full_design
+                           : included_columns(full_design, inc, workspace));
+      int n = counts.size();
+      Vector eta(n, 0.0);
+      if (n > 0 && beta.size() > 0) {
+        design.mult(Vector(beta), eta);
       }
-    }
 
-    void increment_loglike(
-        double &ans, Vector &gradient, Matrix &Hessian, int nd,
-        const ConstVectorView &x, double sumy, double sumlogy, double n,
-        double eta, double mu, double alpha, double log_alpha,
-        double lgamma_alpha, double digamma_alpha, double trigamma_alpha) {
-      ans += n * (alpha * (log_alpha - eta) - lgamma_alpha)
-          + (alpha - 1) * sumlogy
-          - alpha * sumy / mu;
-      if (nd > 0) {
-        gradient[0] += n * (1 + log_alpha) - n * eta - n * digamma_alpha
-            + sumlogy - sumy / mu;
-        VectorView(gradient, 1).axpy(x, alpha * ((sumy / mu) - n));
-        if (nd > 1) {
-          Hessian(0, 0) += n * ((1.0 / alpha) - trigamma_alpha);
-          VectorView(Hessian.row(0), 1).axpy(x, -n + sumy / mu);
-          // The cross hessian affects both rows and columns.  Only
-          // the first row is handled here.  Need to reflect the
-          // matrix prior to returning.
-          SpdMatrix beta_hessian = outer(x);
-          beta_hessian *= -alpha * sumy / mu;
-          SubMatrix(Hessian, 1, x.size(), 1, x.size()) += beta_hessian;
+      double log_alpha = log(alpha);
+      double lgamma_alpha = lgamma(alpha);
+      double total_count = 0;
+      double ans = 0;
+      Vector scaled_sums(n);
+      for (int i = 0; i < n; ++i) {
+        scaled_sums[i] = sums[i] * exp(-eta[i]);
+        total_count += counts[i];
+        ans += counts[i] * (alpha * (log_alpha - eta[i]) - lgamma_alpha)
+            + (alpha - 1) * sumlogs[i]
+            - alpha * scaled_sums[i];
+      }
+      if (nd == 0) return ans;
+
+      int dim = alpha_beta.size();
+      gradient.resize(dim);
+      gradient[0] = total_count * (1 + log_alpha - digamma(alpha))
+          - counts.dot(eta) + sum(sumlogs) - sum(scaled_sums);
+      Vector residual = scaled_sums - counts;
+      VectorView beta_gradient(gradient, 1);
+      if (n > 0 && beta.size() > 0) {
+        beta_gradient = design.Tmult(residual);
+        beta_gradient *= alpha;
+      } else {
+        beta_gradient = 0;
+      }
+      if (nd > 1) {
+        Hessian.resize(dim, dim);
+        Hessian(0, 0) = total_count * ((1.0 / alpha) - trigamma(alpha));
+        VectorView cross(Hessian.row(0), 1);
+        cross = beta_gradient;
+        cross /= alpha;
+        Hessian.col(0) = Hessian.row(0);
+        if (dim > 1) {
+          SubMatrix(Hessian, 1, dim - 1, 1, dim - 1) =
+              weighted_inner_product(design, scaled_sums * (-alpha));
         }
       }
+      return ans;
     }
   } // namespace
 
-  // The likelihood for a gamma(a, b) observation is
-  // (b^a / Gamma (a)) y^{a-1} exp{-b * y}.
-  // Reparameterizing to b = a/mu gives...
-  //
-  // L = [a^a / (mu^a Gamma(a))] y^{a-1} exp{- a * y / mu}
-  //  So on the log scale this gives
-  //
-  //  \ell = a * log(a) - a * log(mu) - lgamma(a) + (a-1) * log(y) - a * y/mu
   double GammaRegressionModel::Loglike(
       const Vector &alpha_beta,
       Vector &gradient,
       Matrix &Hessian,
       uint nd) const {
-    double ans = 0;
-    const std::vector<Ptr<RegressionData> > &data(dat());
-    double alpha = alpha_beta[0];
-    ConstVectorView beta(alpha_beta, 1);
-    bool all_coefficients_included = (xdim() == beta.size());
-    const Selector &inc(coef().inc());
-    double log_alpha = log(alpha);
-    double lgamma_alpha = lgamma(alpha);
-    double digamma_alpha, trigamma_alpha;
-    initialize_log_likelihood_computation(
-        alpha_beta, gradient, Hessian, nd, digamma_alpha, trigamma_alpha);
-    for (size_t i = 0; i < data.size(); ++i) {
-      const Vector & x(data[i]->x());
-      Vector reduced_x;
-      if (!all_coefficients_included) {
-        reduced_x = inc.select(x);
-      }
-      ConstVectorView X(all_coefficients_included ? x : reduced_x);
-      double eta = beta.dot(X);
-      double mu = exp(eta);
-      double y = data[i]->y();
-      increment_loglike(
-          ans, gradient, Hessian, nd, X, y, log(y), 1, eta, mu,
-          alpha, log_alpha, lgamma_alpha, digamma_alpha, trigamma_alpha);
+    if (!packed_data_current_) refresh_packed_data();
+    // The responses are copied on each call, so that changes made to
+    // the data points in place are picked up.  They are local so that
+    // concurrent calls do not share workspace.
+    const std::vector<Ptr<RegressionData>> &data(dat());
+    int n = data.size();
+    Vector response(n);
+    Vector log_response(n);
+    for (int i = 0; i < n; ++i) {
+      response[i] = data[i]->y();
+      log_response[i] = log(response[i]);
     }
-    if (nd > 1) {
-      Hessian.col(0) = Hessian.row(0);
+    return packed_gamma_log_likelihood(
+        design_, counts_, response, log_response, alpha_beta,
+        coef().inc(), gradient, Hessian, nd);
+  }
+
+  void GammaRegressionModel::refresh_packed_data() const {
+    const std::vector<Ptr<RegressionData>> &data(dat());
+    int n = data.size();
+    design_.resize(n, xdim());
+    for (int i = 0; i < n; ++i) {
+      design_.row(i) = data[i]->x();
     }
-    return ans;
+    counts_.resize(n);
+    counts_ = 1.0;
+    packed_data_current_ = true;
   }
 
   //======================================================================
@@ -199,7 +244,8 @@ namespace BOOM {
 
   GCSUF::GammaRegressionConditionalSuf()
       : xdim_(-1),
-        nrow_(0)
+        nrow_(0),
+        packed_current_(false)
   {}
 
   GCSUF * GCSUF::clone() const {return new GCSUF(*this);}
@@ -211,6 +257,7 @@ namespace BOOM {
 
   void GCSUF::clear() {
     suf_.clear();
+    packed_current_ = false;
   }
 
   Vector GCSUF::vectorize(bool minimal) const {
@@ -227,6 +274,7 @@ namespace BOOM {
     if (nrow_ < 0 || xdim_ < 0) {
       report_error("Must call set_dimensions() before calling unvectorize().");
     }
+    packed_current_ = false;
     for (int i = 0; i < nrow_; ++i) {
       Vector v(it, it + xdim_);
       it += xdim_;
@@ -261,6 +309,7 @@ namespace BOOM {
   }
 
   void GCSUF::combine(const GCSUF &rhs) {
+    packed_current_ = false;
     for (const auto &el : rhs.suf_) {
       if (!suf_[el.first]) {
         suf_[el.first->clone()] = el.second->clone();
@@ -284,6 +333,7 @@ namespace BOOM {
   }
 
   Ptr<GammaSuf> GCSUF::get(Ptr<VectorData> predictors) {
+    packed_current_ = false;
     if (xdim_ < 0) {
       xdim_ = predictors->dim();
     } else {
@@ -300,6 +350,45 @@ namespace BOOM {
     return suf;
   }
 
+  const Matrix &GCSUF::design() const {
+    pack();
+    return design_;
+  }
+
+  const Vector &GCSUF::counts() const {
+    pack();
+    return counts_;
+  }
+
+  const Vector &GCSUF::sums() const {
+    pack();
+    return sums_;
+  }
+
+  const Vector &GCSUF::sumlogs() const {
+    pack();
+    return sumlogs_;
+  }
+
+  void GCSUF::pack() const {
+    if (packed_current_) return;
+    int nrow = suf_.size();
+    int xdim = nrow > 0 ? suf_.begin()->first->dim() : std::max(xdim_, 0);
+    design_.resize(nrow, xdim);
+    counts_.resize(nrow);
+    sums_.resize(nrow);
+    sumlogs_.resize(nrow);
+    int i = 0;
+    for (const auto &el : suf_) {
+      design_.row(i) = el.first->value();
+      counts_[i] = el.second->n();
+      sums_[i] = el.second->sum();
+      sumlogs_[i] = el.second->sumlog();
+      ++i;
+    }
+    packed_current_ = true;
+  }
+
   //======================================================================
   GRMCS::GammaRegressionModelConditionalSuf(
       int xdim)
@@ -328,39 +417,10 @@ namespace BOOM {
       Vector &gradient,
       Matrix &Hessian,
       uint nd) const {
-    double ans = 0;
-    double alpha = alpha_beta[0];
-    double log_alpha = log(alpha);
-    double lgamma_alpha = lgamma(alpha);
-    ConstVectorView beta(alpha_beta, 1);
-    bool all_coefficients_included = (xdim() == beta.size());
-    const Selector &inc(coef().inc());
-
-    double digamma_alpha, trigamma_alpha;
-    initialize_log_likelihood_computation(
-        alpha_beta, gradient, Hessian, nd, digamma_alpha, trigamma_alpha);
-    for (const auto &el : suf()->map()) {
-      const Vector &x(el.first->value());
-      Vector reduced_x;
-      if (!all_coefficients_included) {
-        reduced_x = inc.select(x);
-      }
-      ConstVectorView X(all_coefficients_included ? x : reduced_x);
-
-      double eta = beta.dot(X);
-      double mu = exp(eta);
-      double sumy = el.second->sum();
-      double sumlogy = el.second->sumlog();
-      double n = el.second->n();
-      increment_loglike(
-          ans, gradient, Hessian, nd, X, sumy, sumlogy, n, eta, mu,
-          alpha, log_alpha, lgamma_alpha, digamma_alpha, trigamma_alpha);
-    }
-    if (nd > 1) {
-      // Reflect the first row into the first column before returning.
-      Hessian.col(0) = Hessian.row(0);
-    }
-    return ans;
+    const GammaRegressionConditionalSuf &data(*suf());
+    return packed_gamma_log_likelihood(
+        data.design(), data.counts(), data.sums(), data.sumlogs(),
+        alpha_beta, coef().inc(), gradient, Hessian, nd);
   }
 
   void GRMCS::increment_sufficient_statistics(
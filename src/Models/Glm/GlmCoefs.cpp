@@ -94,23 +94,33 @@ namespace BOOM{
 
   bool GlmCoefs::inc(uint p)const{ return inc_[p];}
 
+  // Changes to the set of included coefficients change predictions,
+  // so they are signalled to observers (e.g. caches of x * beta)
+  // just like changes to the coefficient values.
   void GlmCoefs::set_inc(const Selector &new_inc){
     assert(new_inc.nvars_possible() == inc_.nvars_possible());
+    if(new_inc == inc_) return;
     uint n = nvars();
     for(uint i=0; i<n; ++i){
       uint I = indx(i);
       if(!new_inc[I]) Beta(I)=0;
     }
     inc_ = new_inc;
+    signal();
   }
 
   void GlmCoefs::add(uint i){
     included_coefficients_current_ = false;
-    inc_.add(i); }
+    if(inc_[i]) return;
+    inc_.add(i);
+    signal();
+  }
 
   void GlmCoefs::drop(uint i){
+    bool was_included = inc_[i];
     inc_.drop(i);
     Beta(i)=0;
+    if(was_included) signal();
   }
 
   void GlmCoefs::flip(uint i){
@@ -124,7 +134,10 @@ namespace BOOM{
   }
 
   void GlmCoefs::add_all(){
+    if(inc_.nvars() == inc_.nvars_possible()) return;
+    included_coefficients_current_ = false;
     inc_.add_all();
+    signal();
   }
 
   //------------------- size querries ----------------
@@ -0,0 +1,122 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/Glm/GlmDerivativeKernels.hpp>
+#include <LinAlg/blas.hpp>
+#include <cpputil/report_error.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace BOOM {
+
+  namespace {
+    // Number of rows of the design matrix processed at a time.  Small
+    // enough that a block of scaled rows stays in cache.
+    const int kBlockSize = 256;
+
+    // Fill 'block' with rows begin, ..., begin + nrow - 1 of X, with
+    // row i multiplied by scale[i].  Only the first nrow rows of block
+    // are written.
+    void fill_scaled_block(const Matrix &X, const Vector &scale,
+                           int begin, int nrow, Matrix &block) {
+      int n = X.nrow();
+      int stride = block.nrow();
+      for (int j = 0; j < X.ncol(); ++j) {
+        const double *x = X.data() + j * n + begin;
+        double *b = block.data() + j * stride;
+        for (int i = 0; i < nrow; ++i) {
+          b[i] = x[i] * scale[begin + i];
+        }
+      }
+    }
+  }  // namespace
+
+  const Matrix &included_columns(const Matrix &X,
+                                 const Selector &inc,
+                                 Matrix &workspace) {
+    if (inc.nvars() == inc.nvars_possible()) {
+      return X;
+    }
+    workspace = inc.select_cols(X);
+    return workspace;
+  }
+
+  SpdMatrix weighted_inner_product(const Matrix &X, const Vector &weights) {
+    if (weights.size() != X.nrow()) {
+      report_error("Weights and design matrix do not conform in "
+                   "weighted_inner_product.");
+    }
+    int n = X.nrow();
+    int p = X.ncol();
+    SpdMatrix ans(p, 0.0);
+    if (n == 0 || p == 0) return ans;
+    bool nonnegative = true;
+    bool nonpositive = true;
+    for (int i = 0; i < n; ++i) {
+      nonnegative = nonnegative && weights[i] >= 0;
+      nonpositive = nonpositive && weights[i] <= 0;
+    }
+    Matrix block(std::min(n, kBlockSize), p);
+    if (nonnegative || nonpositive) {
+      // X^T W X = +/- (|W|^{1/2} X)^T (|W|^{1/2} X), which dsyrk
+      // evaluates at half the cost of a general matrix product.
+      Vector root_weights(n);
+      for (int i = 0; i < n; ++i) {
+        root_weights[i] = sqrt(fabs(weights[i]));
+      }
+      for (int begin = 0; begin < n; begin += kBlockSize) {
+        int nrow = std::min(kBlockSize, n - begin);
+        fill_scaled_block(X, root_weights, begin, nrow, block);
+        blas::dsyrk(blas::Upper, blas::Trans, p, nrow,
+                    nonnegative ? 1.0 : -1.0, block.data(), block.nrow(),
+                    1.0, ans.data(), p);
+      }
+    } else {
+      for (int begin = 0; begin < n; begin += kBlockSize) {
+        int nrow = std::min(kBlockSize, n - begin);
+        fill_scaled_block(X, weights, begin, nrow, block);
+        blas::dgemm(blas::Trans, blas::NoTrans, p, p, nrow, 1.0,
+                    X.data() + begin, n, block.data(), block.nrow(),
+                    1.0, ans.data(), p);
+      }
+    }
+    ans.reflect();
+    return ans;
+  }
+
+  Matrix weighted_cross_product(const Matrix &X,
+                                const Vector &weights,
+                                const Matrix &Y) {
+    if (weights.size() != X.nrow() || Y.nrow() != X.nrow()) {
+      report_error("Arguments do not conform in weighted_cross_product.");
+    }
+    int n = X.nrow();
+    Matrix ans(X.ncol(), Y.ncol(), 0.0);
+    if (n == 0 || X.ncol() == 0 || Y.ncol() == 0) return ans;
+    Matrix block(std::min(n, kBlockSize), Y.ncol());
+    for (int begin = 0; begin < n; begin += kBlockSize) {
+      int nrow = std::min(kBlockSize, n - begin);
+      fill_scaled_block(Y, weights, begin, nrow, block);
+      blas::dgemm(blas::Trans, blas::NoTrans, X.ncol(), Y.ncol(), nrow, 1.0,
+                  X.data() + begin, n, block.data(), block.nrow(),
+                  1.0, ans.data(), X.ncol());
+    }
+    return ans;
+  }
+
+}  // namespace BOOM
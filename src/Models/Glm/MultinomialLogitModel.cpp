@@ -20,6 +20,7 @@
 #include <functional>
 
 #include <LinAlg/VectorView.hpp>
+#include <LinAlg/blas.hpp>
 #include <Models/Glm/PosteriorSamplers/MLVS.hpp>
 #include <Models/MvnBase.hpp>
 #include <TargetFun/LogPost.hpp>
@@ -130,6 +131,7 @@ namespace BOOM{
       DataPolicy(rhs),
       PriorPolicy(rhs),
       NumOptModel(rhs),
+      packed_design_current_(false),
       wsp_(rhs.wsp_),
       nch_(rhs.nch_),
       psub_(rhs.psub_),
@@ -141,6 +143,20 @@ namespace BOOM{
   //------------------------------------------------------------
   MLM * MLM::clone() const {return new MLM(*this);}
   //------------------------------------------------------------
+  void MLM::add_data(Ptr<Data> dp) {
+    add_data(DAT(dp));
+  }
+
+  void MLM::add_data(Ptr<ChoiceData> dp) {
+    packed_design_current_ = false;
+    DataPolicy::add_data(dp);
+  }
+
+  void MLM::clear_data() {
+    packed_design_current_ = false;
+    DataPolicy::clear_data();
+  }
+  //------------------------------------------------------------
   const Vector & MLM::beta() const { return coef().Beta();}
   //------------------------------------------------------------
   const Vector & MLM::beta_with_zeros() const {
@@ -197,6 +213,9 @@ namespace BOOM{
                              Vector &g,
                              Matrix &h,
                              int nd) const {
+    if (nd <= 1) {
+      return packed_log_likelihood(beta, g, nd);
+    }
     const std::vector<Ptr<ChoiceData> > & d(dat());
     double ans = 0;
     uint nobs = d.size();
@@ -244,6 +263,92 @@ namespace BOOM{
     return ans;
   }
 
+  //------------------------------------------------------------
+  // The linear predictors for the whole data set are computed at once
+  // by fill_eta_matrix.  The normalizing constants are then computed
+  // column by column, so the inner loops run over contiguous memory.
+  // The gradient is X^T (y - p), where y is the indicator matrix of
+  // the responses and p the matrix of choice probabilities.  In the
+  // packed layout this is a matrix-matrix product for the subject
+  // coefficients and a matrix-vector product for the choice
+  // coefficients.
+  double MLM::packed_log_likelihood(const Vector &beta,
+                                    Vector &g,
+                                    int nd) const {
+    const std::vector<Ptr<ChoiceData> > &d(dat());
+    int n = d.size();
+    int M = Nchoices();
+    int psub = subject_nvars();
+    int pch = choice_nvars();
+    const Selector &included(inc());
+    if (nd > 0) {
+      g.resize(included.nvars());
+      g = 0;
+    }
+    if (n == 0) return 0;
+
+    Matrix eta;
+    fill_eta_matrix(beta, eta);
+    if (log_sampling_probs().size() == M) {
+      for (int m = 0; m < M; ++m) {
+        eta.col(m) += log_sampling_probs()[m];
+      }
+    }
+
+    // lognc[i] = log(sum_m(exp(eta(i, m)))), computed stably.
+    Vector lognc(eta.col(0));
+    for (int m = 1; m < M; ++m) {
+      const double *eta_m = eta.data() + m * n;
+      for (int i = 0; i < n; ++i) {
+        if (eta_m[i] > lognc[i]) lognc[i] = eta_m[i];
+      }
+    }
+    Vector sum_exp(n, 0.0);
+    for (int m = 0; m < M; ++m) {
+      const double *eta_m = eta.data() + m * n;
+      for (int i = 0; i < n; ++i) {
+        sum_exp[i] += exp(eta_m[i] - lognc[i]);
+      }
+    }
+    double ans = 0;
+    for (int i = 0; i < n; ++i) {
+      lognc[i] += log(sum_exp[i]);
+      ans += eta(i, d[i]->value()) - lognc[i];
+    }
+    if (nd <= 0) return ans;
+
+    // Overwrite eta with the residual matrix y - p.
+    for (int m = 0; m < M; ++m) {
+      double *eta_m = eta.data() + m * n;
+      for (int i = 0; i < n; ++i) {
+        eta_m[i] = -exp(eta_m[i] - lognc[i]);
+      }
+    }
+    for (int i = 0; i < n; ++i) {
+      eta(i, d[i]->value()) += 1.0;
+    }
+
+    Vector full_gradient(beta_size(false), 0.0);
+    if (psub > 0 && M > 1) {
+      blas::dgemm(blas::Trans, blas::NoTrans, psub, M - 1, n,
+                  1.0, subject_design_.data(), n,
+                  eta.data() + n, n,
+                  0.0, full_gradient.data(), psub);
+    }
+    if (pch > 0) {
+      blas::dgemv(blas::Trans, n * M, pch,
+                  1.0, choice_design_.data(), n * M,
+                  eta.data(), 1,
+                  0.0, full_gradient.data() + (M - 1) * psub, 1);
+    }
+    if (included.nvars_excluded() == 0) {
+      g = full_gradient;
+    } else {
+      g = included.select(full_gradient);
+    }
+    return ans;
+  }
+
   //------------------------------------------------------------
   double MLM::Loglike(const Vector &beta, Vector &g, Matrix &h, uint nd) const {
     return log_likelihood(beta, g, h, nd);
@@ -295,11 +400,23 @@ namespace BOOM{
     uint M = Nchoices();
     ans.resize(M);
     const Selector &included(inc());
-    const Matrix &X(dp.X(false));
     if (included.nvars_excluded() == 0) {
-      ans = X * beta;
+      // Work directly from the subject and choice predictors, rather
+      // than forming the M x beta_size() matrix dp.X(), which is
+      // mostly zeros.
+      uint psub = subject_nvars();
+      uint pch = choice_nvars();
+      const Vector &xsub(dp.Xsubject());
+      ConstVectorView beta_choice(beta, (M - 1) * psub, pch);
+      for (uint m = 0; m < M; ++m) {
+        ans[m] = m == 0 ? 0.0 :
+            xsub.dot(ConstVectorView(beta, (m - 1) * psub, psub));
+        if (pch > 0) {
+          ans[m] += beta_choice.dot(dp.Xchoice(m));
+        }
+      }
     } else {
-      included.sparse_multiply(X, beta, VectorView(ans));
+      included.sparse_multiply(dp.X(false), beta, VectorView(ans));
     }
     // TODO(stevescott): handle restricted choice sets and include an
     // offset.
@@ -310,6 +427,68 @@ namespace BOOM{
     return fill_eta(dp, ans, beta());
   }
 
+  //------------------------------------------------------------
+  void MLM::fill_eta_matrix(const Vector &beta, Matrix &eta) const {
+    if (!packed_design_current_) refresh_packed_design();
+    int n = dat().size();
+    int M = Nchoices();
+    int psub = subject_nvars();
+    int pch = choice_nvars();
+    const Selector &included(inc());
+    Vector full_beta;
+    const Vector *b = &beta;
+    if (included.nvars_excluded() > 0) {
+      full_beta = included.expand(
+          beta.size() == included.nvars() ? beta : included.select(beta));
+      b = &full_beta;
+    } else if (beta.size() != beta_size(false)) {
+      report_error("Wrong size coefficient vector passed to "
+                   "MultinomialLogitModel::fill_eta_matrix.");
+    }
+    eta.resize(n, M);
+    eta = 0.0;
+    if (n == 0) return;
+    if (psub > 0 && M > 1) {
+      blas::dgemm(blas::NoTrans, blas::NoTrans, n, M - 1, psub,
+                  1.0, subject_design_.data(), n,
+                  b->data(), psub,
+                  0.0, eta.data() + n, n);
+    }
+    if (pch > 0) {
+      blas::dgemv(blas::NoTrans, n * M, pch,
+                  1.0, choice_design_.data(), n * M,
+                  b->data() + (M - 1) * psub, 1,
+                  1.0, eta.data(), 1);
+    }
+  }
+
+  //------------------------------------------------------------
+  void MLM::refresh_packed_design() const {
+    const std::vector<Ptr<ChoiceData>> &d(dat());
+    int n = d.size();
+    int M = Nchoices();
+    int psub = subject_nvars();
+    int pch = choice_nvars();
+    subject_design_.resize(n, psub);
+    choice_design_.resize(n * M, pch);
+    for (int i = 0; i < n; ++i) {
+      const ChoiceData &dp(*d[i]);
+      if (dp.nchoices() != M) {
+        report_error("All observations in a MultinomialLogitModel must "
+                     "have the same number of choices.");
+      }
+      if (psub > 0) {
+        subject_design_.row(i) = dp.Xsubject();
+      }
+      if (pch > 0) {
+        for (int m = 0; m < M; ++m) {
+          choice_design_.row(m * n + i) = dp.Xchoice(m);
+        }
+      }
+    }
+    packed_design_current_ = true;
+  }
+
   //------------------------------------------------------------
   double MLM::pdf(Ptr<Data> dp, bool logscale) const {
     double ans = logp(*DAT(dp));
@@ -384,6 +563,7 @@ namespace BOOM{
     ParamPolicy::set_prm(new GlmCoefs(beta_size(false)));
     setup_observers();
     beta_with_zeros_current_=false;
+    packed_design_current_ = false;
   }
 
   //------------------------------------------------------------
@@ -297,7 +297,7 @@ namespace BOOM{
     Vector b;
     double mean,v;
     rsw_mv(mean,v,b,u,wsp, siginv, y);
-    u[y] = rtrun_norm(mean, sqrt(v), second_largest, true);
+    u[y] = rtrun_norm_mt(rng, mean, sqrt(v), second_largest, true);
     for(uint i=0; i<dp->nchoices(); ++i){
       if(i!=y){
 	rsw_mv(mean,v,b,u,wsp,siginv,i);
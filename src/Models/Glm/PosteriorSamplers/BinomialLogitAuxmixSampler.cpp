@@ -71,6 +71,13 @@ namespace BOOM {
       ++sample_size_;
     }
 
+    void SufficientStatistics::update(
+        const WeightedCrossProductBuffer &buffer) {
+      sym_ = false;
+      buffer.accumulate(xtx_, xty_);
+      sample_size_ += buffer.size();
+    }
+
     ImputeWorker::ImputeWorker(SufficientStatistics &global_suf,
                                std::mutex &global_suf_mutex,
                                int clt_threshold,
@@ -80,7 +87,16 @@ namespace BOOM {
         : SufstatImputeWorker<BinomialRegressionData, SufficientStatistics>(
               global_suf, global_suf_mutex, rng, seeding_rng),
           binomial_data_imputer_(clt_threshold),
-          coefficients_(coef)
+          coefficients_(coef),
+          buffer_(coef->nvars_possible()),
+          block_predictors_(buffer_.capacity(), nullptr),
+          block_trials_(buffer_.capacity()),
+          block_successes_(buffer_.capacity()),
+          block_log_odds_(buffer_.capacity()),
+          block_weighted_sums_(buffer_.capacity()),
+          block_weights_(buffer_.capacity()),
+          block_size_(0),
+          block_rng_(nullptr)
     {}
 
     void ImputeWorker::impute_latent_data_point(
@@ -88,27 +104,55 @@ namespace BOOM {
         SufficientStatistics *suf,
         RNG &rng) {
       const Vector &x(observation.x());
-      double eta = coefficients_->predict(x);
-      double sum, weight;
+      block_predictors_[block_size_] = &x;
+      block_trials_[block_size_] = observation.n();
+      block_successes_[block_size_] = observation.y();
+      block_log_odds_[block_size_] = coefficients_->predict(x);
+      block_rng_ = &rng;
+      if (++block_size_ == block_predictors_.size()) {
+        impute_block(suf, rng);
+      }
+    }
+
+    void ImputeWorker::finalize_latent_data(SufficientStatistics *suf) {
+      if (block_size_ > 0) {
+        impute_block(suf, *block_rng_);
+      }
+    }
+
+    void ImputeWorker::impute_block(SufficientStatistics *suf, RNG &rng) {
       try {
-        std::pair<double, double> imputed = binomial_data_imputer_.impute(
+        binomial_data_imputer_.impute_batch(
             rng,
-            observation.n(),
-            observation.y(),
-            eta);
-        sum = imputed.first;
-        weight = imputed.second;
-        suf->update(x, sum, weight);
+            ConstVectorView(block_trials_.data(), block_size_, 1),
+            ConstVectorView(block_successes_.data(), block_size_, 1),
+            ConstVectorView(block_log_odds_.data(), block_size_, 1),
+            VectorView(block_weighted_sums_.data(), block_size_, 1),
+            VectorView(block_weights_.data(), block_size_, 1));
       } catch(std::exception &e) {
         ostringstream err;
-        err << "caught an exception "
+        err << "caught an exception while imputing a block of "
+            << block_size_ << " observations, "
             << "with the following message:"
-            << e.what() << endl
-            << "n   = " << observation.n() << endl
-            << "y   = " << observation.y() << endl
-            << "eta = " << eta << endl;
+            << e.what() << endl;
+        // Discard the block so the worker is usable on the next pass.
+        block_size_ = 0;
+        buffer_.clear();
         report_error(err.str());
       }
+      for (int i = 0; i < block_size_; ++i) {
+        double weight = block_weights_[i];
+        if (weight > 0) {
+          buffer_.add(*block_predictors_[i],
+                      block_weighted_sums_[i] / weight,
+                      weight);
+        } else {
+          suf->update(*block_predictors_[i], block_weighted_sums_[i], weight);
+        }
+      }
+      suf->update(buffer_);
+      buffer_.clear();
+      block_size_ = 0;
     }
   }  // namespace BinomialLogit
 
@@ -20,10 +20,59 @@
 #include <distributions.hpp>
 #include <Samplers/TIM.hpp>
 #include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
 
 #include <ctime>
 
 namespace BOOM{
+  namespace {
+    // Returns the dot product of beta_chunk with the elements of x at
+    // the given positions.
+    inline double chunk_dot(const Vector &x,
+                            const std::vector<int> &positions,
+                            const ConstVectorView &beta_chunk) {
+      double ans = 0;
+      for (int j = 0; j < positions.size(); ++j) {
+        ans += x[positions[j]] * beta_chunk[j];
+      }
+      return ans;
+    }
+
+    // The positions in the full predictor vector of included
+    // coefficients start, ..., start + size - 1.
+    std::vector<int> chunk_positions(const Selector &inc, int start, int size) {
+      std::vector<int> ans(size);
+      for (int j = 0; j < size; ++j) {
+        ans[j] = inc.indx(start + j);
+      }
+      return ans;
+    }
+  }  // namespace
+
+  BinomialLogitLogPostChunk::BinomialLogitLogPostChunk(
+      const BinomialLogitModel *model,
+      const MvnBase *prior,
+      int chunk_size,
+      int chunk_number,
+      const Vector &linear_predictor)
+      : BinomialLogitLogPostChunk(model, prior, chunk_size, chunk_number)
+  {
+    const std::vector<Ptr<BinomialRegressionData> > &data(m_->dat());
+    if (linear_predictor.size() != data.size()) {
+      report_error("The linear predictor passed to BinomialLogitLogPostChunk "
+                   "does not match the number of observations.");
+    }
+    use_linear_predictor_ = true;
+    chunk_positions_ = chunk_positions(m_->coef().inc(), start_, chunk_size_);
+    Vector beta = m_->included_coefficients();
+    ConstVectorView current_chunk(beta, start_, chunk_size_);
+    linear_predictor_offset_ = linear_predictor;
+    for (int i = 0; i < data.size(); ++i) {
+      linear_predictor_offset_[i] -=
+          chunk_dot(data[i]->x(), chunk_positions_, current_chunk);
+    }
+  }
+  //----------------------------------------------------------------------
   double BinomialLogitLogPostChunk::operator()(const Vector &beta_chunk)const{
     Vector g;
     Matrix h;
@@ -51,6 +100,9 @@ namespace BOOM{
         hess *= -1;
       }
     }
+    if (use_linear_predictor_) {
+      return ans + cached_log_likelihood(beta_chunk, grad, hess, nd);
+    }
 
     int nobs = data.size();
     for(int i = 0; i < nobs; ++i){
@@ -71,6 +123,46 @@ namespace BOOM{
     return ans;
   }
   //----------------------------------------------------------------------
+  double BinomialLogitLogPostChunk::cached_log_likelihood(
+      const Vector &beta_chunk, Vector &grad, Matrix &hess, int nd)const{
+    const std::vector<Ptr<BinomialRegressionData> > &data(m_->dat());
+    double ans = 0;
+    Vector x_chunk(chunk_size_);
+    for (int i = 0; i < data.size(); ++i) {
+      const Vector &x(data[i]->x());
+      double yi = data[i]->y();
+      double ni = data[i]->n();
+      double eta = linear_predictor_offset_[i]
+          + chunk_dot(x, chunk_positions_, beta_chunk);
+      double prob = plogis(eta);
+      ans += dbinom(yi, ni, prob, true);
+      if (nd > 0) {
+        for (int j = 0; j < chunk_size_; ++j) {
+          x_chunk[j] = x[chunk_positions_[j]];
+        }
+        grad.axpy(x_chunk, yi - ni * prob);
+        if (nd > 1) {
+          hess.add_outer(x_chunk, x_chunk, -ni * prob * (1 - prob));
+        }
+      }
+    }
+    return ans;
+  }
+  //----------------------------------------------------------------------
+  void BinomialLogitLogPostChunk::fill_linear_predictor(
+      const ConstVectorView &beta_chunk, Vector &eta) const {
+    if (!use_linear_predictor_) {
+      report_error("fill_linear_predictor requires a BinomialLogitLogPostChunk "
+                   "built from a linear predictor.");
+    }
+    const std::vector<Ptr<BinomialRegressionData> > &data(m_->dat());
+    eta.resize(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+      eta[i] = linear_predictor_offset_[i]
+          + chunk_dot(data[i]->x(), chunk_positions_, beta_chunk);
+    }
+  }
+  //----------------------------------------------------------------------
   typedef BinomialLogitCompositeSpikeSlabSampler BLCSSS;
   BLCSSS::BinomialLogitCompositeSpikeSlabSampler(
       BinomialLogitModel *model,
@@ -126,6 +218,7 @@ namespace BOOM{
   //----------------------------------------------------------------------
   void BLCSSS::rwm_draw(){
     if(m_->coef().nvars() == 0) return;
+    refresh_linear_predictor();
     int total_number_of_chunks = compute_number_of_chunks(max_rwm_chunk_size_);
     for(int chunk = 0; chunk < total_number_of_chunks; ++chunk) {
       rwm_draw_chunk(chunk);
@@ -133,6 +226,7 @@ namespace BOOM{
   }
   //----------------------------------------------------------------------
   void BLCSSS::rwm_draw_chunk(int chunk){
+    ensure_linear_predictor_is_current();
     const Selector &inc(m_->coef().inc());
     int nvars = inc.nvars();
     Vector full_nonzero_beta = m_->included_coefficients();
@@ -155,19 +249,24 @@ namespace BOOM{
     }
 
     SpdMatrix proposal_ivar = chunk_selector.select(siginv);
+    std::vector<int> positions =
+        chunk_positions(inc, chunk_start, this_chunk_size);
 
+    Vector x_chunk(this_chunk_size);
     for(int i = 0; i < nobs; ++i){
-      Vector x = inc.select(data[i]->x());
-      double eta = x.dot(full_nonzero_beta);
-      double prob = plogis(eta);
+      const Vector &x(data[i]->x());
+      for (int j = 0; j < this_chunk_size; ++j) {
+        x_chunk[j] = x[positions[j]];
+      }
+      double prob = plogis(linear_predictor_[i]);
       double weight = prob * (1-prob);
-      VectorView x_chunk(x, chunk_start, this_chunk_size);
       // Only upper triangle is accessed.  Need to reflect at end of loop.
       proposal_ivar.add_outer(x_chunk, weight, false);
       original_logpost += dbinom(data[i]->y(), data[i]->n(), prob, true);
     }
     proposal_ivar.reflect();
     VectorView beta_chunk(full_nonzero_beta, chunk_start, this_chunk_size);
+    Vector original_beta_chunk(beta_chunk);
     if(tdf_ > 0){
       beta_chunk = rmvt_ivar_mt(
           rng(), beta_chunk, proposal_ivar / rwm_variance_scale_factor_, tdf_);
@@ -176,13 +275,22 @@ namespace BOOM{
           rng(), beta_chunk, proposal_ivar / rwm_variance_scale_factor_);
     }
 
+    // The candidate differs from the current value only in the chunk,
+    // so its linear predictor is an update of the cached one.
+    Vector delta = beta_chunk - original_beta_chunk;
+    Vector candidate_linear_predictor(linear_predictor_);
     double logpost = dmvn(full_nonzero_beta, mu, siginv, 0, true);
-    Vector full_beta(inc.expand(full_nonzero_beta));
-    logpost += m_->log_likelihood(full_beta, 0, 0, false);
+    for (int i = 0; i < nobs; ++i) {
+      candidate_linear_predictor[i] += chunk_dot(data[i]->x(), positions, delta);
+      logpost += dbinom(data[i]->y(), data[i]->n(),
+                        plogis(candidate_linear_predictor[i]), true);
+    }
     double log_alpha = logpost - original_logpost;
     double logu = log(runif_mt(rng()));
     if (logu < log_alpha) {
       m_->set_included_coefficients(full_nonzero_beta);
+      linear_predictor_.swap(candidate_linear_predictor);
+      linear_predictor_coefficients_ = m_->Beta();
       move_accounting_.record_acceptance("rwm_chunk");
     } else {
       move_accounting_.record_rejection("rwm_chunk");
@@ -196,10 +304,13 @@ namespace BOOM{
     int chunk_size = compute_chunk_size(max_tim_chunk_size_);
     int number_of_chunks = compute_number_of_chunks(max_tim_chunk_size_);
     assert(number_of_chunks * chunk_size >= nvars);
+    refresh_linear_predictor();
 
     for(int chunk = 0; chunk < number_of_chunks; ++chunk) {
       clock_t mode_start = clock();
-      TIM tim_sampler(log_posterior(chunk, max_tim_chunk_size_), tdf_, &rng());
+      BinomialLogitLogPostChunk logpost(
+          m_, pri_.get(), chunk_size, chunk, linear_predictor_);
+      TIM tim_sampler(logpost, tdf_, &rng());
       Vector beta = m_->included_coefficients();
       int start = chunk_size * chunk;
       int elements_remaining = nvars - start;
@@ -215,6 +326,8 @@ namespace BOOM{
         beta_chunk = tim_sampler.draw(beta_chunk);
         m_->set_included_coefficients(beta);
         if (tim_sampler.last_draw_was_accepted()) {
+          logpost.fill_linear_predictor(beta_chunk, linear_predictor_);
+          linear_predictor_coefficients_ = m_->Beta();
           move_accounting_.record_acceptance("TIM chunk");
         } else {
           move_accounting_.record_rejection("TIM chunk");
@@ -251,6 +364,22 @@ namespace BOOM{
     sampler_weights_ /= sum(sampler_weights_);
   }
   //----------------------------------------------------------------------
+  void BLCSSS::refresh_linear_predictor() {
+    const std::vector<Ptr<BinomialRegressionData> > &data(m_->dat());
+    linear_predictor_.resize(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+      linear_predictor_[i] = m_->predict(data[i]->x());
+    }
+    linear_predictor_coefficients_ = m_->Beta();
+  }
+  //----------------------------------------------------------------------
+  void BLCSSS::ensure_linear_predictor_is_current() {
+    if (linear_predictor_.size() != m_->dat().size()
+        || !(linear_predictor_coefficients_ == m_->Beta())) {
+      refresh_linear_predictor();
+    }
+  }
+  //----------------------------------------------------------------------
   int BLCSSS::compute_chunk_size(int max_chunk_size)const{
     int nvars = m_->coef().nvars();
     if(max_chunk_size <= 0) return nvars;
@@ -21,6 +21,8 @@
 #include <distributions/trun_logit.hpp>
 #include <cpputil/math_utils.hpp>
 #include <cpputil/report_error.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace BOOM {
 
@@ -37,6 +39,146 @@ namespace BOOM {
              "0.105680086433879 0.345939491553619 0.0442261124345564 "
              "0.193289780660134 0.068173066865908 0.00452437089387876"));
 
+  namespace {
+    // The mixture_approximation is a zero-mean scale mixture, so the
+    // log of the (unnormalized) posterior probability of mixture
+    // component s given a latent logit u is
+    //
+    //    log_constant[s] - half_precision[s] * u^2.
+    //
+    // Storing these constants avoids the per-trial logs and the
+    // temporary Vector used by NormalMixtureApproximation::unmix().
+    class LogisticMixtureTable {
+     public:
+      explicit LogisticMixtureTable(
+          const NormalMixtureApproximation &approximation)
+          : log_constant_(approximation.dim()),
+            half_precision_(approximation.dim()),
+            variance_(approximation.dim())
+      {
+        const Vector &sigma(approximation.sigma());
+        const Vector &log_weights(approximation.log_weights());
+        for (int s = 0; s < approximation.dim(); ++s) {
+          log_constant_[s] = log_weights[s] - std::log(sigma[s]);
+          variance_[s] = square(sigma[s]);
+          half_precision_[s] = 0.5 / variance_[s];
+        }
+      }
+
+      int dim() const {return log_constant_.size();}
+
+      // Draw the variance of the mixture component responsible for
+      // the latent logit u.  'workspace' must have at least dim()
+      // elements.
+      double draw_variance(RNG &rng, double u, double *workspace) const {
+        const int dim = log_constant_.size();
+        const double *log_constant = log_constant_.data();
+        const double *half_precision = half_precision_.data();
+        const double u2 = u * u;
+        double max_log_prob = negative_infinity();
+        for (int s = 0; s < dim; ++s) {
+          workspace[s] = log_constant[s] - half_precision[s] * u2;
+          max_log_prob = std::max(max_log_prob, workspace[s]);
+        }
+        double total = 0;
+        for (int s = 0; s < dim; ++s) {
+          workspace[s] = std::exp(workspace[s] - max_log_prob);
+          total += workspace[s];
+        }
+        double target = runif_mt(rng, 0, total);
+        double cumulative = 0;
+        for (int s = 0; s < dim; ++s) {
+          cumulative += workspace[s];
+          if (target <= cumulative) return variance_[s];
+        }
+        return variance_.back();
+      }
+
+     private:
+      std::vector<double> log_constant_;
+      std::vector<double> half_precision_;
+      std::vector<double> variance_;
+    };
+
+    const LogisticMixtureTable &logistic_mixture_table() {
+      static const LogisticMixtureTable table(
+          BinomialLogitDataImputer::mixture_approximation);
+      return table;
+    }
+  }  // namespace
+
+  //----------------------------------------------------------------------
+  void BinomialLogitDataImputer::impute_batch(
+      RNG &rng,
+      const ConstVectorView &number_of_trials,
+      const ConstVectorView &number_of_successes,
+      const ConstVectorView &log_odds,
+      VectorView information_weighted_sum,
+      VectorView information) const {
+    int n = number_of_trials.size();
+    if (number_of_successes.size() != n
+        || log_odds.size() != n
+        || information_weighted_sum.size() != n
+        || information.size() != n) {
+      report_error("All arguments to BinomialLogitDataImputer::impute_batch "
+                   "must have the same size.");
+    }
+    std::vector<double> workspace;
+    for (int i = 0; i < n; ++i) {
+      if (number_of_successes[i] > number_of_trials[i]
+          || number_of_successes[i] < 0) {
+        ostringstream err;
+        err << "Illegal data in observation " << i << " of a batch in "
+            << "BinomialLogitDataImputer::impute_batch()." << endl;
+        debug_status_message(
+            err, number_of_trials[i], number_of_successes[i], log_odds[i]);
+        report_error(err.str());
+      }
+      std::pair<double, double> imputed =
+          imputes_individual_trials(number_of_trials[i]) ?
+          impute_individual_trials(rng,
+                                   number_of_trials[i],
+                                   number_of_successes[i],
+                                   log_odds[i],
+                                   workspace) :
+          impute(rng,
+                 number_of_trials[i],
+                 number_of_successes[i],
+                 log_odds[i]);
+      information_weighted_sum[i] = imputed.first;
+      information[i] = imputed.second;
+    }
+  }
+
+  //----------------------------------------------------------------------
+  std::pair<double, double> BinomialLogitDataImputer::impute_individual_trials(
+      RNG &rng,
+      double number_of_trials,
+      double number_of_successes,
+      double log_odds,
+      std::vector<double> &workspace) const {
+    const LogisticMixtureTable &table(logistic_mixture_table());
+    if (workspace.size() < table.dim()) {
+      workspace.resize(table.dim());
+    }
+    // The latent logits are drawn as in rtrun_logit_mt, with the
+    // truncation probability computed once per observation.
+    double cutpoint_prob = plogis(-log_odds);
+    double information_weighted_sum = 0;
+    double information = 0;
+    for (int i = 0; i < number_of_trials; ++i) {
+      bool success = i < number_of_successes;
+      double uniform = success ? runif_mt(rng, cutpoint_prob, 1)
+          : runif_mt(rng, 0, cutpoint_prob);
+      double latent_logit = qlogis(uniform) + log_odds;
+      double current_weight = 1.0 / table.draw_variance(
+          rng, latent_logit - log_odds, workspace.data());
+      information += current_weight;
+      information_weighted_sum += latent_logit * current_weight;
+    }
+    return std::make_pair(information_weighted_sum, information);
+  }
+
   //----------------------------------------------------------------------
   void BinomialLogitDataImputer::debug_status_message(
       ostream &out,
@@ -79,18 +221,12 @@ namespace BOOM {
     double information_weighted_sum = 0;
     double information = 0;
     if (number_of_trials < clt_threshold_) {
-      for (int i = 0; i < number_of_trials; ++i) {
-        bool success = i < number_of_successes;
-        double latent_logit = rtrun_logit_mt(rng, linear_predictor, 0, success);
-        // mu is unused because the mixture is a scale-mixture only,
-        // but we need it for the API.
-        double mu, sigsq;
-        mixture_approximation.unmix(
-            rng, latent_logit - linear_predictor, &mu, &sigsq);
-        double current_weight = 1.0 / sigsq;
-        information += current_weight;
-        information_weighted_sum += latent_logit * current_weight;
-      }
+      std::vector<double> workspace;
+      return impute_individual_trials(rng,
+                                      number_of_trials,
+                                      number_of_successes,
+                                      linear_predictor,
+                                      workspace);
     } else {
       // Large sample case.  There are number_of_successes draws from
       // the positive side, and number_of_trials - number_of_successes
@@ -144,31 +280,13 @@ namespace BOOM {
       return impute_large_sample(
           rng, number_of_trials, number_of_successes, linear_predictor);
     } else {
-      return impute_small_sample(
-          rng, number_of_trials, number_of_successes, linear_predictor);
-    }
-  }
-
-  std::pair<double, double> BinomialLogitCltDataImputer::impute_small_sample(
-      RNG & rng,
-      double number_of_trials,
-      double number_of_successes,
-      double linear_predictor) const{
-    double information_weighted_sum = 0;
-    double information = 0;
-    for (int i = 0; i < number_of_trials; ++i) {
-      bool success = i < number_of_successes;
-      double latent_logit = rtrun_logit_mt(rng, linear_predictor, 0, success);
-      // mu is unused because the mixture is a scale-mixture only,
-      // but we need it for the API.
-      double mu, sigsq;
-      mixture_approximation.unmix(
-          rng, latent_logit - linear_predictor, &mu, &sigsq);
-      double current_weight = 1.0 / sigsq;
-      information += current_weight;
-      information_weighted_sum += latent_logit * current_weight;
+      std::vector<double> workspace;
+      return impute_individual_trials(rng,
+                                      number_of_trials,
+                                      number_of_successes,
+                                      linear_predictor,
+                                      workspace);
     }
-    return std::make_pair(information_weighted_sum, information);
   }
 
   //----------------------------------------------------------------------
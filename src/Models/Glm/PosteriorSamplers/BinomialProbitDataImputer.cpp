@@ -17,6 +17,8 @@
 */
 
 #include <Models/Glm/PosteriorSamplers/BinomialProbitDataImputer.hpp>
+#include <LinAlg/Vector.hpp>
+#include <LinAlg/VectorView.hpp>
 #include <cpputil/report_error.hpp>
 #include <distributions.hpp>
 #include <cstdint>
@@ -51,22 +53,21 @@ namespace BOOM {
       // them up we'll have a normal with mean (y * mean) and variance
       // (y * variance).
       ans += rnorm_mt(rng, y * mean, sqrt(y * variance));
-    } else {
-      for (int i = 0; i < y; ++i) {
-        // TODO(stevescott): If y is large-ish but not quite
-        // clt_threshold_ then we might waste some time here
-        // constantly rebuilding the same TnSampler object.
-        ans += rtrun_norm_mt(rng, eta, 1, 0, true);
-      }
+    } else if (y > 0) {
+      // The draws share one rejection envelope, rather than
+      // rebuilding the same TnSampler for each draw.
+      Vector draws(y);
+      rtrun_norm_mt(rng, eta, 1, 0, true, VectorView(draws));
+      ans += draws.sum();
     }
 
     if (n - y > clt_threshold_) {
       trun_norm_moments(eta, 1, 0, false, &mean, &variance);
       ans += rnorm_mt(rng, (n - y) * mean, sqrt((n - y) * variance));
-    } else {
-      for (int i = 0; i < n - y; ++i) {
-        ans += rtrun_norm_mt(rng, eta, 1, 0, false);
-      }
+    } else if (n - y > 0) {
+      Vector draws(n - y);
+      rtrun_norm_mt(rng, eta, 1, 0, false, VectorView(draws));
+      ans += draws.sum();
     }
     return ans;
   }
@@ -24,6 +24,55 @@ namespace {
   typedef BinomialProbitSpikeSlabSampler BPSSS;
 }  // namespace
 
+  namespace BinomialProbit {
+    ImputeWorker::ImputeWorker(Vector &global_xtz,
+                               std::mutex &global_xtz_mutex,
+                               int clt_threshold,
+                               const GlmCoefs *coefficients,
+                               RNG *rng,
+                               RNG &seeding_rng)
+        : LatentDataImputerWorker(global_xtz_mutex),
+          global_xtz_(global_xtz),
+          imputer_(clt_threshold),
+          coefficients_(coefficients)
+    {
+      if (!rng) {
+        rng_storage_.reset(new RNG(seed_rng(seeding_rng)));
+        rng_ = rng_storage_.get();
+      } else {
+        rng_ = rng;
+      }
+      std::vector<Ptr<BinomialRegressionData>> empty_vector;
+      begin_ = empty_vector.end();
+      end_ = empty_vector.end();
+    }
+
+    void ImputeWorker::set_data(Iterator begin, Iterator end) {
+      begin_ = begin;
+      end_ = end;
+    }
+
+    void ImputeWorker::impute_latent_data() {
+      xtz_.resize(coefficients_->nvars_possible());
+      xtz_ = 0.0;
+      for (Iterator it = begin_; it != end_; ++it) {
+        const BinomialRegressionData &data(**it);
+        const Vector &x(data.x());
+        double sum_of_z = imputer_.impute(*rng_,
+                                          data.n(),
+                                          data.y(),
+                                          coefficients_->predict(x));
+        xtz_.axpy(x, sum_of_z);
+      }
+    }
+
+    void ImputeWorker::combine_complete_data() {
+      std::unique_lock<std::mutex> lock(std::move(
+          lock_complete_data_repository()));
+      global_xtz_ += xtz_;
+    }
+  }  // namespace BinomialProbit
+
   BPSSS::BinomialProbitSpikeSlabSampler(
       BinomialProbitModel *model,
       Ptr<MvnBase> slab_prior,
@@ -35,7 +84,11 @@ namespace {
         slab_prior_(slab_prior),
         spike_prior_(spike_prior),
         spike_slab_(model_, slab_prior_, spike_prior_),
-        imputer_(clt_threshold) {}
+        clt_threshold_(clt_threshold)
+  {
+    set_number_of_workers(1);
+    reassign_data_each_time(true);
+  }
 
   void BPSSS::draw() {
     impute_latent_data();
@@ -61,18 +114,21 @@ namespace {
     if (nrow(xtx_) != model_->xdim()) {
       refresh_xtx();
     }
+    LatentDataSampler<BinomialProbit::ImputeWorker>::impute_latent_data();
+  }
+
+  Ptr<BinomialProbit::ImputeWorker> BPSSS::create_worker(std::mutex &m) {
+    return new BinomialProbit::ImputeWorker(
+        xtz_, m, clt_threshold_, model_->coef_prm().get(), nullptr, rng());
+  }
+
+  void BPSSS::assign_data_to_workers() {
+    BOOM::assign_data_to_workers(model_->dat(), workers());
+  }
 
+  void BPSSS::clear_latent_data() {
     xtz_.resize(model_->xdim());
     xtz_ = 0.0;
-    const std::vector<Ptr<BinomialRegressionData>> &data(model_->dat());
-    for (int i = 0; i < data.size(); ++i) {
-      const Vector &x(data[i]->x());
-      double sum_of_z = imputer_.impute(rng(),
-                                        data[i]->n(),
-                                        data[i]->y(),
-                                        model_->predict(x));
-      xtz_.axpy(x, sum_of_z);
-    }
   }
 
   void BPSSS::refresh_xtx() {
@@ -24,6 +24,39 @@
 
 namespace BOOM{
 
+  namespace CumulativeProbit {
+    ImputeWorker::ImputeWorker(NeRegSuf &global_suf,
+                               std::mutex &global_suf_mutex,
+                               const CumulativeProbitModel *model,
+                               RNG *rng,
+                               RNG &seeding_rng)
+        : SufstatImputeWorker<OrdinalRegressionData, NeRegSuf>(
+              global_suf, global_suf_mutex, rng, seeding_rng),
+          model_(model)
+    {}
+
+    void ImputeWorker::impute_latent_data_point(
+        const OrdinalRegressionData &data, NeRegSuf *suf, RNG &rng) {
+      uint y = data.y();
+      uint maxscore = model_->maxscore();
+      const Vector & x(data.x());
+      double eta = model_->predict(x);
+      double z = 0;
+      if(y == 0){
+        z = rtrun_norm_mt(rng, eta, 1, 0, false);
+      }else if(y==maxscore){
+        // TODO(stevescott):  check delta parameterization y or y+1?
+        z = rtrun_norm_mt(rng, eta, 1, model_->delta(maxscore), true);
+      }else{
+        // TODO(stevescott):  check delta parameterization
+        double lo = model_->delta(y-1);
+        double hi = model_->delta(y);
+        z = rtrun_norm_2_mt(rng, eta, 1, lo, hi);
+      }
+      suf->add_mixture_data(z, x, 1.0);
+    }
+  }  // namespace CumulativeProbit
+
   typedef CumulativeProbitSampler CPS;
   typedef CumulativeProbitModel CPM;
   CPS::CumulativeProbitSampler(CPM *m,
@@ -33,7 +66,10 @@ namespace BOOM{
         m_(m),
         beta_prior_(prior),
         suf_(m->xdim())
-  {}
+  {
+    set_number_of_workers(1);
+    reassign_data_each_time(true);
+  }
 
   double CPS::logpri()const{
     return beta_prior_->logp(m_->Beta());
@@ -46,28 +82,19 @@ namespace BOOM{
   }
 
   void CPS::impute_latent_data(){
+    LatentDataSampler<CumulativeProbit::ImputeWorker>::impute_latent_data();
+  }
+
+  Ptr<CumulativeProbit::ImputeWorker> CPS::create_worker(std::mutex &m) {
+    return new CumulativeProbit::ImputeWorker(suf_, m, m_, nullptr, rng());
+  }
+
+  void CPS::assign_data_to_workers() {
+    BOOM::assign_data_to_workers(m_->dat(), workers());
+  }
+
+  void CPS::clear_latent_data() {
     suf_.clear();
-    std::vector<Ptr<OrdinalRegressionData> > data(m_->dat());
-    uint maxscore = m_->maxscore();
-    uint n = data.size();
-    for(int i = 0; i < n; ++i){
-      uint y = data[i]->y();
-      const Vector & x(data[i]->x());
-      double eta = m_->predict(x);
-      double z = 0;
-      if(y == 0){
-        z = rtrun_norm_mt(rng(), eta, 1, 0, false);
-      }else if(y==maxscore){
-        // TODO(stevescott):  check delta parameterization y or y+1?
-        z = rtrun_norm_mt(rng(), eta, 1, m_->delta(maxscore), true);
-      }else{
-        // TODO(stevescott):  check delta parameterization
-        double lo = m_->delta(y-1);
-        double hi = m_->delta(y);
-        z = rtrun_norm_2_mt(rng(), eta, 1, lo, hi);
-      }
-      suf_.add_mixture_data(z, x, 1.0);
-    }
   }
 
   void CPS::draw_beta(){
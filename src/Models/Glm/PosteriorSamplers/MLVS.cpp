@@ -78,6 +78,10 @@ namespace BOOM {
     suf_.clear();
   }
 
+  void MLVS::impute_latent_data() {
+    impute_latent_data_by_tree_reduction();
+  }
+
   Ptr<MlvsDataImputer> MLVS::create_worker(std::mutex &m) {
     return new MlvsDataImputer(suf_, m, mod_, nullptr, rng());
   }
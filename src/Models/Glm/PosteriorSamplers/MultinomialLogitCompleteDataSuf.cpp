@@ -18,6 +18,7 @@
 
 #include <Models/Glm/PosteriorSamplers/MultinomialLogitCompleteDataSuf.hpp>
 #include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
 
 namespace BOOM {
  namespace MultinomialLogit {
@@ -41,10 +42,61 @@ namespace BOOM {
     sym_ = false;
   }
 
+  // The design matrix for dp is dp.X(false), but that matrix is
+  // mostly zeros.  Row m holds the subject predictors in the block of
+  // columns for choice level m (there is no block for level 0),
+  // followed by the choice predictors for level m.  The cross
+  // products are accumulated block by block directly from the
+  // subject and choice predictors, filling the upper triangle of
+  // xtwx_ in the same order as add_inner(dp.X(false), wgts).
   void MLVSS::update(const ChoiceData &dp, const Vector & wgts, const Vector &u){
-    const Matrix & X(dp.X(false));      // 'false' means omit columns
-    xtwx_.add_inner(X, wgts, false);   // corresponding to subject X's at
-    xtwu_ += X.Tmult(wgts*u);         // choice level 0.
+    int M = dp.nchoices();
+    int psub = dp.subject_nvars();
+    int pch = dp.choice_nvars();
+    int dim = xtwu_.size();
+    int choice_offset = (M - 1) * psub;
+    if (choice_offset + pch != dim) {
+      report_error("ChoiceData does not match the dimension of the "
+                   "multinomial logit complete data sufficient statistics.");
+    }
+    const Vector &xsub(dp.Xsubject());
+    double *xtwx = xtwx_.data();
+    choice_xtwu_.resize(pch);
+    choice_xtwu_ = 0.0;
+    for (int m = 0; m < M; ++m) {
+      double w = wgts[m];
+      double wu = w * u[m];
+      const Vector &xch(dp.Xchoice(m));
+      if (m > 0) {
+        int offset = (m - 1) * psub;
+        for (int j = 0; j < psub; ++j) {
+          double *col = xtwx + (offset + j) * dim + offset;
+          double tmp = w * xsub[j];
+          for (int i = 0; i <= j; ++i) {
+            col[i] += xsub[i] * tmp;
+          }
+          xtwu_[offset + j] += xsub[j] * wu;
+        }
+        for (int j = 0; j < pch; ++j) {
+          double *col = xtwx + (choice_offset + j) * dim + offset;
+          double tmp = w * xch[j];
+          for (int i = 0; i < psub; ++i) {
+            col[i] += xsub[i] * tmp;
+          }
+        }
+      }
+      for (int j = 0; j < pch; ++j) {
+        double *col = xtwx + (choice_offset + j) * dim + choice_offset;
+        double tmp = w * xch[j];
+        for (int i = 0; i <= j; ++i) {
+          col[i] += xch[i] * tmp;
+        }
+        choice_xtwu_[j] += xch[j] * wu;
+      }
+    }
+    for (int j = 0; j < pch; ++j) {
+      xtwu_[choice_offset + j] += choice_xtwu_[j];
+    }
     sym_ = false;
     for (int i = 0; i < wgts.size(); ++i) {
       weighted_sum_of_squares_ += wgts[i] * square(u[i]);
@@ -18,6 +18,7 @@
 
 #include <Models/Glm/PosteriorSamplers/MultinomialLogitCompositeSpikeSlabSampler.hpp>
 #include <distributions.hpp>
+#include <cpputil/lse.hpp>
 #include <cpputil/math_utils.hpp>
 #include <Samplers/TIM.hpp>
 
@@ -45,7 +46,8 @@ namespace BOOM {
           : model_(model),
             prior_(prior),
             chunk_size_(max_chunk_size),
-            start_(max_chunk_size * chunk_number)
+            start_(max_chunk_size * chunk_number),
+            use_linear_predictor_(false)
       {
         int beta_dim = model_->coef().inc().nvars();
         if (start_ >= beta_dim) {
@@ -57,6 +59,44 @@ namespace BOOM {
         }
       }
 
+      // As above, but the log likelihood is computed by adjusting a
+      // cached linear predictor for the change in the chunk, rather
+      // than by recomputing X * beta for all of beta.
+      // Args:
+      //   linear_predictor: Row i is the linear predictor (one element
+      //     per choice level) for observation i, evaluated at the
+      //     model's current coefficients.
+      MultinomialLogitLogPosteriorChunk(const MultinomialLogitModel *model,
+                                        const MvnBase *prior,
+                                        int max_chunk_size,
+                                        int chunk_number,
+                                        const Matrix &linear_predictor)
+          : MultinomialLogitLogPosteriorChunk(
+                model, prior, max_chunk_size, chunk_number)
+      {
+        const std::vector<Ptr<ChoiceData>> &data(model_->dat());
+        if (linear_predictor.nrow() != data.size()
+            || linear_predictor.ncol() != model_->Nchoices()) {
+          report_error("The linear predictor passed to "
+                       "MultinomialLogitLogPosteriorChunk has the wrong "
+                       "dimensions.");
+        }
+        use_linear_predictor_ = true;
+        const Selector &inc(model_->coef().inc());
+        chunk_positions_.resize(chunk_size_);
+        for (int j = 0; j < chunk_size_; ++j) {
+          chunk_positions_[j] = inc.indx(start_ + j);
+        }
+        Vector beta = model_->coef().included_coefficients();
+        ConstVectorView current_chunk(beta, start_, chunk_size_);
+        linear_predictor_offset_ = linear_predictor;
+        for (int i = 0; i < data.size(); ++i) {
+          subtract_chunk_contribution(
+              data[i]->X(false), current_chunk,
+              linear_predictor_offset_.row(i));
+        }
+      }
+
       // Args:
       //   beta: The values at which to evaluate log_posterior.  The
       //     specified chunk evaluated at beta_chunk, and the rest of
@@ -96,6 +136,25 @@ namespace BOOM {
           chunk_mask.add(pos);
         }
 
+        if (use_linear_predictor_) {
+          double ans = cached_log_likelihood(beta_chunk, gradient, Hessian, nd);
+          // The prior derivatives are computed with respect to all of
+          // beta, and then subset using chunk_mask.
+          int dim = beta.size();
+          Vector g(nd > 0 ? dim : 0, 0.0);
+          Matrix h(nd > 1 ? dim : 0, nd > 1 ? dim : 0, 0.0);
+          ans += prior_->logp_given_inclusion(
+              beta, nd > 0 ? &g : nullptr, nd > 1 ? &h : nullptr,
+              model_->coef().inc(), false);
+          if (nd > 0) {
+            gradient += chunk_mask.select(g);
+            if (nd > 1) {
+              Hessian += chunk_mask.select_square(h);
+            }
+          }
+          return ans;
+        }
+
         // The call to log_likelihood computes g and h with respect to
         // beta.  Afterwards, they need to be subset using chunk_mask.
         Vector g;
@@ -116,11 +175,111 @@ namespace BOOM {
         return ans;
       }
 
+      // Fill row i of eta with the linear predictor for observation i
+      // when the chunk is set to beta_chunk, and the remaining
+      // coefficients are held at their current values.  Only available
+      // if the chunk was built from a linear predictor.
+      void fill_linear_predictor(const ConstVectorView &beta_chunk,
+                                 Matrix &eta) const {
+        const std::vector<Ptr<ChoiceData>> &data(model_->dat());
+        eta = linear_predictor_offset_;
+        for (int i = 0; i < data.size(); ++i) {
+          add_chunk_contribution(data[i]->X(false), beta_chunk, eta.row(i));
+        }
+      }
+
      private:
+      // eta[m] += sum_j X(m, chunk_positions_[j]) * beta_chunk[j].
+      void add_chunk_contribution(const Matrix &X,
+                                  const ConstVectorView &beta_chunk,
+                                  VectorView eta) const {
+        for (int m = 0; m < eta.size(); ++m) {
+          for (int j = 0; j < chunk_size_; ++j) {
+            eta[m] += X(m, chunk_positions_[j]) * beta_chunk[j];
+          }
+        }
+      }
+
+      void subtract_chunk_contribution(const Matrix &X,
+                                       const ConstVectorView &beta_chunk,
+                                       VectorView eta) const {
+        for (int m = 0; m < eta.size(); ++m) {
+          for (int j = 0; j < chunk_size_; ++j) {
+            eta[m] -= X(m, chunk_positions_[j]) * beta_chunk[j];
+          }
+        }
+      }
+
+      // The log likelihood and its derivatives with respect to the
+      // chunk, computed from linear_predictor_offset_.  This mirrors
+      // MultinomialLogitModel::log_likelihood, restricted to the
+      // columns of X in the chunk.
+      double cached_log_likelihood(const Vector &beta_chunk,
+                                   Vector &gradient,
+                                   Matrix &Hessian,
+                                   int nd) const {
+        const std::vector<Ptr<ChoiceData>> &data(model_->dat());
+        bool downsampling =
+            model_->log_sampling_probs().size() == model_->Nchoices();
+        if (nd > 0) {
+          gradient.resize(chunk_size_);
+          gradient = 0;
+          if (nd > 1) {
+            Hessian.resize(chunk_size_, chunk_size_);
+            Hessian = 0;
+          }
+        }
+        double ans = 0;
+        Vector eta;
+        Vector probs;
+        Vector xbar;
+        Vector tmpx;
+        Matrix X_chunk;
+        for (int i = 0; i < data.size(); ++i) {
+          const Matrix &X(data[i]->X(false));
+          uint y = data[i]->value();
+          eta = linear_predictor_offset_.row(i);
+          add_chunk_contribution(X, beta_chunk, VectorView(eta));
+          if (downsampling) {
+            eta += model_->log_sampling_probs();
+          }
+          double lognc = lse(eta);
+          ans += eta[y] - lognc;
+          if (nd > 0) {
+            int M = eta.size();
+            X_chunk.resize(M, chunk_size_);
+            for (int m = 0; m < M; ++m) {
+              for (int j = 0; j < chunk_size_; ++j) {
+                X_chunk(m, j) = X(m, chunk_positions_[j]);
+              }
+            }
+            probs = exp(eta - lognc);
+            xbar = probs * X_chunk;
+            gradient += X_chunk.row(y) - xbar;
+            if (nd > 1) {
+              for (int m = 0; m < M; ++m) {
+                tmpx = X_chunk.row(m);
+                Hessian.add_outer(tmpx, tmpx, -probs[m]);
+              }
+              Hessian.add_outer(xbar, xbar);
+            }
+          }
+        }
+        return ans;
+      }
+
       const MultinomialLogitModel *model_;
       const MvnBase *prior_;
       int chunk_size_;
       int start_;
+
+      bool use_linear_predictor_;
+      // The positions of the chunk's coefficients in the columns of
+      // ChoiceData::X(false).
+      std::vector<int> chunk_positions_;
+      // The linear predictor with the contribution of the chunk
+      // removed.
+      Matrix linear_predictor_offset_;
     };
 
   }  // namespace
@@ -182,6 +341,7 @@ namespace BOOM {
     if (number_of_chunks == 0) {
       return;
     }
+    refresh_linear_predictor();
     Vector beta = model_->coef().included_coefficients();
     int full_chunk_size = compute_chunk_size();
     for (int chunk = 0; chunk < number_of_chunks; ++chunk) {
@@ -190,7 +350,8 @@ namespace BOOM {
           model_,
           prior_.get(),
           full_chunk_size,
-          chunk);
+          chunk,
+          linear_predictor_);
       TIM tim_sampler(logpost, tdf_);
       int start = full_chunk_size * chunk;
       int beta_dim = beta.size();  // type coercsion uint -> int
@@ -203,6 +364,8 @@ namespace BOOM {
         if (tim_sampler.last_draw_was_accepted()) {
           accounting_.record_acceptance("TIMchunk");
           model_->coef().set_included_coefficients(beta);
+          logpost.fill_linear_predictor(beta_chunk, linear_predictor_);
+          linear_predictor_coefficients_ = model_->coef().Beta();
         } else {
           accounting_.record_rejection("TIMchunk");
         }
@@ -217,6 +380,9 @@ namespace BOOM {
   //----------------------------------------------------------------------
   void MLCS3::rwm_draw() {
     int number_of_chunks = compute_number_of_chunks();
+    if (number_of_chunks > 0) {
+      refresh_linear_predictor();
+    }
     for (int chunk = 0; chunk < number_of_chunks; ++chunk) {
       rwm_draw_chunk(chunk);
     }
@@ -225,9 +391,10 @@ namespace BOOM {
   //----------------------------------------------------------------------
   void MLCS3::rwm_draw_chunk(int chunk) {
     MoveTimer move_timer = accounting_.start_time("RWMchunk");
+    ensure_linear_predictor_is_current();
     int chunk_size = compute_chunk_size();
     MultinomialLogitLogPosteriorChunk logpost(
-        model_, prior_.get(), chunk_size, chunk);
+        model_, prior_.get(), chunk_size, chunk, linear_predictor_);
     int chunk_begin = chunk_size * chunk;
     Vector beta = model_->coef().included_coefficients();
     int beta_dim = beta.size();  // type coercion
@@ -256,6 +423,8 @@ namespace BOOM {
     if (logu < log_alpha) {
       beta_chunk = candidate;
       model_->coef().set_included_coefficients(beta);
+      logpost.fill_linear_predictor(candidate, linear_predictor_);
+      linear_predictor_coefficients_ = model_->coef().Beta();
       accounting_.record_acceptance("RWMchunk");
     } else {
       accounting_.record_rejection("RWMchunk");
@@ -289,6 +458,20 @@ namespace BOOM {
     move_probs_ /= total;
   }
 
+  //----------------------------------------------------------------------
+  void MLCS3::refresh_linear_predictor() {
+    model_->fill_eta_matrix(model_->coef().Beta(), linear_predictor_);
+    linear_predictor_coefficients_ = model_->coef().Beta();
+  }
+
+  //----------------------------------------------------------------------
+  void MLCS3::ensure_linear_predictor_is_current() {
+    if (linear_predictor_.nrow() != model_->dat().size()
+        || !(linear_predictor_coefficients_ == model_->coef().Beta())) {
+      refresh_linear_predictor();
+    }
+  }
+
   //----------------------------------------------------------------------
   int MLCS3::compute_chunk_size() const {
     int nvars = model_->coef().nvars();
@@ -36,7 +36,8 @@ namespace BOOM {
       : SufstatImputeWorker<PoissonRegressionData, WeightedRegSuf>(
             global_suf, global_suf_mutex, rng, seeding_rng),
         coefficients_(coefficients),
-        imputer_(new PoissonDataImputer)
+        imputer_(new PoissonDataImputer),
+        buffer_(coefficients->nvars_possible())
   {}
 
   // The latent variable scheme imagines the event times of y[i]
@@ -83,11 +84,25 @@ namespace BOOM {
                      &external_mu,
                      &external_weight);
     if (y > 0) {
-      complete_data_suf->add_data(
-          x, internal_neglog_final_event_time - internal_mu, internal_weight);
+      add_to_buffer(x, internal_neglog_final_event_time - internal_mu,
+                    internal_weight, complete_data_suf);
     }
-    complete_data_suf->add_data(
-        x, neglog_final_interarrival_time - external_mu, external_weight);
+    add_to_buffer(x, neglog_final_interarrival_time - external_mu,
+                  external_weight, complete_data_suf);
+  }
+
+  void PoissonRegressionDataImputer::add_to_buffer(
+      const Vector &x, double y, double weight,
+      WeightedRegSuf *complete_data_suf) {
+    if (buffer_.add(x, y, weight)) {
+      finalize_latent_data(complete_data_suf);
+    }
+  }
+
+  void PoissonRegressionDataImputer::finalize_latent_data(
+      WeightedRegSuf *complete_data_suf) {
+    complete_data_suf->add_data(buffer_);
+    buffer_.clear();
   }
 
   //======================================================================
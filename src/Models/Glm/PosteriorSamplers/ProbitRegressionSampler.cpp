@@ -16,10 +16,76 @@
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
 */
 #include <Models/Glm/PosteriorSamplers/ProbitRegressionSampler.hpp>
+#include <LinAlg/blas.hpp>
+#include <cpputil/report_error.hpp>
 #include <distributions.hpp>
+#include <cstdint>
 
 namespace BOOM{
 
+  namespace ProbitRegression {
+    ImputeWorker::ImputeWorker(const Matrix &design,
+                               const ProbitRegressionModel *model,
+                               Vector &global_xtz,
+                               std::mutex &global_xtz_mutex,
+                               RNG *rng,
+                               RNG &seeding_rng)
+        : LatentDataImputerWorker(global_xtz_mutex),
+          design_(design),
+          model_(model),
+          global_xtz_(global_xtz),
+          begin_(0),
+          end_(0)
+    {
+      if (!rng) {
+        rng_storage_.reset(new RNG(seed_rng(seeding_rng)));
+        rng_ = rng_storage_.get();
+      } else {
+        rng_ = rng;
+      }
+    }
+
+    void ImputeWorker::set_rows(int begin, int end) {
+      begin_ = begin;
+      end_ = end;
+    }
+
+    void ImputeWorker::impute_latent_data() {
+      int p = design_.ncol();
+      xtz_.resize(p);
+      xtz_ = 0;
+      int nrows = end_ - begin_;
+      if (nrows <= 0 || p == 0) return;
+      eta_.resize(nrows);
+      z_.resize(nrows);
+      responses_.resize(nrows);
+      const ProbitRegressionModel::DatasetType &data(model_->dat());
+      for (int i = 0; i < nrows; ++i) {
+        responses_[i] = data[begin_ + i]->y();
+      }
+      // The block is rows begin_ ... end_ - 1 of the column major
+      // design matrix, so it starts at begin_ with the leading
+      // dimension of the full matrix.
+      const double *block = design_.data() + begin_;
+      int lda = design_.nrow();
+      blas::dgemv(blas::NoTrans, nrows, p, 1.0, block, lda,
+                  model_->Beta().data(), 1, 0.0, eta_.data(), 1);
+      rtrun_norm_mt(*rng_, eta_, 1.0, 0.0, responses_, VectorView(z_));
+      blas::dgemv(blas::Trans, nrows, p, 1.0, block, lda,
+                  z_.data(), 1, 0.0, xtz_.data(), 1);
+    }
+
+    void ImputeWorker::combine_complete_data() {
+      std::unique_lock<std::mutex> lock(std::move(
+          lock_complete_data_repository()));
+      if (xtz_.size() != global_xtz_.size()) {
+        report_error("Worker's X'z does not match the size of the "
+                     "sampler's X'z in ProbitRegression::ImputeWorker.");
+      }
+      global_xtz_ += xtz_;
+    }
+  }  // namespace ProbitRegression
+
   typedef ProbitRegressionSampler PRS;
 
   PRS::ProbitRegressionSampler(ProbitRegressionModel *model,
@@ -33,6 +99,8 @@ namespace BOOM{
         beta_(mod_->xdim())
   {
     refresh_xtx();
+    set_number_of_workers(1);
+    reassign_data_each_time(true);
   }
 
   double PRS::logpri()const{
@@ -53,17 +121,30 @@ namespace BOOM{
   }
 
   void PRS::impute_latent_data(){
-    const ProbitRegressionModel::DatasetType & data(mod_->dat());
-    int n = data.size();
-    const Vector & beta(mod_->Beta());
-    xtz_ = 0;
-    for(int i = 0; i < n; ++i){
-      const Vector & x(data[i]->x());
-      double eta = x.dot(beta);
-      bool y = data[i]->y();
-      double z = rtrun_norm_mt(rng(), eta, 1, 0, y);
-      xtz_.axpy(x,z);
+    if (design_.nrow() != mod_->dat().size()) {
+      refresh_xtx();
     }
+    LatentDataSampler<ProbitRegression::ImputeWorker>::impute_latent_data();
+  }
+
+  Ptr<ProbitRegression::ImputeWorker> PRS::create_worker(std::mutex &m) {
+    return new ProbitRegression::ImputeWorker(
+        design_, mod_, xtz_, m, nullptr, rng());
+  }
+
+  void PRS::assign_data_to_workers() {
+    std::vector<Ptr<ProbitRegression::ImputeWorker>> &w(workers());
+    int number_of_workers = w.size();
+    int64_t n = design_.nrow();
+    for (int i = 0; i < number_of_workers; ++i) {
+      w[i]->set_rows(i * n / number_of_workers,
+                     (i + 1) * n / number_of_workers);
+    }
+  }
+
+  void PRS::clear_latent_data() {
+    xtz_.resize(mod_->xdim());
+    xtz_ = 0;
   }
 
   const Vector & PRS::xtz()const{ return xtz_; }
@@ -75,11 +156,14 @@ namespace BOOM{
     xtx_ = 0;
     const ProbitRegressionModel::DatasetType & data(mod_->dat());
     int n = data.size();
+    design_.resize(n, p);
     for(int i = 0; i < n; ++i){
-      const Vector & x(data[i]->x());
-      xtx_.add_outer(x, 1, false);
+      design_.row(i) = data[i]->x();
+    }
+    if (n > 0) {
+      xtx_.add_inner(design_);
     }
-    xtx_.reflect();
+    assign_data_to_workers();
   }
 
 }
@@ -34,12 +34,19 @@ namespace BOOM {
     if (residual > 0) {
       double lambda_inv = rig_mt(rng, 1.0 / residual, 1.0);
       double lambda = 1.0  / lambda_inv;
-      suf->add_data(observed.x(),
-                    adjusted_observation(observed.y(), lambda),
-                    lambda_inv);
+      if (buffer_.add(observed.x(),
+                      adjusted_observation(observed.y(), lambda),
+                      lambda_inv)) {
+        finalize_latent_data(suf);
+      }
     }
   }
 
+  void QRIW::finalize_latent_data(WeightedRegSuf *suf) {
+    suf->add_data(buffer_);
+    buffer_.clear();
+  }
+
   //======================================================================
   QRPS::QuantileRegressionPosteriorSampler(
       QuantileRegressionModel *model,
@@ -0,0 +1,343 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/Glm/PosteriorSamplers/SpikeSlabVariationalRegression.hpp>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cpputil/ThreadTools.hpp>
+#include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
+#include <distributions.hpp>
+#include <LinAlg/Selector.hpp>
+
+namespace BOOM {
+
+  namespace {
+    // x * log(y / x), with the convention 0 * log(0) = 0.
+    inline double xlog_ratio(double x, double y) {
+      return x > 0 ? x * log(y / x) : 0.0;
+    }
+  }  // namespace
+
+  SpikeSlabVariationalRegression::SpikeSlabVariationalRegression(
+      RegressionModel *model,
+      const Ptr<MvnGivenScalarSigmaBase> &slab,
+      const Ptr<GammaModelBase> &residual_precision_prior,
+      const Ptr<VariableSelectionPrior> &spike)
+      : model_(model),
+        slab_(slab),
+        residual_precision_prior_(residual_precision_prior),
+        spike_(spike),
+        yty_(0),
+        sample_size_(0),
+        prior_df_(0),
+        prior_ss_(0)
+  {
+    if (slab_->dim() != model_->xdim()
+        || spike_->potential_nvars() != model_->xdim()) {
+      report_error("The dimensions of the slab and spike priors in "
+                   "SpikeSlabVariationalRegression must match the number "
+                   "of predictors in the model.");
+    }
+    initialize_from_model();
+  }
+
+  //----------------------------------------------------------------------
+  void SpikeSlabVariationalRegression::refresh_inputs() {
+    Ptr<RegSuf> suf = model_->suf();
+    xtx_ = suf->xtx();
+    xty_ = suf->xty();
+    yty_ = suf->yty();
+    sample_size_ = suf->n();
+    prior_mean_ = slab_->mu();
+    prior_precision_ = diag(slab_->siginv()) * slab_->sigsq();
+    prior_inclusion_probabilities_ = spike_->prior_inclusion_probabilities();
+    prior_df_ = 2 * residual_precision_prior_->alpha();
+    prior_ss_ = 2 * residual_precision_prior_->beta();
+    for (int j = 0; j < prior_precision_.size(); ++j) {
+      double prob = prior_inclusion_probabilities_[j];
+      if (prior_precision_[j] <= 0 && prob > 0 && prob < 1) {
+        report_error("SpikeSlabVariationalRegression requires a proper "
+                     "slab for coefficients that are not certain to be "
+                     "included.");
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------
+  void SpikeSlabVariationalRegression::clamp_inclusion_probabilities(
+      Vector &alpha) const {
+    const Vector &pi(spike_->prior_inclusion_probabilities());
+    for (int j = 0; j < alpha.size(); ++j) {
+      if (pi[j] >= 1.0) {
+        alpha[j] = 1.0;
+      } else if (pi[j] <= 0.0) {
+        alpha[j] = 0.0;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------
+  void SpikeSlabVariationalRegression::initialize_from_model() {
+    state_.alpha = spike_->prior_inclusion_probabilities();
+    clamp_inclusion_probabilities(state_.alpha);
+    state_.mu = model_->Beta();
+    state_.s2 = Vector(state_.mu.size(), model_->sigsq());
+    state_.shape = 1.0;
+    state_.rate = model_->sigsq();
+    state_.elbo = negative_infinity();
+    state_.iterations = 0;
+  }
+
+  //----------------------------------------------------------------------
+  void SpikeSlabVariationalRegression::set_initial_values(
+      const Vector &inclusion_probabilities,
+      const Vector &coefficient_means) {
+    if (inclusion_probabilities.size() != model_->xdim()
+        || coefficient_means.size() != model_->xdim()) {
+      report_error("Initial values for SpikeSlabVariationalRegression "
+                   "must match the number of predictors in the model.");
+    }
+    state_.alpha = inclusion_probabilities;
+    clamp_inclusion_probabilities(state_.alpha);
+    state_.mu = coefficient_means;
+    state_.elbo = negative_infinity();
+    state_.iterations = 0;
+  }
+
+  //----------------------------------------------------------------------
+  double SpikeSlabVariationalRegression::fit(int max_iterations,
+                                             double tolerance) {
+    refresh_inputs();
+    run(state_, max_iterations, tolerance);
+    return state_.elbo;
+  }
+
+  //----------------------------------------------------------------------
+  double SpikeSlabVariationalRegression::fit_with_restarts(
+      int number_of_restarts, int number_of_threads, RNG &rng,
+      int max_iterations, double tolerance) {
+    refresh_inputs();
+    int p = state_.alpha.size();
+    std::vector<State> states(number_of_restarts + 1, state_);
+    for (int r = 1; r < states.size(); ++r) {
+      for (int j = 0; j < p; ++j) {
+        states[r].alpha[j] = runif_mt(rng);
+      }
+      clamp_inclusion_probabilities(states[r].alpha);
+      states[r].mu = prior_mean_;
+      states[r].elbo = negative_infinity();
+      states[r].iterations = 0;
+    }
+
+    ThreadWorkerPool pool;
+    pool.set_number_of_threads(number_of_threads > 1 ? number_of_threads : 0);
+    pool.run_jobs(states.size(), [this, &states, max_iterations,
+                                  tolerance](int r) {
+        this->run(states[r], max_iterations, tolerance);
+      });
+
+    int best = 0;
+    for (int r = 1; r < states.size(); ++r) {
+      if (states[r].elbo > states[best].elbo) best = r;
+    }
+    state_ = states[best];
+    return state_.elbo;
+  }
+
+  //----------------------------------------------------------------------
+  // Each sweep updates q(beta_j, gamma_j) for j = 1..p in turn, with
+  // r = alpha * mu and XTX * r updated after each coordinate, then
+  // updates q(1/sigma^2).  With rho = E(1/sigma^2) and
+  // log_rho = E(log(1/sigma^2)) the coordinate updates are
+  //
+  //   s2_j = 1 / (rho * (xtx_jj + omega_j))
+  //   mu_j = s2_j * rho * (xty_j - sum_{k != j} xtx_jk r_k + omega_j b_j)
+  //   logit(alpha_j) = logit(pi_j) + .5 * (log_rho + log(s2_j * omega_j))
+  //                    + mu_j^2 / (2 * s2_j) - .5 * rho * omega_j * b_j^2
+  void SpikeSlabVariationalRegression::run(
+      State &state, int max_iterations, double tolerance) const {
+    const int p = xty_.size();
+    Vector &alpha(state.alpha);
+    Vector &mu(state.mu);
+    Vector &s2(state.s2);
+    Vector r = alpha * mu;
+    Vector xtx_r = xtx_ * r;
+    if (state.iterations == 0) {
+      // Start the residual precision at its value in the model, with
+      // the weight of the data behind it.
+      state.shape = .5 * (prior_df_ + sample_size_);
+      state.rate = state.shape * model_->sigsq();
+    }
+
+    double old_elbo = state.elbo;
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+      double rho = state.shape / state.rate;
+      double expected_log_rho = digamma(state.shape) - log(state.rate);
+      double max_change = 0;
+      for (int j = 0; j < p; ++j) {
+        double pi = prior_inclusion_probabilities_[j];
+        double omega = prior_precision_[j];
+        double b = prior_mean_[j];
+        s2[j] = 1.0 / (rho * (xtx_(j, j) + omega));
+        double partial_xty = xty_[j] - (xtx_r[j] - xtx_(j, j) * r[j]);
+        mu[j] = s2[j] * rho * (partial_xty + omega * b);
+        double new_alpha = alpha[j];
+        if (pi >= 1.0) {
+          new_alpha = 1.0;
+        } else if (pi <= 0.0) {
+          new_alpha = 0.0;
+        } else {
+          double logit_alpha = log(pi / (1 - pi))
+              + .5 * (expected_log_rho + log(s2[j] * omega))
+              + .5 * square(mu[j]) / s2[j]
+              - .5 * rho * omega * square(b);
+          new_alpha = plogis(logit_alpha);
+        }
+        max_change = std::max(max_change, fabs(new_alpha - alpha[j]));
+        alpha[j] = new_alpha;
+        double new_r = alpha[j] * mu[j];
+        double delta = new_r - r[j];
+        if (delta != 0) {
+          xtx_r.axpy(xtx_.col(j), delta);
+          r[j] = new_r;
+        }
+      }
+
+      double rss = expected_rss(state, r, xtx_r);
+      double slab_ss = 0;
+      for (int j = 0; j < p; ++j) {
+        slab_ss += alpha[j] * prior_precision_[j]
+            * (square(mu[j] - prior_mean_[j]) + s2[j]);
+      }
+      state.shape = .5 * (prior_df_ + sample_size_ + sum(alpha));
+      state.rate = .5 * (prior_ss_ + rss + slab_ss);
+      state.elbo = compute_elbo(state, rss);
+      ++state.iterations;
+      if (max_change < tolerance
+          && fabs(state.elbo - old_elbo) < tolerance * (1 + fabs(state.elbo))) {
+        break;
+      }
+      old_elbo = state.elbo;
+    }
+  }
+
+  //----------------------------------------------------------------------
+  // E|y - X beta|^2 = yty - 2 r'xty + r'XTX r
+  //                   + sum_j xtx_jj * (Var(beta_j)),
+  // where Var(beta_j) = alpha_j * (s2_j + mu_j^2) - r_j^2.
+  double SpikeSlabVariationalRegression::expected_rss(
+      const State &state, const Vector &r, const Vector &xtx_r) const {
+    double ans = yty_ - 2 * r.dot(xty_) + r.dot(xtx_r);
+    for (int j = 0; j < r.size(); ++j) {
+      ans += xtx_(j, j)
+          * (state.alpha[j] * (state.s2[j] + square(state.mu[j]))
+             - square(r[j]));
+    }
+    return std::max(ans, 0.0);
+  }
+
+  //----------------------------------------------------------------------
+  // The ELBO, up to an additive constant that does not depend on the
+  // variational parameters (but does depend on the data and the
+  // priors, so ELBOs are only comparable for the same inputs).
+  double SpikeSlabVariationalRegression::compute_elbo(
+      const State &state, double expected_rss) const {
+    double rho = state.shape / state.rate;
+    double expected_log_rho = digamma(state.shape) - log(state.rate);
+
+    // Likelihood.
+    double ans = .5 * sample_size_ * expected_log_rho - .5 * rho * expected_rss;
+
+    // Prior and entropy of the coefficients and inclusion indicators.
+    for (int j = 0; j < state.alpha.size(); ++j) {
+      double alpha = state.alpha[j];
+      double omega = prior_precision_[j];
+      double s2 = state.s2[j];
+      if (alpha > 0) {
+        // The normal entropy .5 * log(2 pi e s2) is combined with the
+        // log normalizing constant of the slab.
+        double slab = .5 * log(s2) + .5;
+        if (omega > 0) {
+          slab += .5 * expected_log_rho + .5 * log(omega)
+              - .5 * rho * omega
+              * (square(state.mu[j] - prior_mean_[j]) + s2);
+        }
+        ans += alpha * slab;
+      }
+      double pi = prior_inclusion_probabilities_[j];
+      if (pi > 0 && pi < 1) {
+        ans += xlog_ratio(alpha, pi) + xlog_ratio(1 - alpha, 1 - pi);
+      }
+    }
+
+    // Prior on the residual precision.
+    double prior_shape = .5 * prior_df_;
+    double prior_rate = .5 * prior_ss_;
+    ans += (prior_shape - 1) * expected_log_rho - prior_rate * rho;
+
+    // Entropy of q(residual precision).
+    ans += state.shape - log(state.rate) + lgamma(state.shape)
+        + (1 - state.shape) * digamma(state.shape);
+    return ans;
+  }
+
+  //----------------------------------------------------------------------
+  Vector SpikeSlabVariationalRegression::posterior_mean() const {
+    return state_.alpha * state_.mu;
+  }
+
+  //----------------------------------------------------------------------
+  Matrix SpikeSlabVariationalRegression::simulate_coefficients(
+      int ndraws, RNG &rng) const {
+    int p = state_.alpha.size();
+    Matrix ans(ndraws, p, 0.0);
+    for (int i = 0; i < ndraws; ++i) {
+      for (int j = 0; j < p; ++j) {
+        if (runif_mt(rng) < state_.alpha[j]) {
+          ans(i, j) = rnorm_mt(rng, state_.mu[j], sqrt(state_.s2[j]));
+        }
+      }
+    }
+    return ans;
+  }
+
+  //----------------------------------------------------------------------
+  Vector SpikeSlabVariationalRegression::simulate_residual_sd(
+      int ndraws, RNG &rng) const {
+    Vector ans(ndraws);
+    for (int i = 0; i < ndraws; ++i) {
+      ans[i] = 1.0 / sqrt(rgamma_mt(rng, state_.shape, state_.rate));
+    }
+    return ans;
+  }
+
+  //----------------------------------------------------------------------
+  void SpikeSlabVariationalRegression::set_model_parameters() {
+    int p = state_.alpha.size();
+    Selector inc(p, false);
+    for (int j = 0; j < p; ++j) {
+      if (state_.alpha[j] >= .5) inc.add(j);
+    }
+    model_->set_included_coefficients(inc.select(state_.mu), inc);
+    model_->set_sigsq(state_.rate / state_.shape);
+  }
+
+}  // namespace BOOM
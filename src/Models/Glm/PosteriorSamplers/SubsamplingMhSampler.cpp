@@ -0,0 +1,563 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/Glm/PosteriorSamplers/SubsamplingMhSampler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <LinAlg/SubMatrix.hpp>
+#include <cpputil/lse.hpp>
+#include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
+#include <distributions.hpp>
+#include <numopt.hpp>
+
+namespace BOOM {
+
+  namespace {
+    typedef SubsamplingMhSampler SMS;
+
+    // Returns x^T * A * x.
+    double quadratic_form(const Matrix &A, const Vector &x) {
+      int n = x.size();
+      double ans = 0;
+      for (int j = 0; j < n; ++j) {
+        double tmp = 0;
+        for (int i = 0; i < n; ++i) {
+          tmp += A(i, j) * x[i];
+        }
+        ans += tmp * x[j];
+      }
+      return ans;
+    }
+  }  // namespace
+
+  SMS::SubsamplingMhSampler(Ptr<MvnBase> prior,
+                            int batch_size,
+                            double nu,
+                            RNG &seeding_rng)
+      : PosteriorSampler(seeding_rng),
+        prior_(prior),
+        nu_(nu),
+        batch_size_(batch_size),
+        number_of_blocks_(100),
+        adaptation_iterations_remaining_(0),
+        target_variance_(1.0),
+        min_adapted_batch_size_(20),
+        mode_is_current_(false),
+        log_likelihood_at_mode_(0),
+        log_likelihood_estimate_(0),
+        variance_(0),
+        number_of_draws_(0),
+        number_of_acceptances_(0)
+  {
+    if (batch_size_ < 2) {
+      report_error("The batch size for SubsamplingMhSampler must be "
+                   "at least 2.");
+    }
+  }
+
+  //----------------------------------------------------------------------
+  void SMS::draw() {
+    if (!mode_is_current_) {
+      find_posterior_mode();
+    }
+    Vector beta = coefficients();
+    if (subsample_.size() != batch_size_) {
+      refresh_subsample();
+    }
+    if (!(estimated_coefficients_ == beta)) {
+      log_likelihood_estimate_ = estimate_log_likelihood(beta, variance_);
+      estimated_coefficients_ = beta;
+    }
+
+    // Propose a new value for one block of the subsample, jointly
+    // with the new coefficients.
+    int nblocks = std::min<int>(number_of_blocks_, subsample_.size());
+    int block = random_int_mt(rng(), 0, nblocks - 1);
+    int begin = block_begin(block);
+    int end = block_end(block);
+    std::vector<ControlVariate> saved_block(subsample_.begin() + begin,
+                                            subsample_.begin() + end);
+    for (int slot = begin; slot < end; ++slot) {
+      draw_subsample_slot(slot);
+    }
+
+    Vector candidate = proposal_->draw(beta, &rng());
+    double candidate_variance = 0;
+    double candidate_log_likelihood = estimate_log_likelihood(
+        candidate, candidate_variance);
+    double log_alpha = candidate_log_likelihood + prior_->logp(candidate)
+        - log_likelihood_estimate_ - prior_->logp(beta);
+    ++number_of_draws_;
+    if (log(runif_mt(rng())) < log_alpha) {
+      ++number_of_acceptances_;
+      set_coefficients(candidate);
+      estimated_coefficients_ = candidate;
+      log_likelihood_estimate_ = candidate_log_likelihood;
+      variance_ = candidate_variance;
+    } else {
+      std::copy(saved_block.begin(), saved_block.end(),
+                subsample_.begin() + begin);
+    }
+    adapt();
+  }
+
+  //----------------------------------------------------------------------
+  double SMS::logpri() const {
+    return prior_->logp(coefficients());
+  }
+
+  //----------------------------------------------------------------------
+  void SMS::find_posterior_mode(double epsilon) {
+    Vector beta = coefficients();
+    int dim = beta.size();
+    Vector gradient(dim);
+    Matrix Hessian(dim, dim);
+    double max_value = 0;
+    std::string error_message;
+    bool ok = max_nd2_careful(
+        beta, gradient, Hessian, max_value,
+        Target([this](const Vector &b) {
+            Vector g;
+            Matrix h;
+            return this->log_posterior(b, g, h, 0);
+          }),
+        dTarget([this](const Vector &b, Vector &g) {
+            Matrix h;
+            return this->log_posterior(b, g, h, 1);
+          }),
+        d2Target([this](const Vector &b, Vector &g, Matrix &h) {
+            return this->log_posterior(b, g, h, 2);
+          }),
+        epsilon, error_message);
+    if (!ok) {
+      std::ostringstream err;
+      err << "SubsamplingMhSampler could not find the posterior mode.  "
+          << "Error message:" << std::endl << error_message;
+      report_error(err.str());
+    }
+    mode_ = beta;
+    log_likelihood_at_mode_ = full_data_log_likelihood(
+        mode_, gradient_at_mode_, Hessian_at_mode_, 2);
+
+    // The usual optimal scaling for random walk Metropolis.
+    SpdMatrix proposal_precision(Hessian * -1.0, false);
+    proposal_precision *= dim / square(2.38);
+    proposal_.reset(new MvtRwmProposal(proposal_precision, nu_));
+
+    mode_is_current_ = true;
+    subsample_.clear();
+    estimated_coefficients_.clear();
+    set_coefficients(mode_);
+  }
+
+  //----------------------------------------------------------------------
+  void SMS::set_batch_size(int batch_size) {
+    if (batch_size < 2) {
+      report_error("The batch size for SubsamplingMhSampler must be "
+                   "at least 2.");
+    }
+    batch_size_ = batch_size;
+  }
+
+  void SMS::set_number_of_blocks(int number_of_blocks) {
+    if (number_of_blocks < 1) {
+      report_error("SubsamplingMhSampler needs at least one block.");
+    }
+    number_of_blocks_ = number_of_blocks;
+  }
+
+  void SMS::adapt_batch_size(int niter, double target_variance) {
+    if (target_variance <= 0) {
+      report_error("The target variance must be positive.");
+    }
+    adaptation_iterations_remaining_ = niter;
+    target_variance_ = target_variance;
+  }
+
+  double SMS::acceptance_rate() const {
+    if (number_of_draws_ == 0) return 0.0;
+    return static_cast<double>(number_of_acceptances_) / number_of_draws_;
+  }
+
+  //----------------------------------------------------------------------
+  double SMS::full_data_log_likelihood(const Vector &beta,
+                                       Vector &gradient,
+                                       Matrix &Hessian,
+                                       int nd) const {
+    int dim = beta.size();
+    if (nd > 0) {
+      gradient.resize(dim);
+      gradient = 0.0;
+      if (nd > 1) {
+        Hessian.resize(dim, dim);
+        Hessian = 0.0;
+      }
+    }
+    double ans = 0;
+    int n = sample_size();
+    for (int i = 0; i < n; ++i) {
+      fill_linear_predictor(i, beta, eta_);
+      ans += observation_log_likelihood(
+          i, eta_, eta_gradient_, eta_Hessian_, nd);
+      if (nd > 0) {
+        add_coefficient_derivatives(i, eta_gradient_, eta_Hessian_,
+                                    gradient, nd > 1 ? &Hessian : nullptr);
+      }
+    }
+    return ans;
+  }
+
+  //----------------------------------------------------------------------
+  double SMS::log_posterior(const Vector &beta,
+                            Vector &gradient,
+                            Matrix &Hessian,
+                            int nd) const {
+    double ans = full_data_log_likelihood(beta, gradient, Hessian, nd);
+    Vector prior_gradient;
+    Matrix prior_Hessian;
+    ans += prior_->Logp(beta, prior_gradient, prior_Hessian, nd);
+    if (nd > 0) {
+      gradient += prior_gradient;
+      if (nd > 1) {
+        Hessian += prior_Hessian;
+      }
+    }
+    return ans;
+  }
+
+  //----------------------------------------------------------------------
+  void SMS::draw_subsample_slot(int slot) {
+    ControlVariate &cv(subsample_[slot]);
+    cv.observation = random_int_mt(rng(), 0, sample_size() - 1);
+    fill_linear_predictor(cv.observation, mode_, cv.eta);
+    cv.log_likelihood = observation_log_likelihood(
+        cv.observation, cv.eta, cv.gradient, cv.Hessian, 2);
+  }
+
+  void SMS::refresh_subsample() {
+    subsample_.resize(batch_size_);
+    for (int slot = 0; slot < batch_size_; ++slot) {
+      draw_subsample_slot(slot);
+    }
+    estimated_coefficients_.clear();
+  }
+
+  //----------------------------------------------------------------------
+  double SMS::estimate_log_likelihood(const Vector &beta,
+                                      double &variance) const {
+    // The sum of the control variates over the full data set.
+    Vector delta = beta - mode_;
+    double ans = log_likelihood_at_mode_ + gradient_at_mode_.dot(delta)
+        + 0.5 * quadratic_form(Hessian_at_mode_, delta);
+
+    // The estimated sum of the differences between the log likelihood
+    // and the control variates.
+    int m = subsample_.size();
+    double sum = 0;
+    double sumsq = 0;
+    for (int slot = 0; slot < m; ++slot) {
+      const ControlVariate &cv(subsample_[slot]);
+      fill_linear_predictor(cv.observation, beta, eta_);
+      double loglike = observation_log_likelihood(
+          cv.observation, eta_, eta_gradient_, eta_Hessian_, 0);
+      eta_ -= cv.eta;
+      double approximation = cv.log_likelihood + cv.gradient.dot(eta_)
+          + 0.5 * quadratic_form(cv.Hessian, eta_);
+      double difference = loglike - approximation;
+      sum += difference;
+      sumsq += difference * difference;
+    }
+    double n = sample_size();
+    double mean = sum / m;
+    variance = n * n * (sumsq - m * mean * mean) / (m - 1) / m;
+    return ans + n * mean - 0.5 * variance;
+  }
+
+  //----------------------------------------------------------------------
+  int SMS::block_begin(int block) const {
+    int nblocks = std::min<int>(number_of_blocks_, subsample_.size());
+    return static_cast<int64_t>(block) * subsample_.size() / nblocks;
+  }
+
+  int SMS::block_end(int block) const {
+    return block_begin(block + 1);
+  }
+
+  //----------------------------------------------------------------------
+  // The variance of the estimator is inversely proportional to the
+  // batch size, so rescaling the batch size by variance / target
+  // moves the variance toward the target.  Small discrepancies are
+  // ignored because the variance estimate is itself noisy, and the
+  // batch size is kept large enough for the variance estimate to be
+  // meaningful.
+  void SMS::adapt() {
+    if (adaptation_iterations_remaining_ <= 0) return;
+    --adaptation_iterations_remaining_;
+    double ratio = variance_ / target_variance_;
+    if (ratio < 0.5 || ratio > 2.0) {
+      double new_size = std::round(batch_size_ * ratio);
+      new_size = std::max<double>(new_size, min_adapted_batch_size_);
+      new_size = std::min<double>(new_size, sample_size());
+      batch_size_ = lround(new_size);
+    }
+  }
+
+  //======================================================================
+  BinomialLogitSubsamplingSampler::BinomialLogitSubsamplingSampler(
+      BinomialLogitModel *model,
+      Ptr<MvnBase> prior,
+      int batch_size,
+      double nu,
+      RNG &seeding_rng)
+      : SubsamplingMhSampler(prior, batch_size, nu, seeding_rng),
+        model_(model)
+  {}
+
+  int BinomialLogitSubsamplingSampler::sample_size() const {
+    return model_->dat().size();
+  }
+
+  const Vector &BinomialLogitSubsamplingSampler::coefficients() const {
+    return model_->Beta();
+  }
+
+  void BinomialLogitSubsamplingSampler::set_coefficients(const Vector &beta) {
+    model_->set_Beta(beta);
+  }
+
+  void BinomialLogitSubsamplingSampler::fill_linear_predictor(
+      int i, const Vector &beta, Vector &eta) const {
+    eta.resize(1);
+    eta[0] = beta.dot(model_->dat()[i]->x()) - model_->log_alpha();
+  }
+
+  // l(eta) = y * eta - n * log(1 + exp(eta)), omitting the binomial
+  // coefficient.
+  double BinomialLogitSubsamplingSampler::observation_log_likelihood(
+      int i, const Vector &eta, Vector &gradient, Matrix &Hessian,
+      int nd) const {
+    const BinomialRegressionData &data(*model_->dat()[i]);
+    double y = data.y();
+    double n = data.n();
+    double ans = y * eta[0] - n * lse2(0, eta[0]);
+    if (nd > 0) {
+      double prob = plogis(eta[0]);
+      gradient.resize(1);
+      gradient[0] = y - n * prob;
+      if (nd > 1) {
+        Hessian.resize(1, 1);
+        Hessian(0, 0) = -n * prob * (1 - prob);
+      }
+    }
+    return ans;
+  }
+
+  void BinomialLogitSubsamplingSampler::add_coefficient_derivatives(
+      int i, const Vector &eta_gradient, const Matrix &eta_Hessian,
+      Vector &gradient, Matrix *Hessian) const {
+    const Vector &x(model_->dat()[i]->x());
+    gradient.axpy(x, eta_gradient[0]);
+    if (Hessian) {
+      Hessian->add_outer(x, x, eta_Hessian(0, 0));
+    }
+  }
+
+  //======================================================================
+  PoissonRegressionSubsamplingSampler::PoissonRegressionSubsamplingSampler(
+      PoissonRegressionModel *model,
+      Ptr<MvnBase> prior,
+      int batch_size,
+      double nu,
+      RNG &seeding_rng)
+      : SubsamplingMhSampler(prior, batch_size, nu, seeding_rng),
+        model_(model)
+  {}
+
+  int PoissonRegressionSubsamplingSampler::sample_size() const {
+    return model_->dat().size();
+  }
+
+  const Vector &PoissonRegressionSubsamplingSampler::coefficients() const {
+    return model_->Beta();
+  }
+
+  void PoissonRegressionSubsamplingSampler::set_coefficients(
+      const Vector &beta) {
+    model_->set_Beta(beta);
+  }
+
+  void PoissonRegressionSubsamplingSampler::fill_linear_predictor(
+      int i, const Vector &beta, Vector &eta) const {
+    eta.resize(1);
+    eta[0] = beta.dot(model_->dat()[i]->x());
+  }
+
+  // l(eta) = y * eta - exposure * exp(eta), omitting terms that do
+  // not depend on eta.
+  double PoissonRegressionSubsamplingSampler::observation_log_likelihood(
+      int i, const Vector &eta, Vector &gradient, Matrix &Hessian,
+      int nd) const {
+    const PoissonRegressionData &data(*model_->dat()[i]);
+    double y = data.y();
+    double lambda = data.exposure() * exp(eta[0]);
+    double ans = y * eta[0] - lambda;
+    if (nd > 0) {
+      gradient.resize(1);
+      gradient[0] = y - lambda;
+      if (nd > 1) {
+        Hessian.resize(1, 1);
+        Hessian(0, 0) = -lambda;
+      }
+    }
+    return ans;
+  }
+
+  void PoissonRegressionSubsamplingSampler::add_coefficient_derivatives(
+      int i, const Vector &eta_gradient, const Matrix &eta_Hessian,
+      Vector &gradient, Matrix *Hessian) const {
+    const Vector &x(model_->dat()[i]->x());
+    gradient.axpy(x, eta_gradient[0]);
+    if (Hessian) {
+      Hessian->add_outer(x, x, eta_Hessian(0, 0));
+    }
+  }
+
+  //======================================================================
+  MultinomialLogitSubsamplingSampler::MultinomialLogitSubsamplingSampler(
+      MultinomialLogitModel *model,
+      Ptr<MvnBase> prior,
+      int batch_size,
+      double nu,
+      RNG &seeding_rng)
+      : SubsamplingMhSampler(prior, batch_size, nu, seeding_rng),
+        model_(model)
+  {}
+
+  int MultinomialLogitSubsamplingSampler::sample_size() const {
+    return model_->dat().size();
+  }
+
+  const Vector &MultinomialLogitSubsamplingSampler::coefficients() const {
+    return model_->beta();
+  }
+
+  void MultinomialLogitSubsamplingSampler::set_coefficients(
+      const Vector &beta) {
+    model_->set_beta(beta);
+  }
+
+  void MultinomialLogitSubsamplingSampler::fill_linear_predictor(
+      int i, const Vector &beta, Vector &eta) const {
+    model_->fill_eta(*model_->dat()[i], eta, beta);
+  }
+
+  // l(eta) = eta[y] - log(sum(exp(eta))), where eta is offset by the
+  // log sampling probabilities if the model was fit to a
+  // retrospective sample.  The gradient is e_y - p, and the Hessian
+  // is p * p^T - diag(p), where p is the vector of choice
+  // probabilities.
+  double MultinomialLogitSubsamplingSampler::observation_log_likelihood(
+      int i, const Vector &eta, Vector &gradient, Matrix &Hessian,
+      int nd) const {
+    int y = model_->dat()[i]->value();
+    int M = eta.size();
+    probs_ = eta;
+    if (model_->log_sampling_probs().size() == M) {
+      probs_ += model_->log_sampling_probs();
+    }
+    double lognc = lse(probs_);
+    double ans = probs_[y] - lognc;
+    if (nd > 0) {
+      for (int m = 0; m < M; ++m) {
+        probs_[m] = exp(probs_[m] - lognc);
+      }
+      gradient = probs_ * -1.0;
+      gradient[y] += 1.0;
+      if (nd > 1) {
+        Hessian.resize(M, M);
+        Hessian = 0.0;
+        Hessian.add_outer(probs_, probs_);
+        for (int m = 0; m < M; ++m) {
+          Hessian(m, m) -= probs_[m];
+        }
+      }
+    }
+    return ans;
+  }
+
+  // Row m of the design matrix for an observation contains the
+  // subject predictors in the coefficient block for choice m (there is
+  // no block for choice 0), followed by the choice predictors for
+  // choice m.
+  void MultinomialLogitSubsamplingSampler::add_coefficient_derivatives(
+      int i, const Vector &eta_gradient, const Matrix &eta_Hessian,
+      Vector &gradient, Matrix *Hessian) const {
+    const ChoiceData &data(*model_->dat()[i]);
+    int M = model_->Nchoices();
+    int psub = model_->subject_nvars();
+    int pch = model_->choice_nvars();
+    int choice_offset = (M - 1) * psub;
+    const Vector &xsub(data.Xsubject());
+    Matrix xchoice(M, pch);
+    for (int m = 0; m < M; ++m) {
+      if (pch > 0) xchoice.row(m) = data.Xchoice(m);
+    }
+
+    for (int m = 1; m < M; ++m) {
+      VectorView(gradient, (m - 1) * psub, psub).axpy(xsub, eta_gradient[m]);
+    }
+    if (pch > 0) {
+      VectorView(gradient, choice_offset, pch) +=
+          xchoice.Tmult(eta_gradient);
+    }
+    if (!Hessian) return;
+
+    Matrix &H(*Hessian);
+    for (int m = 1; m < M; ++m) {
+      int row_offset = (m - 1) * psub;
+      for (int m2 = 1; m2 < M; ++m2) {
+        int col_offset = (m2 - 1) * psub;
+        double h = eta_Hessian(m, m2);
+        for (int k = 0; k < psub; ++k) {
+          for (int j = 0; j < psub; ++j) {
+            H(row_offset + j, col_offset + k) += h * xsub[j] * xsub[k];
+          }
+        }
+      }
+    }
+    if (pch > 0) {
+      Matrix H_xchoice = eta_Hessian * xchoice;
+      for (int m = 1; m < M; ++m) {
+        int row_offset = (m - 1) * psub;
+        for (int k = 0; k < pch; ++k) {
+          for (int j = 0; j < psub; ++j) {
+            double value = xsub[j] * H_xchoice(m, k);
+            H(row_offset + j, choice_offset + k) += value;
+            H(choice_offset + k, row_offset + j) += value;
+          }
+        }
+      }
+      SubMatrix(H, choice_offset, choice_offset + pch - 1,
+                choice_offset, choice_offset + pch - 1) +=
+          xchoice.Tmult(H_xchoice);
+    }
+  }
+
+}  // namespace BOOM
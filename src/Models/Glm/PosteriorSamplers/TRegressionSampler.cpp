@@ -86,6 +86,7 @@ namespace BOOM {
         nu_prior_(nu_prior),
         weight_model_(new ScaledChisqModel(model_->nu())),
         complete_data_sufficient_statistics_(model_->xdim()),
+        buffer_(model_->xdim()),
         sigsq_sampler_(siginv_prior_),
         nu_observed_data_sampler_(
             TRegressionLogPosterior(model_, nu_prior_),
@@ -128,11 +129,13 @@ namespace BOOM {
         double weight = data_imputer_.impute(
             rng(), residual, model_->sigma(), model_->nu());
         weight_model_->suf()->update_raw(weight);
-        complete_data_sufficient_statistics_.add_data(
-            data[i]->x(),
-            data[i]->y(),
-            weight);
+        if (buffer_.add(data[i]->x(), data[i]->y(), weight)) {
+          complete_data_sufficient_statistics_.add_data(buffer_);
+          buffer_.clear();
+        }
       }
+      complete_data_sufficient_statistics_.add_data(buffer_);
+      buffer_.clear();
     }
   }
 
@@ -453,6 +453,33 @@ namespace BOOM{
     xtx_is_fixed_ = fix;
   }
 
+  void NeRegSuf::fix_xtx(const SpdMatrix &xtx){
+    if(xtx.nrow() != xtx_.nrow()){
+      report_error("Wrong size xtx in NeRegSuf::fix_xtx.");
+    }
+    xtx_ = xtx;
+    needs_to_reflect_ = false;
+    xtx_is_fixed_ = true;
+  }
+
+  void NeRegSuf::add_offset_group(const Vector &xty,
+                                  const Vector &x_sums,
+                                  double yty,
+                                  double ysum,
+                                  double n,
+                                  double offset){
+    if(!xtx_is_fixed_){
+      report_error("NeRegSuf::add_offset_group requires xtx to be fixed.");
+    }
+    // sum (y - offset) * x = X'y - offset * X'1
+    xty_ += xty;
+    xty_.axpy(x_sums, -offset);
+    sumsqy += yty - 2 * offset * ysum + n * offset * offset;
+    sumy_ += ysum - n * offset;
+    n_ += n;
+    x_column_sums_ += x_sums;
+  }
+
   void NeRegSuf::reflect()const{
     if(needs_to_reflect_){
       xtx_.reflect();
@@ -0,0 +1,82 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/Glm/WeightedCrossProductBuffer.hpp>
+#include <LinAlg/blas.hpp>
+#include <cpputil/report_error.hpp>
+#include <cmath>
+
+namespace BOOM {
+
+  WeightedCrossProductBuffer::WeightedCrossProductBuffer(int xdim,
+                                                         int capacity)
+      : scaled_predictors_(capacity > 0 ? capacity : 1, xdim),
+        scaled_responses_(capacity > 0 ? capacity : 1),
+        size_(0),
+        yt_w_y_(0),
+        sumlogw_(0)
+  {}
+
+  bool WeightedCrossProductBuffer::add(
+      const ConstVectorView &x, double y, double w) {
+    if (w < 0) {
+      report_error("Negative weight passed to WeightedCrossProductBuffer.");
+    }
+    if (x.size() != xdim()) {
+      report_error("Wrong size predictor vector passed to "
+                   "WeightedCrossProductBuffer.");
+    }
+    if (size_ >= capacity()) {
+      report_error("WeightedCrossProductBuffer is full.");
+    }
+    double root_w = std::sqrt(w);
+    int dim = xdim();
+    for (int j = 0; j < dim; ++j) {
+      scaled_predictors_(size_, j) = root_w * x[j];
+    }
+    scaled_responses_[size_] = root_w * y;
+    yt_w_y_ += w * y * y;
+    sumlogw_ += std::log(w);
+    return ++size_ == capacity();
+  }
+
+  void WeightedCrossProductBuffer::accumulate(SpdMatrix &xtwx,
+                                              Vector &xtwy) const {
+    int dim = xdim();
+    if (xtwx.nrow() != dim || xtwy.size() != dim) {
+      report_error("Wrong size arguments passed to "
+                   "WeightedCrossProductBuffer::accumulate.");
+    }
+    if (size_ == 0 || dim == 0) return;
+    int lda = scaled_predictors_.nrow();
+    blas::dsyrk(blas::Upper, blas::Trans, dim, size_, 1.0,
+                scaled_predictors_.data(), lda,
+                1.0, xtwx.data(), dim);
+    blas::dgemv(blas::Trans, size_, dim, 1.0,
+                scaled_predictors_.data(), lda,
+                scaled_responses_.data(), 1,
+                1.0, xtwy.data(), 1);
+  }
+
+  void WeightedCrossProductBuffer::clear() {
+    size_ = 0;
+    yt_w_y_ = 0;
+    sumlogw_ = 0;
+  }
+
+}  // namespace BOOM
@@ -169,6 +169,14 @@ namespace BOOM{
     sym_ = false;
   }
 
+  void WRS::add_data(const WeightedCrossProductBuffer &buffer) {
+    n_ += buffer.size();
+    yt_w_y_ += buffer.yt_w_y();
+    sumlogw_ += buffer.sumlogw();
+    buffer.accumulate(xtwx_, xtwy_);
+    sym_ = false;
+  }
+
   void WRS::clear() {
     xtwx_=0.0;
     xtwy_ = 0.0;
@@ -17,7 +17,10 @@
 */
 
 #include <Models/Glm/ZeroInflatedGammaRegression.hpp>
+#include <LinAlg/SubMatrix.hpp>
+#include <cpputil/report_error.hpp>
 #include <distributions.hpp>
+#include <numopt/initialize_derivatives.hpp>
 
 namespace BOOM {
   namespace {
@@ -132,4 +135,54 @@ namespace BOOM {
     return (u > p ? 0 : gamma_model_->sim(x, rng));
   }
 
+  double ZIGRM::log_likelihood(const Vector &parameters,
+                               Vector *gradient,
+                               Matrix *hessian,
+                               bool reset_derivatives) const {
+    int gamma_dim = 1 + regression_coefficients().nvars();
+    int logit_dim = logit_coefficients().nvars();
+    int dim = gamma_dim + logit_dim;
+    if (parameters.size() != dim) {
+      report_error("Wrong size parameter vector passed to "
+                   "ZeroInflatedGammaRegressionModel::log_likelihood.");
+    }
+    initialize_derivatives(gradient, hessian, dim, reset_derivatives);
+    int nd = gradient ? (hessian ? 2 : 1) : 0;
+
+    Vector gamma_gradient;
+    Matrix gamma_hessian;
+    double ans = gamma_model_->Loglike(
+        Vector(ConstVectorView(parameters, 0, gamma_dim)),
+        gamma_gradient, gamma_hessian, nd);
+    Vector logit_gradient;
+    Matrix logit_hessian;
+    ans += logit_model_->log_likelihood(
+        Vector(ConstVectorView(parameters, gamma_dim)),
+        gradient ? &logit_gradient : nullptr,
+        hessian ? &logit_hessian : nullptr,
+        true);
+    if (gradient) {
+      VectorView(*gradient, 0, gamma_dim) += gamma_gradient;
+      if (logit_dim > 0) {
+        VectorView(*gradient, gamma_dim) += logit_gradient;
+      }
+      if (hessian) {
+        SubMatrix(*hessian, 0, gamma_dim - 1, 0, gamma_dim - 1) +=
+            gamma_hessian;
+        if (logit_dim > 0) {
+          SubMatrix(*hessian, gamma_dim, dim - 1, gamma_dim, dim - 1) +=
+              logit_hessian;
+        }
+      }
+    }
+    return ans;
+  }
+
+  d2TargetFunPointerAdapter ZIGRM::log_likelihood_tf() const {
+    return d2TargetFunPointerAdapter(
+        [this](const Vector &x, Vector *gradient,
+               Matrix *hessian, bool reset) {
+          return this->log_likelihood(x, gradient, hessian, reset);});
+  }
+
 }  // namespace BOOM
@@ -16,9 +16,14 @@
   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
 */
 #include <Models/Glm/ZeroInflatedLognormalRegression.hpp>
+#include <Models/Glm/GlmDerivativeKernels.hpp>
+#include <LinAlg/SubMatrix.hpp>
 #include <distributions.hpp>
+#include <cpputil/Constants.hpp>
 #include <cpputil/math_utils.hpp>
 #include <cpputil/report_error.hpp>
+#include <numopt/initialize_derivatives.hpp>
+#include <stats/logit.hpp>
 
 namespace BOOM {
 
@@ -31,11 +36,26 @@ namespace {
       : ParamPolicy(new GlmCoefs(dimension),
                     new UnivParams(1.0),
                     new GlmCoefs(dimension)),
-        zero_threshold_(zero_threshold)
+        zero_threshold_(zero_threshold),
+        packed_design_current_(false)
   {}
 
   ZILRM * ZILRM::clone() const { return new ZILRM(*this);}
 
+  void ZILRM::add_data(Ptr<Data> dp) {
+    add_data(DAT(dp));
+  }
+
+  void ZILRM::add_data(Ptr<RegressionData> dp) {
+    packed_design_current_ = false;
+    DataPolicy::add_data(dp);
+  }
+
+  void ZILRM::clear_data() {
+    packed_design_current_ = false;
+    DataPolicy::clear_data();
+  }
+
   double ZILRM::expected_value(const Vector &x) const {
     double mu = regression_coefficients().predict(x);
     return probability_nonzero(x) * exp(mu + 0.5 * sigsq());
@@ -134,4 +154,113 @@ namespace {
         number_of_zeros, number_of_positives, sum, sum_of_logs_of_positives);
   }
 
+  // With eta = beta.dot(x) and zeta = alpha.dot(x), a positive
+  // observation y contributes
+  //
+  //   zeta - lope(zeta) - .5 * log(2 * pi * sigsq)
+  //     - (log(y) - eta)^2 / (2 * sigsq) - log(y),
+  //
+  // and a zero contributes -lope(zeta).
+  double ZILRM::log_likelihood(const Vector &coefficients,
+                               Vector *gradient,
+                               Matrix *hessian,
+                               bool reset_derivatives) const {
+    const Selector &regression_inc(regression_coefficients().inc());
+    const Selector &logit_inc(logit_coefficients().inc());
+    int regression_dim = regression_inc.nvars();
+    int logit_dim = logit_inc.nvars();
+    int dim = regression_dim + logit_dim;
+    if (coefficients.size() != dim) {
+      std::ostringstream err;
+      err << "Error in ZeroInflatedLognormalRegressionModel::log_likelihood.  "
+          << "Argument is of dimension " << coefficients.size()
+          << " but there are " << regression_dim
+          << " included regression coefficients and " << logit_dim
+          << " included logit coefficients." << std::endl;
+      report_error(err.str());
+    }
+    initialize_derivatives(gradient, hessian, dim, reset_derivatives);
+    if (!packed_design_current_) refresh_packed_design();
+
+    Matrix regression_workspace, logit_workspace;
+    const Matrix &regression_design(
+        included_columns(design_, regression_inc, regression_workspace));
+    const Matrix &logit_design(
+        included_columns(design_, logit_inc, logit_workspace));
+    int n = design_.nrow();
+    Vector eta(n, 0.0);
+    Vector zeta(n, 0.0);
+    if (n > 0) {
+      if (regression_dim > 0) {
+        regression_design.mult(
+            Vector(ConstVectorView(coefficients, 0, regression_dim)), eta);
+      }
+      if (logit_dim > 0) {
+        logit_design.mult(
+            Vector(ConstVectorView(coefficients, regression_dim)), zeta);
+      }
+    }
+
+    const std::vector<Ptr<RegressionData>> &data(dat());
+    double sigsq = this->sigsq();
+    double log_normalizing_constant = -Constants::log_root_2pi - .5 * log(sigsq);
+    Vector d_eta(n, 0.0), d_zeta(n), d2_eta(n, 0.0), d2_zeta(n);
+    double ans = 0;
+    for (int i = 0; i < n; ++i) {
+      double y = data[i]->y();
+      bool positive = y > zero_threshold_;
+      ans -= lope(zeta[i]);
+      if (positive) {
+        double log_y = log(y);
+        double residual = log_y - eta[i];
+        ans += zeta[i] + log_normalizing_constant
+            - .5 * square(residual) / sigsq - log_y;
+        d_eta[i] = residual / sigsq;
+        d2_eta[i] = -1.0 / sigsq;
+      }
+      double p = plogis(zeta[i]);
+      d_zeta[i] = positive - p;
+      d2_zeta[i] = -p * (1 - p);
+    }
+
+    if (gradient && n > 0) {
+      if (regression_dim > 0) {
+        VectorView(*gradient, 0, regression_dim) +=
+            regression_design.Tmult(d_eta);
+      }
+      if (logit_dim > 0) {
+        VectorView(*gradient, regression_dim) += logit_design.Tmult(d_zeta);
+      }
+      if (hessian) {
+        if (regression_dim > 0) {
+          SubMatrix(*hessian, 0, regression_dim - 1,
+                    0, regression_dim - 1) +=
+              weighted_inner_product(regression_design, d2_eta);
+        }
+        if (logit_dim > 0) {
+          SubMatrix(*hessian, regression_dim, dim - 1,
+                    regression_dim, dim - 1) +=
+              weighted_inner_product(logit_design, d2_zeta);
+        }
+      }
+    }
+    return ans;
+  }
+
+  void ZILRM::refresh_packed_design() const {
+    const std::vector<Ptr<RegressionData>> &data(dat());
+    design_.resize(data.size(), regression_coefficients().nvars_possible());
+    for (int i = 0; i < data.size(); ++i) {
+      design_.row(i) = data[i]->x();
+    }
+    packed_design_current_ = true;
+  }
+
+  d2TargetFunPointerAdapter ZILRM::log_likelihood_tf() const {
+    return d2TargetFunPointerAdapter(
+        [this](const Vector &x, Vector *gradient,
+               Matrix *hessian, bool reset) {
+          return this->log_likelihood(x, gradient, hessian, reset);});
+  }
+
 }  // namespace BOOM
@@ -17,8 +17,13 @@
 */
 
 #include <Models/Glm/ZeroInflatedPoissonRegression.hpp>
-#include <distributions.hpp>
+#include <Models/Glm/GlmDerivativeKernels.hpp>
+#include <LinAlg/SubMatrix.hpp>
 #include <cpputil/report_error.hpp>
+#include <distributions.hpp>
+#include <numopt.hpp>
+#include <numopt/initialize_derivatives.hpp>
+#include <stats/logit.hpp>
 
 namespace BOOM {
 
@@ -82,11 +87,26 @@ namespace BOOM {
   //======================================================================
   typedef ZeroInflatedPoissonRegressionModel ZIPRM;
   ZIPRM::ZeroInflatedPoissonRegressionModel(int dimension)
-      : ParamPolicy(new GlmCoefs(dimension), new GlmCoefs(dimension))
+      : ParamPolicy(new GlmCoefs(dimension), new GlmCoefs(dimension)),
+        packed_design_current_(false)
   {}
 
   ZIPRM * ZIPRM::clone() const { return new ZIPRM(*this); }
 
+  void ZIPRM::add_data(Ptr<Data> dp) {
+    add_data(DAT(dp));
+  }
+
+  void ZIPRM::add_data(Ptr<ZeroInflatedPoissonRegressionData> dp) {
+    packed_design_current_ = false;
+    DataPolicy::add_data(dp);
+  }
+
+  void ZIPRM::clear_data() {
+    packed_design_current_ = false;
+    DataPolicy::clear_data();
+  }
+
   double ZIPRM::expected_value(const Vector &x) const {
     return probability_unconstrained(x) * poisson_mean(x);
   }
@@ -134,4 +154,173 @@ namespace BOOM {
     return ZeroInflatedPoissonSuf(
         number_of_zeros, number_of_positives, sum_of_positives);
   }
-}
+
+  // Let lambda = exp(eta) with eta = beta.dot(x), and p = plogis(zeta)
+  // with zeta = delta.dot(x).  An observation with Z zero trials, P
+  // positive trials, and Y total events contributes
+  //
+  //   Z * log(1 - p + p * exp(-lambda)) + P * (log(p) - lambda) + Y * eta
+  //
+  // to the log likelihood (dropping the log factorials of the
+  // individual positive counts, which do not depend on the
+  // parameters).  The log probability of a zero trial is
+  // lope(zeta - lambda) - lope(zeta).  With a = plogis(zeta -
+  // lambda), the posterior probability that a zero trial was
+  // unconstrained, the derivatives with respect to the linear
+  // predictors are
+  //
+  //   d / deta = Y - lambda * (P + Z * a)
+  //   d / dzeta = P * (1 - p) + Z * (a - p)
+  //   d^2 / deta^2 = Z * lambda * a * ((1 - a) * lambda - 1) - P * lambda
+  //   d^2 / dzeta^2 = Z * (a * (1 - a) - p * (1 - p)) - P * p * (1 - p)
+  //   d^2 / deta dzeta = -Z * lambda * a * (1 - a).
+  double ZIPRM::log_likelihood(const Vector &coefficients,
+                               Vector *gradient,
+                               Matrix *hessian,
+                               bool reset_derivatives) const {
+    const Selector &poisson_inc(poisson_coefficients().inc());
+    const Selector &logit_inc(logit_coefficients().inc());
+    int poisson_dim = poisson_inc.nvars();
+    int logit_dim = logit_inc.nvars();
+    int dim = poisson_dim + logit_dim;
+    if (coefficients.size() != dim) {
+      std::ostringstream err;
+      err << "Error in ZeroInflatedPoissonRegressionModel::log_likelihood.  "
+          << "Argument is of dimension " << coefficients.size()
+          << " but there are " << poisson_dim
+          << " included Poisson coefficients and " << logit_dim
+          << " included logit coefficients." << std::endl;
+      report_error(err.str());
+    }
+    initialize_derivatives(gradient, hessian, dim, reset_derivatives);
+    if (!packed_design_current_) refresh_packed_design();
+
+    Matrix poisson_workspace, logit_workspace;
+    const Matrix &poisson_design(
+        included_columns(design_, poisson_inc, poisson_workspace));
+    const Matrix &logit_design(
+        included_columns(design_, logit_inc, logit_workspace));
+    int n = design_.nrow();
+    Vector eta(n, 0.0);
+    Vector zeta(n, 0.0);
+    if (n > 0) {
+      if (poisson_dim > 0) {
+        poisson_design.mult(
+            Vector(ConstVectorView(coefficients, 0, poisson_dim)), eta);
+      }
+      if (logit_dim > 0) {
+        logit_design.mult(
+            Vector(ConstVectorView(coefficients, poisson_dim)), zeta);
+      }
+    }
+
+    const std::vector<Ptr<ZeroInflatedPoissonRegressionData>> &data(dat());
+    Vector d_eta(n), d_zeta(n), d2_eta(n), d2_zeta(n), d2_cross(n);
+    double ans = 0;
+    for (int i = 0; i < n; ++i) {
+      double zeros = data[i]->number_of_zero_trials();
+      double positives = data[i]->number_of_positive_trials();
+      double events = data[i]->y();
+      double lambda = exp(eta[i]);
+      double log_normalizer = lope(zeta[i]);
+      ans += zeros * (lope(zeta[i] - lambda) - log_normalizer)
+          + positives * (zeta[i] - log_normalizer - lambda)
+          + events * eta[i];
+      if (gradient) {
+        double p = plogis(zeta[i]);
+        double a = plogis(zeta[i] - lambda);
+        d_eta[i] = events - lambda * (positives + zeros * a);
+        d_zeta[i] = positives * (1 - p) + zeros * (a - p);
+        if (hessian) {
+          d2_eta[i] = zeros * lambda * a * ((1 - a) * lambda - 1)
+              - positives * lambda;
+          d2_zeta[i] = zeros * (a * (1 - a) - p * (1 - p))
+              - positives * p * (1 - p);
+          d2_cross[i] = -zeros * lambda * a * (1 - a);
+        }
+      }
+    }
+
+    if (gradient && n > 0) {
+      if (poisson_dim > 0) {
+        VectorView(*gradient, 0, poisson_dim) +=
+            poisson_design.Tmult(d_eta);
+      }
+      if (logit_dim > 0) {
+        VectorView(*gradient, poisson_dim) += logit_design.Tmult(d_zeta);
+      }
+      if (hessian) {
+        if (poisson_dim > 0) {
+          SubMatrix(*hessian, 0, poisson_dim - 1, 0, poisson_dim - 1) +=
+              weighted_inner_product(poisson_design, d2_eta);
+        }
+        if (logit_dim > 0) {
+          SubMatrix(*hessian, poisson_dim, dim - 1, poisson_dim, dim - 1) +=
+              weighted_inner_product(logit_design, d2_zeta);
+        }
+        if (poisson_dim > 0 && logit_dim > 0) {
+          Matrix cross = weighted_cross_product(
+              poisson_design, d2_cross, logit_design);
+          SubMatrix(*hessian, 0, poisson_dim - 1, poisson_dim, dim - 1) +=
+              cross;
+          SubMatrix(*hessian, poisson_dim, dim - 1, 0, poisson_dim - 1) +=
+              cross.t();
+        }
+      }
+    }
+    return ans;
+  }
+
+  double ZIPRM::log_likelihood() const {
+    Vector coefficients = concat(
+        poisson_coefficients().included_coefficients(),
+        logit_coefficients().included_coefficients());
+    return log_likelihood(coefficients);
+  }
+
+  bool ZIPRM::mle() {
+    Vector coefficients = concat(
+        poisson_coefficients().included_coefficients(),
+        logit_coefficients().included_coefficients());
+    d2TargetFunPointerAdapter target = log_likelihood_tf();
+    Vector gradient;
+    Matrix hessian;
+    double function_value;
+    std::string error_message;
+    bool ok = max_nd2_careful(coefficients,
+                              gradient,
+                              hessian,
+                              function_value,
+                              Target(target),
+                              dTarget(target),
+                              d2Target(target),
+                              1e-5,
+                              error_message);
+    if (ok) {
+      int poisson_dim = poisson_coefficients().inc().nvars();
+      prm1()->set_included_coefficients(
+          Vector(ConstVectorView(coefficients, 0, poisson_dim)));
+      prm2()->set_included_coefficients(
+          Vector(ConstVectorView(coefficients, poisson_dim)));
+    }
+    return ok;
+  }
+
+  void ZIPRM::refresh_packed_design() const {
+    const std::vector<Ptr<ZeroInflatedPoissonRegressionData>> &data(dat());
+    int xdim = poisson_coefficients().nvars_possible();
+    design_.resize(data.size(), xdim);
+    for (int i = 0; i < data.size(); ++i) {
+      design_.row(i) = data[i]->x();
+    }
+    packed_design_current_ = true;
+  }
+
+  d2TargetFunPointerAdapter ZIPRM::log_likelihood_tf() const {
+    return d2TargetFunPointerAdapter(
+        [this](const Vector &x, Vector *gradient,
+               Matrix *hessian, bool reset) {
+          return this->log_likelihood(x, gradient, hessian, reset);});
+  }
+
+}  // namespace BOOM
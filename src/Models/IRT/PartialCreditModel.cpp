@@ -21,8 +21,11 @@
 #include <Models/IRT/Subject.hpp>
 #include <cpputil/seq.hpp>
 #include <cpputil/lse.hpp>
+#include <cpputil/math_utils.hpp>
 #include <cpputil/report_error.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <stdexcept>
 
@@ -323,10 +326,23 @@ namespace BOOM{
     double PCR::response_prob(Response r, const Vector &Theta, bool logsc)const{
       return response_prob(r->value(), Theta, logsc);}
 
+    // eta[m] = beta[m] + (m+1) * theta * beta[M+1], which is
+    // fill_eta() written out so that it does not touch the mutable
+    // workspaces.  This lets several threads evaluate response
+    // probabilities at once, as long as beta is current.
     double PCR::response_prob(uint r, const Vector & Theta, bool logsc)const{
-      fill_eta(Theta);
-      double lognc = lse(eta_);
-      double ans = eta_[r] - lognc;
+      const Vector &b(beta());
+      uint M = maxscore();
+      double theta_slope = Theta[which_subscale()] * b[M + 1];
+      double max_eta = negative_infinity();
+      for (uint m = 0; m <= M; ++m) {
+        max_eta = std::max(max_eta, b[m] + (m + 1) * theta_slope);
+      }
+      double nc = 0;
+      for (uint m = 0; m <= M; ++m) {
+        nc += exp(b[m] + (m + 1) * theta_slope - max_eta);
+      }
+      double ans = b[r] + (r + 1) * theta_slope - max_eta - log(nc);
       return logsc ? ans : exp(ans);
     }
 
@@ -123,11 +123,15 @@ namespace BOOM{
     }
 
     double Subject::loglike()const{
+      return loglike(Theta());
+    }
+
+    double Subject::loglike(const Vector &theta)const{
       double ans=0;
       for(IrIterC it = responses_.begin(); it!=responses_.end(); ++it){
 	Ptr<Item> I = it->first;
 	Response resp = it->second;
-	ans += I->response_prob(resp, Theta(), true);
+	ans += I->response_prob(resp, theta, true);
       }
       return ans;
     }
@@ -23,6 +23,8 @@
 
 #include <cpputil/ParamHolder.hpp>
 #include <cpputil/math_utils.hpp>
+#include <distributions.hpp>
+#include <algorithm>
 
 namespace BOOM{
   namespace IRT{
@@ -52,16 +54,41 @@ namespace BOOM{
   sub(s),
     pri(p),
     target(sub, pri),
-    sam(new SliceSampler(target))
+    sam(new SliceSampler(target)),
+    prior_ldsi_(0),
+    number_of_threads_(1)
     { }
 
     SSS * SSS::clone()const{return new SSS(*this);}
 
     void SSS::draw(){
+      if (number_of_threads_ > 1) {
+        prior_mean_ = pri->mean(sub);
+        prior_siginv_ = pri->siginv();
+        prior_ldsi_ = prior_siginv_.logdet();
+      }
       Theta = sam->draw(sub->Theta());
       sub->set_Theta(Theta);
     }
 
+    void SSS::set_number_of_threads(int n){
+      number_of_threads_ = std::max(n, 1);
+      if (number_of_threads_ <= 1) {
+        sam->set_batch_target(BatchFunc(), 1);
+        return;
+      }
+      ParallelBatchTarget batch_target(
+          [this](const Vector &theta) {return this->parallel_logp(theta);},
+          number_of_threads_);
+      sam->set_batch_target(batch_target, number_of_threads_);
+    }
+
+    double SSS::parallel_logp(const Vector &theta)const{
+      double ans = dmvn(theta, prior_mean_, prior_siginv_, prior_ldsi_, true);
+      if(ans==BOOM::negative_infinity()) return ans;
+      return ans + sub->loglike(theta);
+    }
+
     double SSS::logpri()const{ return pri->pdf(sub, true);}
 
   }
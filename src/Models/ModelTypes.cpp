@@ -122,6 +122,28 @@ namespace BOOM{
     return sampler(0)->can_increment_log_prior_gradient();
   }
 
+  //============================================================
+  void TemperableModel::set_likelihood_power(double power) {
+    if (power < 0 || power > 1) {
+      report_error("The likelihood power must be between 0 and 1.");
+    }
+    likelihood_power_ = power;
+  }
+
+  bool TemperableModel::can_be_tempered() const {
+    int number_of_methods = number_of_sampling_methods();
+    if (number_of_methods == 0) return false;
+    for (int i = 0; i < number_of_methods; ++i) {
+      if (!sampler(i)->can_temper_likelihood()) return false;
+    }
+    return true;
+  }
+
+  double TemperableModel::log_likelihood() const {
+    report_error("This model does not implement log_likelihood().");
+    return negative_infinity();
+  }
+
   //============================================================
   void MLE_Model::initialize_params(){ mle(); }
 
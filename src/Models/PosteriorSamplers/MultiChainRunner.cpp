@@ -0,0 +1,155 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/PosteriorSamplers/MultiChainRunner.hpp>
+#include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
+#include <algorithm>
+
+namespace BOOM {
+
+  MultiChainRunner::MultiChainRunner(const Ptr<Model> &prototype,
+                                     int number_of_chains,
+                                     const ChainSetup &setup,
+                                     RNG &seeding_rng)
+      : parameter_dimension_(prototype->vectorize_params(true).size()),
+        draws_(number_of_chains),
+        diagnostics_(parameter_dimension_,
+                     StreamingConvergenceDiagnostics(
+                         std::max(number_of_chains, 1))),
+        number_of_iterations_(0),
+        max_rhat_(1.01),
+        min_effective_sample_size_(400),
+        check_interval_(100),
+        converged_(false),
+        rhat_(parameter_dimension_, infinity()),
+        effective_sample_size_(parameter_dimension_, 0.0)
+  {
+    if (number_of_chains < 1) {
+      report_error("MultiChainRunner needs at least one chain.");
+    }
+    for (int i = 0; i < number_of_chains; ++i) {
+      Ptr<Model> chain(prototype->clone());
+      RNG chain_seeding_rng(seed_rng(seeding_rng));
+      setup(chain.get(), chain_seeding_rng);
+      chains_.push_back(chain);
+      chain_rngs_.push_back(RNG(seed_rng(seeding_rng)));
+    }
+  }
+
+  void MultiChainRunner::set_number_of_threads(int n) {
+    pool_.set_number_of_threads(n <= 1 ? 0 : n);
+  }
+
+  void MultiChainRunner::set_convergence_criteria(
+      double max_rhat, double min_effective_sample_size) {
+    if (max_rhat < 1.0) {
+      report_error("max_rhat must be at least 1.");
+    }
+    max_rhat_ = max_rhat;
+    min_effective_sample_size_ = min_effective_sample_size;
+  }
+
+  void MultiChainRunner::set_check_interval(int iterations) {
+    if (iterations < 1) {
+      report_error("Check interval must be positive.");
+    }
+    check_interval_ = iterations;
+  }
+
+  void MultiChainRunner::set_initial_value_perturbation(
+      const InitialValuePerturbation &perturb) {
+    perturb_ = perturb;
+  }
+
+  int MultiChainRunner::run(int max_iterations, int burn) {
+    for (int i = 0; i < draws_.size(); ++i) {
+      draws_[i].clear();
+      draws_[i].reserve(static_cast<size_t>(max_iterations)
+                        * parameter_dimension_);
+    }
+    for (int j = 0; j < diagnostics_.size(); ++j) {
+      diagnostics_[j].clear();
+    }
+    number_of_iterations_ = 0;
+    converged_ = false;
+
+    if (perturb_) {
+      for (int i = 0; i < chains_.size(); ++i) {
+        perturb_(chains_[i].get(), chain_rngs_[i]);
+      }
+    }
+    if (burn > 0) {
+      run_all_chains(burn, false);
+    }
+    while (number_of_iterations_ < max_iterations) {
+      int iterations = std::min(check_interval_,
+                                max_iterations - number_of_iterations_);
+      run_all_chains(iterations, true);
+      number_of_iterations_ += iterations;
+      update_diagnostics();
+      if (converged_) break;
+    }
+    return number_of_iterations_;
+  }
+
+  Matrix MultiChainRunner::draws(int chain) const {
+    const std::vector<double> &chain_draws(draws_[chain]);
+    int niter = chain_draws.size() / std::max(parameter_dimension_, 1);
+    return Matrix(niter, parameter_dimension_, chain_draws, true);
+  }
+
+  void MultiChainRunner::run_chain(int i, int iterations, bool record) {
+    Model *model = chains_[i].get();
+    std::vector<double> &chain_draws(draws_[i]);
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+      model->sample_posterior();
+      if (record) {
+        Vector params = model->vectorize_params(true);
+        if (params.size() != parameter_dimension_) {
+          report_error("The dimension of vectorize_params() changed "
+                       "during MultiChainRunner::run.");
+        }
+        chain_draws.insert(chain_draws.end(), params.begin(), params.end());
+        for (int j = 0; j < parameter_dimension_; ++j) {
+          diagnostics_[j].add(i, params[j]);
+        }
+      }
+    }
+  }
+
+  void MultiChainRunner::run_all_chains(int iterations, bool record) {
+    pool_.run_jobs(chains_.size(), [this, iterations, record](int i) {
+        this->run_chain(i, iterations, record);
+      });
+  }
+
+  void MultiChainRunner::update_diagnostics() {
+    bool converged = true;
+    for (int j = 0; j < parameter_dimension_; ++j) {
+      rhat_[j] = diagnostics_[j].split_rhat();
+      effective_sample_size_[j] = diagnostics_[j].effective_sample_size();
+      if (rhat_[j] > max_rhat_
+          || effective_sample_size_[j] < min_effective_sample_size_) {
+        converged = false;
+      }
+    }
+    converged_ = converged;
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,180 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/PosteriorSamplers/ReplicaExchangeDriver.hpp>
+#include <distributions.hpp>
+#include <cpputil/report_error.hpp>
+#include <cmath>
+
+namespace BOOM {
+
+  ReplicaExchangeDriver::ReplicaExchangeDriver(
+      const Ptr<TemperableModel> &prototype,
+      int number_of_replicas,
+      const ReplicaSetup &setup,
+      RNG &seeding_rng)
+      : log_likelihood_(number_of_replicas, 0.0),
+        ladder_(number_of_replicas, 1.0),
+        adapt_ladder_(false),
+        target_swap_rate_(0.234),
+        number_of_swap_rounds_(0),
+        even_round_(true),
+        swap_attempts_(number_of_replicas - 1, 0),
+        swap_successes_(number_of_replicas - 1, 0),
+        rng_(seed_rng(seeding_rng))
+  {
+    if (number_of_replicas < 2) {
+      report_error("ReplicaExchangeDriver needs at least two replicas.");
+    }
+    for (int i = 0; i < number_of_replicas; ++i) {
+      Model *clone = prototype->clone();
+      Ptr<TemperableModel> replica(dynamic_cast<TemperableModel *>(clone));
+      if (!replica) {
+        delete clone;
+        report_error("The clone of a TemperableModel must be a "
+                     "TemperableModel.");
+      }
+      RNG replica_seeding_rng(seed_rng(seeding_rng));
+      setup(replica.get(), replica_seeding_rng);
+      if (!replica->can_be_tempered()) {
+        report_error("ReplicaExchangeDriver requires each replica's "
+                     "posterior samplers to respect likelihood_power().  "
+                     "Replicas run at power 1 would be swapped as if "
+                     "they were tempered.");
+      }
+      replicas_.push_back(replica);
+      level_.push_back(i);
+    }
+
+    Vector ladder(number_of_replicas);
+    double min_power = 0.01;
+    for (int k = 0; k < number_of_replicas; ++k) {
+      ladder[k] = pow(min_power, static_cast<double>(k)
+                      / (number_of_replicas - 1));
+    }
+    set_ladder(ladder);
+  }
+
+  void ReplicaExchangeDriver::set_number_of_threads(int n) {
+    pool_.set_number_of_threads(n <= 1 ? 0 : n);
+  }
+
+  void ReplicaExchangeDriver::set_ladder(const Vector &likelihood_powers) {
+    if (likelihood_powers.size() != replicas_.size()) {
+      report_error("The ladder must have one element per replica.");
+    }
+    if (likelihood_powers[0] != 1.0) {
+      report_error("The first rung of the ladder must be 1.");
+    }
+    for (int k = 1; k < likelihood_powers.size(); ++k) {
+      if (likelihood_powers[k] >= likelihood_powers[k - 1]
+          || likelihood_powers[k] <= 0) {
+        report_error("Ladder elements must be positive and strictly "
+                     "decreasing.");
+      }
+    }
+    ladder_ = likelihood_powers;
+    set_replica_powers();
+  }
+
+  void ReplicaExchangeDriver::allow_ladder_adaptation(
+      bool okay_to_adapt, double target_swap_rate) {
+    if (target_swap_rate <= 0 || target_swap_rate >= 1) {
+      report_error("Target swap rate must be strictly between 0 and 1.");
+    }
+    adapt_ladder_ = okay_to_adapt;
+    target_swap_rate_ = target_swap_rate;
+  }
+
+  void ReplicaExchangeDriver::iterate() {
+    update_replicas();
+    propose_swaps();
+  }
+
+  Vector ReplicaExchangeDriver::swap_acceptance_rates() const {
+    Vector ans(swap_attempts_.size(), 0.0);
+    for (int k = 0; k < ans.size(); ++k) {
+      if (swap_attempts_[k] > 0) {
+        ans[k] = static_cast<double>(swap_successes_[k]) / swap_attempts_[k];
+      }
+    }
+    return ans;
+  }
+
+  void ReplicaExchangeDriver::update_replicas() {
+    auto update = [this](int i) {
+      replicas_[i]->sample_posterior();
+      log_likelihood_[i] = replicas_[i]->tempered_log_likelihood();
+    };
+    pool_.run_jobs(replicas_.size(), update);
+  }
+
+  void ReplicaExchangeDriver::propose_swaps() {
+    int number_of_levels = level_.size();
+    Vector acceptance_probabilities(number_of_levels - 1, -1.0);
+    for (int k = even_round_ ? 0 : 1; k + 1 < number_of_levels; k += 2) {
+      int hot = level_[k + 1];
+      int cold = level_[k];
+      // The swap moves the hot replica's state to power ladder_[k],
+      // and the cold replica's state to power ladder_[k + 1].
+      double log_alpha = (ladder_[k] - ladder_[k + 1])
+          * (log_likelihood_[hot] - log_likelihood_[cold]);
+      double alpha = log_alpha >= 0 ? 1.0 : exp(log_alpha);
+      if (std::isnan(alpha)) alpha = 0;
+      acceptance_probabilities[k] = alpha;
+      ++swap_attempts_[k];
+      if (runif_mt(rng_) < alpha) {
+        ++swap_successes_[k];
+        std::swap(level_[k], level_[k + 1]);
+      }
+    }
+    even_round_ = !even_round_;
+    ++number_of_swap_rounds_;
+    if (adapt_ladder_) {
+      adapt_ladder(acceptance_probabilities);
+    }
+    set_replica_powers();
+  }
+
+  void ReplicaExchangeDriver::adapt_ladder(
+      const Vector &acceptance_probabilities) {
+    // The ladder is parameterized by temperatures T = 1 / beta, with
+    // T[k + 1] = T[k] + exp(rho[k]).  Each rho[k] moves up if swaps
+    // between levels k and k+1 are accepted more often than the
+    // target rate, and down if they are accepted less often.
+    double gain = 1.0 / pow(number_of_swap_rounds_ + 1.0, 0.6);
+    Vector ladder(ladder_);
+    double temperature = 1.0;
+    for (int k = 0; k + 1 < ladder.size(); ++k) {
+      double rho = log(1.0 / ladder_[k + 1] - 1.0 / ladder_[k]);
+      if (acceptance_probabilities[k] >= 0) {
+        rho += gain * (acceptance_probabilities[k] - target_swap_rate_);
+      }
+      temperature += exp(rho);
+      ladder[k + 1] = 1.0 / temperature;
+    }
+    ladder_ = ladder;
+  }
+
+  void ReplicaExchangeDriver::set_replica_powers() {
+    for (int k = 0; k < level_.size(); ++k) {
+      replicas_[level_[k]]->set_likelihood_power(ladder_[k]);
+    }
+  }
+
+}  // namespace BOOM
@@ -149,69 +149,81 @@ namespace BOOM{
       report_error(err.str());
   }
   //----------------------------------------------------------------------
-  namespace{
-    // Keep in mind that you might not be multiplying a state vector.
-    // You probably are, but you might be multiplying a random column in
-    // a variance matrix, etc.
-    template <class VEC>
-        Vector Multiply(const SparseKalmanMatrix *T,
-                     const SparseVector &Z,
-                     bool contains_end,
-                     double fraction_in_initial_period,
-                     const VEC &v) {
-
-      int state_dim = T->nrow();
-      if(v.size() != state_dim + 2 || Z.size() != state_dim){
-        report_multiplication_error(
-            T, Z, contains_end, fraction_in_initial_period, v);
-      }
-      ConstVectorView old_state(v.data(), state_dim, v.stride());
-      double old_weekly_observation(v[state_dim]);
-      double old_cumulator(v[state_dim+1]);
-
-      Vector ans(v.size());
-      VectorView new_state(ans, 0, state_dim);
-      double &new_weekly_observation(ans[state_dim]);
-      double &new_cumulator(ans[state_dim+1]);
-
-      new_state = (*T) * old_state;
-      new_weekly_observation = Z.dot(new_state);
-      if(contains_end){
-        new_cumulator = (1-fraction_in_initial_period)*old_weekly_observation;
-      } else {
-        new_cumulator = old_cumulator + old_weekly_observation;
-      }
-      return ans;
+  // Keep in mind that you might not be multiplying a state vector.
+  // You probably are, but you might be multiplying a random column in
+  // a variance matrix, etc.
+  void AccumulatorTransitionMatrix::multiply(
+      VectorView lhs, const ConstVectorView &rhs) const {
+    int state_dim = transition_matrix_->nrow();
+    if(rhs.size() != state_dim + 2 || lhs.size() != state_dim + 2
+       || observation_vector_.size() != state_dim){
+      report_multiplication_error(
+          transition_matrix_, observation_vector_, contains_end_,
+          fraction_in_initial_period_, rhs);
+    }
+    ConstVectorView old_state(rhs, 0, state_dim);
+    double old_weekly_observation(rhs[state_dim]);
+    double old_cumulator(rhs[state_dim+1]);
+
+    VectorView new_state(lhs, 0, state_dim);
+    transition_matrix_->multiply(new_state, old_state);
+    lhs[state_dim] = observation_vector_.dot(new_state);
+    if(contains_end_){
+      lhs[state_dim+1] =
+          (1-fraction_in_initial_period_) * old_weekly_observation;
+    } else {
+      lhs[state_dim+1] = old_cumulator + old_weekly_observation;
+    }
+  }
+  //----------------------------------------------------------------------
+  void AccumulatorTransitionMatrix::multiply_inplace(VectorView x) const {
+    int state_dim = transition_matrix_->nrow();
+    if(x.size() != state_dim + 2){
+      report_multiplication_error(
+          transition_matrix_, observation_vector_, contains_end_,
+          fraction_in_initial_period_, x);
+    }
+    double old_weekly_observation = x[state_dim];
+    double old_cumulator = x[state_dim+1];
+    VectorView state(x, 0, state_dim);
+    transition_matrix_->multiply_inplace(state);
+    x[state_dim] = observation_vector_.dot(state);
+    if(contains_end_){
+      x[state_dim+1] =
+          (1-fraction_in_initial_period_) * old_weekly_observation;
+    } else {
+      x[state_dim+1] = old_cumulator + old_weekly_observation;
     }
   }
   //----------------------------------------------------------------------
   Vector AccumulatorTransitionMatrix::operator *(const Vector &v)const{
-    return Multiply(transition_matrix_,
-                    observation_vector_,
-                    contains_end_,
-                    fraction_in_initial_period_,
-                    v);
+    Vector ans(v.size());
+    multiply(VectorView(ans), ConstVectorView(v));
+    return ans;
   }
   //----------------------------------------------------------------------
   Vector AccumulatorTransitionMatrix::operator *(const VectorView &v)const{
-    return Multiply(transition_matrix_,
-                    observation_vector_,
-                    contains_end_,
-                    fraction_in_initial_period_,
-                    v);
+    Vector ans(v.size());
+    multiply(VectorView(ans), ConstVectorView(v));
+    return ans;
   }
   //----------------------------------------------------------------------
   Vector AccumulatorTransitionMatrix::operator *(const ConstVectorView &v)const{
-    return Multiply(transition_matrix_,
-                    observation_vector_,
-                    contains_end_,
-                    fraction_in_initial_period_,
-                    v);
+    Vector ans(v.size());
+    multiply(VectorView(ans), v);
+    return ans;
   }
   //----------------------------------------------------------------------
   Vector AccumulatorTransitionMatrix::Tmult(const Vector &v)const{
+    Vector ans(v.size());
+    Tmult(VectorView(ans), ConstVectorView(v));
+    return ans;
+  }
+  //----------------------------------------------------------------------
+  void AccumulatorTransitionMatrix::Tmult(
+      VectorView lhs, const ConstVectorView &v) const {
     int state_dim = transition_matrix_->ncol();
-    if(v.size() != state_dim + 2){
+    if(v.size() != state_dim + 2 || lhs.size() != state_dim + 2){
       report_multiplication_error(
           transition_matrix_, observation_vector_, contains_end_,
           fraction_in_initial_period_, v);
@@ -219,15 +231,14 @@ namespace BOOM{
 
     double w = v[state_dim];
     double W = v[state_dim + 1];
-    Vector ans(v.size());
 
-    VectorView state_component(ans, 0, state_dim);
-    Vector arg = (observation_vector_.dense() * w) +
-        ConstVectorView(v, 0, state_dim);
-    state_component = transition_matrix_->Tmult(arg);
-    ans[state_dim] = (1 - fraction_in_initial_period_ * contains_end_) * W;
-    ans[state_dim+1] = (1 - contains_end_) * W;
-    return ans;
+    // The argument to the client transition matrix needs its own
+    // storage, because lhs and v may not overlap.
+    Vector arg = ConstVectorView(v, 0, state_dim);
+    observation_vector_.add_this_to(arg, w);
+    transition_matrix_->Tmult(VectorView(lhs, 0, state_dim), arg);
+    lhs[state_dim] = (1 - fraction_in_initial_period_ * contains_end_) * W;
+    lhs[state_dim+1] = (1 - contains_end_) * W;
   }
   //----------------------------------------------------------------------
 
@@ -373,6 +384,20 @@ namespace BOOM{
                         observation_variance_);
   }
 
+  void AccumulatorStateVarianceMatrix::multiply(
+      VectorView lhs, const ConstVectorView &rhs)const{
+    lhs = RQR_Multiply(rhs,
+                       *state_variance_matrix_,
+                       observation_vector_,
+                       observation_variance_);
+  }
+
+  // The matrix is symmetric, so Tmult is the same as multiply.
+  void AccumulatorStateVarianceMatrix::Tmult(
+      VectorView lhs, const ConstVectorView &rhs)const{
+    multiply(lhs, rhs);
+  }
+
   Matrix & AccumulatorStateVarianceMatrix::add_to(Matrix &m)const{
     int state_dim(state_variance_matrix_->nrow());
     if(m.nrow()!= state_dim+2){
@@ -558,19 +583,16 @@ namespace BOOM{
     state0[state_dimension() - 1] = 0;
   }
 
-  Vector ASSR::simulate_state_error(int t)const{
+  void ASSR::simulate_state_error(RNG &rng, VectorView eta, int t)const{
     int state_dim = state_dimension();
-    Vector ans(state_dim, 0);
-    VectorView client_state_error(ans, 0, state_dim - 2);
-    client_state_error = StateSpaceModelBase::simulate_state_error(t);
+    VectorView client_state_error(eta, 0, state_dim - 2);
+    StateSpaceModelBase::simulate_state_error(rng, client_state_error, t);
 
     // TODO(stevescott):  check this
-    ans[state_dim - 2] =
+    eta[state_dim - 2] =
         StateSpaceModelBase::observation_matrix(t).dot(client_state_error)
-        + rnorm(0, regression_->sigma());
-    ans.back() = 0;
-
-    return ans;
+        + rnorm_mt(rng, 0, regression_->sigma());
+    eta[state_dim - 1] = 0;
   }
 
   Vector ASSR::initial_state_mean()const{
@@ -0,0 +1,357 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/StateSpace/Filters/MultiSeriesKalmanFilter.hpp>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <cpputil/Constants.hpp>
+#include <cpputil/report_error.hpp>
+
+namespace BOOM {
+
+  namespace {
+    // y[s] += scale * x[s] for s = 0, ..., n - 1.
+    inline void axpy(double *y, const double *x, double scale, int n) {
+      for (int s = 0; s < n; ++s) {
+        y[s] += scale * x[s];
+      }
+    }
+  }  // namespace
+
+  MultiSeriesKalmanFilter::MultiSeriesKalmanFilter(
+      const std::vector<Ptr<StateSpaceModelBase>> &series_models)
+      : series_models_(series_models),
+        state_dimension_(0),
+        time_dimension_(0),
+        batch_size_(256),
+        store_final_state_variance_(true),
+        store_prediction_errors_(false)
+  {
+    if (series_models_.empty()) {
+      report_error("MultiSeriesKalmanFilter needs at least one series.");
+    }
+    state_dimension_ = series_models_[0]->state_dimension();
+    time_dimension_ = series_models_[0]->time_dimension();
+    for (int s = 1; s < series_models_.size(); ++s) {
+      if (series_models_[s]->state_dimension() != state_dimension_
+          || series_models_[s]->time_dimension() != time_dimension_) {
+        report_error("All the series in a MultiSeriesKalmanFilter must "
+                     "have the same state and time dimensions.");
+      }
+    }
+  }
+
+  void MultiSeriesKalmanFilter::set_number_of_threads(int n) {
+    pool_.set_number_of_threads(n <= 1 ? 0 : n);
+  }
+
+  void MultiSeriesKalmanFilter::set_batch_size(int batch_size) {
+    if (batch_size < 1) {
+      report_error("Batch size must be positive.");
+    }
+    batch_size_ = batch_size;
+  }
+
+  const SpdMatrix &MultiSeriesKalmanFilter::final_state_variance(
+      int series) const {
+    if (final_state_variance_.empty()) {
+      report_error("The final state variance was not stored.");
+    }
+    return final_state_variance_[series];
+  }
+
+  ConstVectorView MultiSeriesKalmanFilter::prediction_errors(
+      int series) const {
+    if (prediction_errors_.ncol() != number_of_series()) {
+      report_error("The prediction errors were not stored.");
+    }
+    return prediction_errors_.col(series);
+  }
+
+  ConstVectorView MultiSeriesKalmanFilter::forecast_variances(
+      int series) const {
+    if (forecast_variances_.ncol() != number_of_series()) {
+      report_error("The forecast variances were not stored.");
+    }
+    return forecast_variances_.col(series);
+  }
+
+  //----------------------------------------------------------------------
+  void MultiSeriesKalmanFilter::record_shared_structure() {
+    const StateSpaceModelBase &model(*series_models_[0]);
+    int m = state_dimension_;
+    transition_matrices_.clear();
+    transition_index_.assign(time_dimension_, 0);
+    observation_vectors_.clear();
+    observation_index_.assign(time_dimension_, 0);
+    state_variance_changes_.assign(time_dimension_, true);
+
+    Matrix previous_transition;
+    Vector previous_observation;
+    Matrix previous_variance;
+    // The times where series 0's T[t] or Z[t] changes, which are
+    // checked against the other series below.
+    std::vector<int> change_times;
+    for (int t = 0; t < time_dimension_; ++t) {
+      Matrix transition = model.state_transition_matrix(t)->dense();
+      if (t == 0 || !(transition == previous_transition)) {
+        SparseEntries entries;
+        for (int i = 0; i < m; ++i) {
+          for (int j = 0; j < m; ++j) {
+            if (transition(i, j) != 0.0) {
+              entries.row.push_back(i);
+              entries.col.push_back(j);
+              entries.value.push_back(transition(i, j));
+            }
+          }
+        }
+        transition_matrices_.push_back(entries);
+        previous_transition = transition;
+        change_times.push_back(t);
+      }
+      transition_index_[t] = transition_matrices_.size() - 1;
+
+      Vector observation = model.observation_matrix(t).dense();
+      if (t == 0 || !(observation == previous_observation)) {
+        SparseEntries entries;
+        for (int j = 0; j < m; ++j) {
+          if (observation[j] != 0.0) {
+            entries.row.push_back(j);
+            entries.value.push_back(observation[j]);
+          }
+        }
+        observation_vectors_.push_back(entries);
+        previous_observation = observation;
+        if (change_times.back() != t) change_times.push_back(t);
+      }
+      observation_index_[t] = observation_vectors_.size() - 1;
+
+      Matrix variance = model.state_variance_matrix(t)->dense();
+      state_variance_changes_[t] =
+          (t == 0 || !(variance == previous_variance));
+      previous_variance = variance;
+    }
+
+    // State models with parameterized transitions (e.g. ArStateModel,
+    // SemilocalLinearTrend, or DynamicRegressionStateModel) give each
+    // series its own T[t] or Z[t], which the batched recursion cannot
+    // handle.
+    for (int t : change_times) {
+      Matrix transition = model.state_transition_matrix(t)->dense();
+      Vector observation = model.observation_matrix(t).dense();
+      for (int s = 1; s < series_models_.size(); ++s) {
+        const StateSpaceModelBase &other(*series_models_[s]);
+        if (!(other.state_transition_matrix(t)->dense() == transition)
+            || !(other.observation_matrix(t).dense() == observation)) {
+          std::ostringstream err;
+          err << "Series " << s << " does not share the state transition "
+              << "matrix and observation vector of series 0 at time " << t
+              << ".  MultiSeriesKalmanFilter requires T[t] and Z[t] to "
+              << "be the same for all series, so state models with "
+              << "parameterized transitions are not supported.";
+          report_error(err.str());
+        }
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------
+  void MultiSeriesKalmanFilter::filter() {
+    record_shared_structure();
+    int nseries = number_of_series();
+    log_likelihood_.resize(nseries);
+    final_state_mean_.resize(state_dimension_, nseries);
+    if (store_final_state_variance_) {
+      final_state_variance_.assign(nseries, SpdMatrix(state_dimension_));
+    } else {
+      final_state_variance_.clear();
+    }
+    if (store_prediction_errors_) {
+      prediction_errors_.resize(time_dimension_, nseries);
+      forecast_variances_.resize(time_dimension_, nseries);
+    } else {
+      prediction_errors_.resize(0, 0);
+      forecast_variances_.resize(0, 0);
+    }
+
+    int nbatches = (nseries + batch_size_ - 1) / batch_size_;
+    pool_.run_jobs(nbatches, [this, nseries](int batch) {
+        int first = batch * batch_size_;
+        this->filter_batch(first, std::min(first + batch_size_, nseries));
+      });
+  }
+
+  //----------------------------------------------------------------------
+  // Element (i, j) of a state variance for series s is stored at
+  // P[(i * m + j) * n + s], where n is the number of series in the
+  // batch, and element i of a state vector is stored at a[i * n + s].
+  void MultiSeriesKalmanFilter::filter_batch(int first, int last) {
+    const int n = last - first;
+    const int m = state_dimension_;
+    const int mm = m * m;
+    std::vector<double> a(m * n), P(mm * n), RQR(mm * n);
+    std::vector<double> Ta(m * n), TP(mm * n), Pnew(mm * n);
+    std::vector<double> PZ(m * n), K(m * n);
+    std::vector<double> y(n), H(n), F(n), v(n), loglike(n, 0.0);
+    std::vector<char> missing(n);
+    Matrix workspace(m, m);
+
+    for (int s = 0; s < n; ++s) {
+      const StateSpaceModelBase &model(*series_models_[first + s]);
+      Vector a0 = model.initial_state_mean();
+      SpdMatrix P0 = model.initial_state_variance();
+      for (int i = 0; i < m; ++i) {
+        a[i * n + s] = a0[i];
+        for (int j = 0; j < m; ++j) {
+          P[(i * m + j) * n + s] = P0(i, j);
+        }
+      }
+    }
+
+    for (int t = 0; t < time_dimension_; ++t) {
+      const SparseEntries &T(transition_matrices_[transition_index_[t]]);
+      const SparseEntries &Z(observation_vectors_[observation_index_[t]]);
+      const int nz = Z.row.size();
+      const int nt = T.row.size();
+
+      for (int s = 0; s < n; ++s) {
+        const StateSpaceModelBase &model(*series_models_[first + s]);
+        missing[s] = model.is_missing_observation(t);
+        y[s] = missing[s] ? 0.0 : model.adjusted_observation(t);
+        H[s] = model.observation_variance(t);
+        if (state_variance_changes_[t]) {
+          workspace = 0.0;
+          model.state_variance_matrix(t)->add_to(workspace);
+          for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < m; ++j) {
+              RQR[(i * m + j) * n + s] = workspace(i, j);
+            }
+          }
+        }
+      }
+
+      // PZ = P * Z, F = Z' * P * Z + H, v = y - Z' * a.
+      std::fill(PZ.begin(), PZ.end(), 0.0);
+      for (int k = 0; k < nz; ++k) {
+        int j = Z.row[k];
+        for (int i = 0; i < m; ++i) {
+          axpy(&PZ[i * n], &P[(i * m + j) * n], Z.value[k], n);
+        }
+      }
+      for (int s = 0; s < n; ++s) {
+        F[s] = H[s];
+        v[s] = y[s];
+      }
+      for (int k = 0; k < nz; ++k) {
+        int j = Z.row[k];
+        axpy(F.data(), &PZ[j * n], Z.value[k], n);
+        axpy(v.data(), &a[j * n], -Z.value[k], n);
+      }
+
+      // K = T * P * Z / F, or zero if y is missing.
+      std::fill(K.begin(), K.end(), 0.0);
+      for (int k = 0; k < nt; ++k) {
+        axpy(&K[T.row[k] * n], &PZ[T.col[k] * n], T.value[k], n);
+      }
+      for (int s = 0; s < n; ++s) {
+        if (missing[s]) {
+          v[s] = 0.0;
+        } else {
+          if (!(F[s] > 0)) {
+            report_error("Found a non-positive forecast variance in "
+                         "MultiSeriesKalmanFilter.");
+          }
+          loglike[s] -= Constants::log_root_2pi
+              + 0.5 * (std::log(F[s]) + v[s] * v[s] / F[s]);
+        }
+      }
+      for (int i = 0; i < m; ++i) {
+        double *Ki = &K[i * n];
+        for (int s = 0; s < n; ++s) {
+          Ki[s] = missing[s] ? 0.0 : Ki[s] / F[s];
+        }
+      }
+
+      // a = T * a + K * v.
+      std::fill(Ta.begin(), Ta.end(), 0.0);
+      for (int k = 0; k < nt; ++k) {
+        axpy(&Ta[T.row[k] * n], &a[T.col[k] * n], T.value[k], n);
+      }
+      for (int i = 0; i < m; ++i) {
+        double *ai = &a[i * n];
+        const double *Tai = &Ta[i * n];
+        const double *Ki = &K[i * n];
+        for (int s = 0; s < n; ++s) {
+          ai[s] = Tai[s] + Ki[s] * v[s];
+        }
+      }
+
+      // P = T * P * T' - F * K * K' + RQR.  Row i of T * P is the sum
+      // over k of T(i, k) times row k of P, and rows are contiguous.
+      std::fill(TP.begin(), TP.end(), 0.0);
+      for (int k = 0; k < nt; ++k) {
+        axpy(&TP[T.row[k] * m * n], &P[T.col[k] * m * n], T.value[k],
+             m * n);
+      }
+      std::fill(Pnew.begin(), Pnew.end(), 0.0);
+      for (int k = 0; k < nt; ++k) {
+        int j = T.row[k];
+        int l = T.col[k];
+        for (int i = 0; i < m; ++i) {
+          axpy(&Pnew[(i * m + j) * n], &TP[(i * m + l) * n], T.value[k], n);
+        }
+      }
+      for (int i = 0; i < m; ++i) {
+        const double *Ki = &K[i * n];
+        for (int j = 0; j < m; ++j) {
+          const double *Kj = &K[j * n];
+          const double *rqr = &RQR[(i * m + j) * n];
+          double *Pij = &Pnew[(i * m + j) * n];
+          for (int s = 0; s < n; ++s) {
+            Pij[s] += rqr[s] - F[s] * Ki[s] * Kj[s];
+          }
+        }
+      }
+      P.swap(Pnew);
+
+      if (store_prediction_errors_) {
+        for (int s = 0; s < n; ++s) {
+          prediction_errors_(t, first + s) = v[s];
+          forecast_variances_(t, first + s) = missing[s] ? 0.0 : F[s];
+        }
+      }
+    }
+
+    for (int s = 0; s < n; ++s) {
+      log_likelihood_[first + s] = loglike[s];
+      for (int i = 0; i < m; ++i) {
+        final_state_mean_(i, first + s) = a[i * n + s];
+      }
+      if (store_final_state_variance_) {
+        SpdMatrix &variance(final_state_variance_[first + s]);
+        for (int i = 0; i < m; ++i) {
+          for (int j = 0; j < m; ++j) {
+            variance(i, j) = P[(i * m + j) * n + s];
+          }
+        }
+      }
+    }
+  }
+
+}  // namespace BOOM
@@ -22,6 +22,7 @@
 #include <Models/StateSpace/Filters/SparseMatrix.hpp>
 #include <distributions.hpp>
 #include <cpputil/report_error.hpp>
+#include <algorithm>
 
 namespace BOOM{
   double sparse_scalar_kalman_update(
@@ -37,8 +38,11 @@ namespace BOOM{
       const SparseKalmanMatrix & T,     // State transition matrix
       const SparseKalmanMatrix & RQR) { // State variance matrix
 
-    Vector PZ = P*Z;
-    F = Z.dot(PZ) + H;
+    // The Kalman gain is K = T * P * Z / F.  It is built up in place
+    // so that the update does not allocate once K has been sized.
+    if (K.size() != a.size()) K.resize(a.size());
+    multiply(VectorView(K), P, Z);     // K = P * Z
+    F = Z.dot(K) + H;
     if (F <= 0) {
       std::ostringstream err;
       err << "Found a zero forecast variance:" << endl
@@ -47,28 +51,29 @@ namespace BOOM{
           << "P = " << endl << P << endl
           << "y = " << y << endl
           << "H = " << H << endl
-          << "ZPZ = " << Z.dot(PZ) << endl
+          << "ZPZ = " << Z.dot(K) << endl
           << "Z = " << Z.dense() << endl;
       report_error(err.str());
     }
-    Vector TPZ = T * PZ;
 
     double loglike=0;
     if (!missing) {
-      K = TPZ/F;
+      T.multiply_inplace(VectorView(K));  // K = T * P * Z
+      K /= F;
       double mu = Z.dot(a);
       v = y-mu;
       loglike = dnorm(y, mu, sqrt(F), true);
     }else{
-      K = a.zero();
+      K = 0.0;
       v = 0;
     }
 
-    a = T * a;                         // Sparse multiplication
+    T.multiply_inplace(VectorView(a)); // Sparse multiplication
     if (!missing) a.axpy(K, v);         // a += K * v
     T.sandwich_inplace(P);             // P = T P T.transpose()
     if (!missing) {                      // K is zero if missing, so skip this
-      P.Matrix::add_outer(TPZ, K, -1); // P-= T*P*Z*K.transpose();
+      // P -= T*P*Z*K.transpose(), and T*P*Z = K * F.
+      P.Matrix::add_outer(K, K, -F);
     }
     RQR.add_to(P);                     // P += RQR
 
@@ -98,7 +103,16 @@ namespace BOOM{
       const Vector &kalman_gain_K,
       const SparseVector &observation_matrix_Z,
       double forecast_variance,
-      double forecast_error) {
+      double forecast_error,
+      VectorView workspace) {
+    int state_dim = scaled_residual_r.size();
+    if (workspace.size() < 2 * state_dim) {
+      report_error("The workspace for "
+                   "sparse_scalar_kalman_disturbance_smoother_update "
+                   "must have twice as many elements as the state.");
+    }
+    VectorView work(workspace, 0, state_dim);
+    VectorView TprimeNK(workspace, state_dim, state_dim);
 
     // The recursion is given by the following system of equations:
     // u[t]    = (v[t] / F[t]) - K[t] * r[t]
@@ -110,31 +124,29 @@ namespace BOOM{
     double u = forecast_error / forecast_variance
         - kalman_gain_K.dot(scaled_residual_r);
     // r[t-1] = T'r + Z*u
-    Vector previous_r = transition_matrix_T.Tmult(scaled_residual_r);
-    observation_matrix_Z.add_this_to(previous_r, u);
-    scaled_residual_r = previous_r;
+    transition_matrix_T.Tmult(work, scaled_residual_r);
+    observation_matrix_Z.add_this_to(work, u);
+    std::copy(work.begin(), work.end(), scaled_residual_r.begin());
 
     // D = (1/F) + K'NK
     double D = (1.0 / forecast_variance)
         + scaled_residual_variance_N.Mdist(kalman_gain_K);
 
-    SpdMatrix previousN = scaled_residual_variance_N;
-    transition_matrix_T.sandwich_inplace_transpose(previousN);
+    // T'NK must be computed before N is overwritten.  N is symmetric,
+    // so element i of NK is the dot product of column i with K.
+    for (int i = 0; i < state_dim; ++i) {
+      work[i] = scaled_residual_variance_N.col(i).dot(kalman_gain_K);
+    }
+    transition_matrix_T.Tmult(TprimeNK, work);
+
+    // N is updated in place, rather than in a copy.
+    SpdMatrix &previousN(scaled_residual_variance_N);
+    transition_matrix_T.sandwich_inplace_transpose(previousN, work);
     // N[t-1] = T'NT
     observation_matrix_Z.add_outer_product(previousN, D);
-    // N[t-1] = ZDZ' + T'NT
-
-    Vector TprimeNK = transition_matrix_T.Tmult(
-        scaled_residual_variance_N * kalman_gain_K);
-    Matrix TprimeNKZ = observation_matrix_Z.outer_product_transpose(TprimeNK);
-    // Next, previousN = previousN - TprimeNKZ -
-    // TprimeNKZ.transpose().  Subtracting the transpose column by
-    // column should maximize the use of blas routines.
-    previousN -= TprimeNKZ;
-    for (int i = 0; i < ncol(previousN); ++i) {
-      previousN.col(i) -= TprimeNKZ.row(i);
-    }
-    scaled_residual_variance_N = previousN;
+    // N[t-1] = ZDZ' + T'NT - T'NKZ' - ZK'N'T
+    observation_matrix_Z.add_symmetric_outer_product(
+        previousN, TprimeNK, -1.0);
   }
 
 }
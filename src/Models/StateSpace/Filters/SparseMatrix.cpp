@@ -170,6 +170,20 @@ namespace BOOM{
     *now = total;
   }
 
+  void SSSM::matrix_transpose_premultiply_inplace(SubMatrix m) const {
+    conforms_to_cols(m.ncol());
+    // Column 0 of m * this->transpose() is the negative sum of the
+    // columns of m.  Column i > 0 is column i-1 of m.
+    int n = m.ncol();
+    Vector total = m.col(n - 1);
+    total *= -1;
+    for (int i = n - 1; i > 0; --i) {
+      total -= m.col(i - 1);
+      m.col(i) = m.col(i - 1);
+    }
+    m.col(0) = total;
+  }
+
   void SSSM::add_to(SubMatrix block) const {
     check_can_add(block);
     block.row(0) -= 1;
@@ -258,11 +272,33 @@ namespace BOOM{
     return ans;
   }
   //======================================================================
+  void SparseKalmanMatrix::multiply(VectorView lhs,
+                                    const ConstVectorView &rhs) const {
+    lhs = (*this) * rhs;
+  }
+
+  void SparseKalmanMatrix::Tmult(VectorView lhs,
+                                 const ConstVectorView &rhs) const {
+    lhs = this->Tmult(Vector(rhs));
+  }
+
+  void SparseKalmanMatrix::multiply_inplace(VectorView x) const {
+    Vector ans = (*this) * x;
+    x = ans;
+  }
+
   void SparseKalmanMatrix::sandwich_inplace(SpdMatrix &P) const {
+    if (nrow() != ncol() || P.nrow() != ncol()) {
+      report_error("Incompatible sizes in "
+                   "SparseKalmanMatrix::sandwich_inplace.");
+    }
+    Vector workspace(nrow());
+    VectorView work(workspace);
     // First replace P with *this * P, which corresponds to *this
     // multiplying each column of P.
     for (int i = 0; i < P.ncol(); ++i) {
-      P.col(i) = (*this)*P.col(i);
+      multiply(work, P.col(i));
+      P.col(i) = work;
     }
     // Next, post-multiply P by this->transpose.  A * B is the same
     // thing as taking each row of A and transpose-multiplying it by
@@ -271,7 +307,8 @@ namespace BOOM{
     // 'transpose-multiply' operation is really just a regular
     // multiplication.
     for (int i = 0; i < P.nrow(); ++i) {
-      P.row(i) = (*this) * P.row(i);
+      multiply(work, P.row(i));
+      P.row(i) = work;
     }
   }
 
@@ -283,15 +320,29 @@ namespace BOOM{
 
   // Replaces P with this.transpose * P * this
   void SparseKalmanMatrix::sandwich_inplace_transpose(SpdMatrix &P) const {
+    Vector workspace(ncol());
+    sandwich_inplace_transpose(P, VectorView(workspace));
+  }
+
+  void SparseKalmanMatrix::sandwich_inplace_transpose(
+      SpdMatrix &P, VectorView workspace) const {
+    if (nrow() != ncol() || P.nrow() != nrow()
+        || workspace.size() < ncol()) {
+      report_error("Incompatible sizes in "
+                   "SparseKalmanMatrix::sandwich_inplace_transpose.");
+    }
+    VectorView work(workspace, 0, ncol());
     // First replace P with this->Tmult(P), which just
     // transpose-multiplies each column of P by *this.
     for (int i = 0; i < P.ncol(); ++i) {
-      P.col(i) = this->Tmult(P.col(i));
+      Tmult(work, P.col(i));
+      P.col(i) = work;
     }
     // Next take the resulting matrix and post-multiply it by 'this',
     // which is just the transpose of this->transpose * that.
     for (int j = 0; j < P.nrow(); ++j) {
-      P.row(j) = this->Tmult(P.row(j));
+      Tmult(work, P.row(j));
+      P.row(j) = work;
     }
   }
 
@@ -302,10 +353,10 @@ namespace BOOM{
     SpdMatrix ans(nrow());
     Matrix tmp(nrow(), ncol());
     for (int i = 0; i < ncol(); ++i) {
-      tmp.col(i) = (*this) * P.col(i);
+      multiply(tmp.col(i), P.col(i));
     }
     for (int i = 0; i < nrow(); ++i) {
-      ans.row(i) = (*this) * tmp.row(i);
+      multiply(ans.row(i), tmp.row(i));
     }
     return ans;
   }
@@ -314,10 +365,10 @@ namespace BOOM{
     SpdMatrix ans(ncol());
     Matrix tmp(ncol(), nrow());
     for (int i = 0; i < nrow(); ++i) {
-      tmp.col(i) = this->Tmult(P.col(i));
+      Tmult(tmp.col(i), P.col(i));
     }
     for (int i = 0; i < ncol(); ++i) {
-      ans.row(i) = this->Tmult(tmp.row(i));
+      Tmult(ans.row(i), tmp.row(i));
     }
     return ans;
   }
@@ -374,58 +425,87 @@ namespace BOOM{
 
   // TODO(stevescott): add a unit test for the case where diagonal
   // blocks are not square.
-  Vector block_multiply(const ConstVectorView &v, int nrow, int ncol,
-                     const std::vector<Ptr<SparseMatrixBlock> > &blocks_) {
-    if (v.size() != ncol) {
+  void BlockDiagonalMatrix::multiply(VectorView lhs,
+                                     const ConstVectorView &rhs) const {
+    if (lhs.size() != nrow() || rhs.size() != ncol()) {
       report_error(
           "incompatible vector in "
-          "BlockDiagonalMatrix::operator*");
+          "BlockDiagonalMatrix::multiply");
     }
-    Vector ans(nrow);
-
+    // Some blocks (e.g. FirstElementSingleColumnMatrix) only write the
+    // nonzero elements of their output.
+    lhs = 0.0;
     int lhs_pos = 0;
     int rhs_pos = 0;
     for (int b = 0; b < blocks_.size(); ++b) {
       int nr = blocks_[b]->nrow();
-      VectorView lhs(ans, lhs_pos, nr);
+      int nc = blocks_[b]->ncol();
+      blocks_[b]->multiply(VectorView(lhs, lhs_pos, nr),
+                           ConstVectorView(rhs, rhs_pos, nc));
       lhs_pos += nr;
+      rhs_pos += nc;
+    }
+  }
 
+  void BlockDiagonalMatrix::Tmult(VectorView lhs,
+                                  const ConstVectorView &rhs) const {
+    if (lhs.size() != ncol() || rhs.size() != nrow()) {
+      report_error(
+          "incompatible vector in "
+          "BlockDiagonalMatrix::Tmult");
+    }
+    lhs = 0.0;
+    int lhs_pos = 0;
+    int rhs_pos = 0;
+    for (int b = 0; b < blocks_.size(); ++b) {
+      int nr = blocks_[b]->nrow();
       int nc = blocks_[b]->ncol();
-      ConstVectorView rhs(v, rhs_pos, nc);
-      rhs_pos += nc;
-      blocks_[b]->multiply(lhs, rhs);
+      blocks_[b]->Tmult(VectorView(lhs, lhs_pos, nc),
+                        ConstVectorView(rhs, rhs_pos, nr));
+      lhs_pos += nc;
+      rhs_pos += nr;
+    }
+  }
+
+  void BlockDiagonalMatrix::multiply_inplace(VectorView x) const {
+    if (x.size() != ncol()) {
+      report_error(
+          "incompatible vector in "
+          "BlockDiagonalMatrix::multiply_inplace");
+    }
+    int pos = 0;
+    for (int b = 0; b < blocks_.size(); ++b) {
+      int dim = blocks_[b]->ncol();
+      if (blocks_[b]->nrow() != dim) {
+        report_error("BlockDiagonalMatrix::multiply_inplace requires "
+                     "square blocks.");
+      }
+      blocks_[b]->multiply_inplace(VectorView(x, pos, dim));
+      pos += dim;
     }
-    return ans;
   }
 
   Vector BlockDiagonalMatrix::operator*(const Vector &v) const {
-    return block_multiply(ConstVectorView(v), nrow(), ncol(), blocks_);
+    Vector ans(nrow());
+    multiply(VectorView(ans), ConstVectorView(v));
+    return ans;
   }
 
   Vector BlockDiagonalMatrix::operator*(const VectorView &v) const {
-    return block_multiply(ConstVectorView(v), nrow(), ncol(), blocks_);
+    Vector ans(nrow());
+    multiply(VectorView(ans), ConstVectorView(v));
+    return ans;
   }
+
   Vector BlockDiagonalMatrix::operator*(const ConstVectorView &v) const {
-    return block_multiply(v, nrow(), ncol(), blocks_);
+    Vector ans(nrow());
+    multiply(VectorView(ans), v);
+    return ans;
   }
 
   Vector BlockDiagonalMatrix::Tmult(const Vector &x) const {
-    if (x.size() != nrow()) {
-      report_error(
-          "incompatible vector in "
-          "BlockDiagonalMatrix::Tmult");
-    }
-    int lhs_pos = 0;
-    int rhs_pos = 0;
-    Vector ans(ncol(), 0);
-
-    for (int b = 0; b < blocks_.size(); ++b) {
-      VectorView lhs(ans, lhs_pos, blocks_[b]->ncol());
-      lhs_pos += blocks_[b]->ncol();
-      ConstVectorView rhs(x, rhs_pos, blocks_[b]->nrow());
-      rhs_pos += blocks_[b]->nrow();
-      blocks_[b]->Tmult(lhs, rhs);
-    }
+    Vector ans(ncol());
+    Tmult(VectorView(ans), ConstVectorView(x));
     return ans;
   }
 
@@ -200,6 +200,24 @@ namespace BOOM{
     }
   }
 
+  void SparseVector::add_symmetric_outer_product(
+      SpdMatrix &m, const ConstVectorView &x, double scale) const {
+    int n = x.size();
+    if (m.nrow() != size_ || n != size_) {
+      report_error("Wrong sizes in "
+                   "SparseVector::add_symmetric_outer_product.");
+    }
+    for (const auto &el : elements_) {
+      int j = el.first;
+      double coefficient = el.second * scale;
+      // Column j gets x * this[j], and row j gets this[j] * x'.
+      for (int i = 0; i < n; ++i) {
+        m(i, j) += coefficient * x[i];
+        m(j, i) += coefficient * x[i];
+      }
+    }
+  }
+
   //======================================================================
 
   Vector operator*(const SpdMatrix &P, const SparseVector &z){
@@ -221,6 +239,19 @@ namespace BOOM{
     return ans;
   }
 
+  void multiply(VectorView ans, const SpdMatrix &P, const SparseVector &z){
+    if(ans.size() != P.nrow() || z.size() != P.ncol()){
+      report_error("Incompatible sizes in multiply(VectorView, SpdMatrix, "
+                   "SparseVector).");
+    }
+    // P * z is a linear combination of the columns of P
+    // corresponding to the nonzero elements of z.
+    ans = 0.0;
+    for(const auto &el : z.elements_){
+      ans.axpy(P.col(el.first), el.second);
+    }
+  }
+
   ostream & operator<<(ostream &out, const SparseVector &z){
     int n = z.size();
     if(n == 0) return out;
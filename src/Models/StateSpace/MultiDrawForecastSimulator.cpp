@@ -0,0 +1,143 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/StateSpace/MultiDrawForecastSimulator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <cpputil/report_error.hpp>
+#include <distributions.hpp>
+
+namespace BOOM {
+  namespace StateSpace {
+
+    namespace {
+      typedef MultiDrawForecastSimulator MDFS;
+    }  // namespace
+
+    MDFS::MultiDrawForecastSimulator(const StateSpaceModelBase *model,
+                                     int number_of_threads,
+                                     RNG &seeding_rng)
+        : model_(model),
+          seeding_rng_(&seeding_rng)
+    {
+      set_number_of_threads(number_of_threads);
+    }
+
+    void MDFS::set_number_of_threads(int n) {
+      pool_.set_number_of_threads(n <= 1 ? 0 : n);
+    }
+
+    Matrix MDFS::simulate_forecasts(int horizon,
+                                    const Matrix &parameter_draws,
+                                    const Matrix &final_states) {
+      int ndraws = parameter_draws.nrow();
+      if (final_states.nrow() != ndraws) {
+        report_error("parameter_draws and final_states must have the same "
+                     "number of rows.");
+      }
+      if (final_states.ncol() != model_->state_dimension()) {
+        report_error("The number of columns in final_states does not match "
+                     "the state dimension of the model.");
+      }
+      Matrix forecasts(ndraws, horizon);
+      if (ndraws == 0) return forecasts;
+
+      // Clones and random number generators are created in this thread,
+      // so the result depends only on the seeding RNG and the number of
+      // threads.
+      int nchunks = std::min<int>(std::max<int>(1, pool_.number_of_threads()),
+                                  ndraws);
+      std::vector<Ptr<StateSpaceModelBase>> models;
+      std::vector<RNG> rngs;
+      for (int i = 0; i < nchunks; ++i) {
+        models.push_back(model_->clone());
+        models.back()->set_state_model_behavior(StateModel::MARGINAL);
+        rngs.push_back(RNG(seed_rng(*seeding_rng_)));
+      }
+
+      pool_.run_jobs(nchunks, [&](int i) {
+        int first = (i * ndraws) / nchunks;
+        int last = ((i + 1) * ndraws) / nchunks;
+        this->simulate_draws(*models[i], rngs[i], horizon, parameter_draws,
+                             final_states, first, last, forecasts);
+      });
+      return forecasts;
+    }
+
+    void MDFS::simulate_draws(StateSpaceModelBase &model,
+                              RNG &rng,
+                              int horizon,
+                              const Matrix &parameter_draws,
+                              const Matrix &final_states,
+                              int first,
+                              int last,
+                              Matrix &forecasts) const {
+      int t0 = model.time_dimension();
+      int m = model.state_dimension();
+      Vector state(m), next(m), eta(m);
+      Vector parameters(parameter_draws.ncol());
+      for (int draw = first; draw < last; ++draw) {
+        parameters = parameter_draws.row(draw);
+        model.unvectorize_params(parameters);
+        Vector offset;
+        if (mean_offset_) {
+          offset = mean_offset_(model, horizon);
+        }
+        state = final_states.row(draw);
+        for (int t = 0; t < horizon; ++t) {
+          int time = t + t0;
+          model.state_transition_matrix(time - 1)->multiply(
+              VectorView(next), ConstVectorView(state));
+          model.simulate_state_error(rng, VectorView(eta), time - 1);
+          next += eta;
+          state.swap(next);
+          double mean = model.observation_matrix(time).dot(state);
+          if (mean_offset_) mean += offset[t];
+          forecasts(draw, t) = rnorm_mt(
+              rng, mean, sqrt(model.observation_variance(time)));
+        }
+      }
+    }
+
+    Matrix forecast_quantiles(const Matrix &draws, const Vector &probs) {
+      int ndraws = draws.nrow();
+      if (ndraws == 0) {
+        report_error("At least one draw is needed to compute quantiles.");
+      }
+      Matrix ans(probs.size(), draws.ncol());
+      Vector sorted(ndraws);
+      for (int j = 0; j < draws.ncol(); ++j) {
+        sorted = draws.col(j);
+        std::sort(sorted.begin(), sorted.end());
+        for (int i = 0; i < probs.size(); ++i) {
+          if (probs[i] < 0 || probs[i] > 1) {
+            report_error("Quantile probabilities must be in [0, 1].");
+          }
+          double position = probs[i] * (ndraws - 1);
+          int lo = std::floor(position);
+          int hi = std::min(lo + 1, ndraws - 1);
+          double weight = position - lo;
+          ans(i, j) = (1 - weight) * sorted[lo] + weight * sorted[hi];
+        }
+      }
+      return ans;
+    }
+
+  }  // namespace StateSpace
+}  // namespace BOOM
@@ -0,0 +1,100 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/StateSpace/ParallelLogLikelihoodEvaluator.hpp>
+
+namespace BOOM {
+  namespace StateSpaceUtils {
+
+    namespace {
+      typedef ParallelLogLikelihoodEvaluator PLLE;
+    }  // namespace
+
+    PLLE::ParallelLogLikelihoodEvaluator(const StateSpaceModelBase *model,
+                                         int number_of_threads)
+        : model_(model)
+    {
+      set_number_of_threads(number_of_threads);
+    }
+
+    void PLLE::set_number_of_threads(int n) {
+      pool_.set_number_of_threads(n <= 1 ? 0 : n);
+    }
+
+    Ptr<StateSpaceModelBase> PLLE::checkout_model() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (idle_models_.empty()) {
+        return model_->clone();
+      }
+      Ptr<StateSpaceModelBase> ans = idle_models_.back();
+      idle_models_.pop_back();
+      return ans;
+    }
+
+    void PLLE::return_model(const Ptr<StateSpaceModelBase> &model) const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      idle_models_.push_back(model);
+    }
+
+    PLLE::ModelCheckout::ModelCheckout(const PLLE *owner)
+        : owner_(owner),
+          model_(owner->checkout_model())
+    {}
+
+    PLLE::ModelCheckout::~ModelCheckout() {
+      owner_->return_model(model_);
+    }
+
+    double PLLE::evaluate_log_likelihood(const Vector &parameters) const {
+      ModelCheckout model(this);
+      model->unvectorize_params(parameters);
+      return model->log_likelihood();
+    }
+
+    double PLLE::evaluate_log_likelihood_derivatives(
+        const Vector &parameters, Vector &gradient) const {
+      ModelCheckout model(this);
+      model->unvectorize_params(parameters);
+      gradient.resize(parameters.size());
+      return model->log_likelihood_derivatives(VectorView(gradient));
+    }
+
+    Vector PLLE::evaluate_log_likelihood(
+        const std::vector<Vector> &parameters) const {
+      Vector ans(parameters.size());
+      pool_.run_jobs(parameters.size(), [this, &ans, &parameters](int i) {
+          ans[i] = this->evaluate_log_likelihood(parameters[i]);
+        });
+      return ans;
+    }
+
+    Vector PLLE::evaluate_log_likelihood_derivatives(
+        const std::vector<Vector> &parameters,
+        std::vector<Vector> &gradients) const {
+      Vector ans(parameters.size());
+      gradients.resize(parameters.size());
+      auto evaluate = [this, &ans, &parameters, &gradients](int i) {
+        ans[i] = this->evaluate_log_likelihood_derivatives(
+            parameters[i], gradients[i]);
+      };
+      pool_.run_jobs(parameters.size(), evaluate);
+      return ans;
+    }
+
+  }  // namespace StateSpaceUtils
+}  // namespace BOOM
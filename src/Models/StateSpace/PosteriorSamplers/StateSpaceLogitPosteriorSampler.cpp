@@ -54,31 +54,51 @@ namespace BOOM {
   {
     model_->register_data_observer(new StateSpace::LogitSufstatManager(this));
     observation_model_sampler_->fix_latent_data(true);
+    set_number_of_workers(1);
+    reassign_data_each_time(true);
   }
 
   void SSLPS::impute_nonstate_latent_data() {
-    const std::vector<Ptr<AugmentedData> > &data(model_->dat());
-    for (int t = 0; t < data.size(); ++t) {
-      Ptr<AugmentedData> dp = data[t];
-      double state_contribution = model_->observation_matrix(t).dot(
-          model_->state(t));
-      for (int j = 0; j < dp->sample_size(); ++j) {
-        const BinomialRegressionData &observation(dp->binomial_data(j));
-        double precision_weighted_sum = 0;
-        double total_precision = 0;
-        double regression_contribution =
-            model_->observation_model()->predict(observation.x());
-        std::tie(precision_weighted_sum, total_precision) =
-            data_imputer_.impute(rng(),
-                                 observation.n(),
-                                 observation.y(),
-                                 state_contribution + regression_contribution);
-        dp->set_latent_data(precision_weighted_sum / total_precision,
-                            total_precision,
-                            j);
-      }
-      dp->set_state_model_offset(state_contribution);
+    state_means_ = StateSpace::state_means(*model_);
+    impute_latent_data();
+  }
+
+  Ptr<StateSpace::TimeSeriesImputeWorker> SSLPS::create_worker(
+      std::mutex &m) {
+    return new StateSpace::TimeSeriesImputeWorker(
+        [this](int t, RNG &rng) {this->impute_latent_data_at_time(t, rng);},
+        m, nullptr, rng());
+  }
+
+  void SSLPS::assign_data_to_workers() {
+    StateSpace::assign_time_points_to_workers(model_->dat(), workers());
+  }
+
+  void SSLPS::impute_latent_data_at_time(int t, RNG &rng) {
+    Ptr<AugmentedData> dp = model_->dat()[t];
+    double state_contribution = state_means_[t];
+    int sample_size = dp->sample_size();
+    Vector trials(sample_size);
+    Vector successes(sample_size);
+    Vector log_odds(sample_size);
+    for (int j = 0; j < sample_size; ++j) {
+      const BinomialRegressionData &observation(dp->binomial_data(j));
+      trials[j] = observation.n();
+      successes[j] = observation.y();
+      log_odds[j] = state_contribution
+          + model_->observation_model()->predict(observation.x());
+    }
+    Vector precision_weighted_sums(sample_size);
+    Vector total_precisions(sample_size);
+    data_imputer_.impute_batch(rng, trials, successes, log_odds,
+                               VectorView(precision_weighted_sums),
+                               VectorView(total_precisions));
+    for (int j = 0; j < sample_size; ++j) {
+      dp->set_latent_data(precision_weighted_sums[j] / total_precisions[j],
+                          total_precisions[j],
+                          j);
     }
+    dp->set_state_model_offset(state_contribution);
   }
 
   void SSLPS::clear_complete_data_sufficient_statistics() {
@@ -53,62 +53,85 @@ namespace BOOM {
       RNG &seeding_rng)
       : StateSpacePosteriorSampler(model, seeding_rng),
         model_(model),
-        observation_model_sampler_(observation_model_sampler)
+        observation_model_sampler_(observation_model_sampler),
+        mixture_table_is_initialized_(false)
   {
     model_->register_data_observer(
         new StateSpace::PoissonSufstatManager(this));
     observation_model_sampler_->fix_latent_data(true);
+    set_number_of_workers(1);
+    reassign_data_each_time(true);
   }
 
   void SSPPS::impute_nonstate_latent_data() {
-    const std::vector<Ptr<AugmentedData> > &data(model_->dat());
-    for (int t = 0; t < data.size(); ++t) {
-      Ptr<AugmentedData> dp = data[t];
-      if (dp->missing()) {
-        continue;
+    state_means_ = StateSpace::state_means(*model_);
+    if (mixture_table_is_initialized_) {
+      impute_latent_data();
+    } else {
+      assign_data_to_workers();
+      for (auto &worker : workers()) {
+        worker->impute_latent_data();
       }
-      double state_contribution =
-          model_->observation_matrix(t).dot(model_->state(t));
-      for (int j = 0; j < dp->sample_size(); ++j) {
-        const PoissonRegressionData &observation(
-            dp->poisson_data(j));
-        double regression_contribution =
-            model_->observation_model()->predict(observation.x());
-
-        double internal_neglog_final_event_time = 0;
-        double internal_mixture_mean = 0;
-        double internal_mixture_precision = 0;
-        double neglog_final_interarrival_time = 0;
-        double external_mixture_mean = 0;
-        double external_mixture_precision = 0;
-        data_imputer_.impute(
-            rng(),
-            observation.y(),
-            observation.exposure(),
-            state_contribution + regression_contribution,
-            &internal_neglog_final_event_time,
-            &internal_mixture_mean,
-            &internal_mixture_precision,
-            &neglog_final_interarrival_time,
-            &external_mixture_mean,
-            &external_mixture_precision);
-
-        double total_precision = external_mixture_precision;
-        double precision_weighted_sum =
-            neglog_final_interarrival_time - external_mixture_mean;
-        precision_weighted_sum *= external_mixture_precision;
-        if (observation.y() > 0) {
-          precision_weighted_sum +=
-              (internal_neglog_final_event_time - internal_mixture_mean)
-              * internal_mixture_precision;
-          total_precision += internal_mixture_precision;
-        }
-        dp->set_latent_data(precision_weighted_sum / total_precision,
-                            total_precision,
-                            j);
+      mixture_table_is_initialized_ = true;
+    }
+  }
+
+  Ptr<StateSpace::TimeSeriesImputeWorker> SSPPS::create_worker(
+      std::mutex &m) {
+    return new StateSpace::TimeSeriesImputeWorker(
+        [this](int t, RNG &rng) {this->impute_latent_data_at_time(t, rng);},
+        m, nullptr, rng());
+  }
+
+  void SSPPS::assign_data_to_workers() {
+    StateSpace::assign_time_points_to_workers(model_->dat(), workers());
+  }
+
+  void SSPPS::impute_latent_data_at_time(int t, RNG &rng) {
+    Ptr<AugmentedData> dp = model_->dat()[t];
+    if (dp->missing()) {
+      return;
+    }
+    double state_contribution = state_means_[t];
+    for (int j = 0; j < dp->sample_size(); ++j) {
+      const PoissonRegressionData &observation(
+          dp->poisson_data(j));
+      double regression_contribution =
+          model_->observation_model()->predict(observation.x());
+
+      double internal_neglog_final_event_time = 0;
+      double internal_mixture_mean = 0;
+      double internal_mixture_precision = 0;
+      double neglog_final_interarrival_time = 0;
+      double external_mixture_mean = 0;
+      double external_mixture_precision = 0;
+      data_imputer_.impute(
+          rng,
+          observation.y(),
+          observation.exposure(),
+          state_contribution + regression_contribution,
+          &internal_neglog_final_event_time,
+          &internal_mixture_mean,
+          &internal_mixture_precision,
+          &neglog_final_interarrival_time,
+          &external_mixture_mean,
+          &external_mixture_precision);
+
+      double total_precision = external_mixture_precision;
+      double precision_weighted_sum =
+          neglog_final_interarrival_time - external_mixture_mean;
+      precision_weighted_sum *= external_mixture_precision;
+      if (observation.y() > 0) {
+        precision_weighted_sum +=
+            (internal_neglog_final_event_time - internal_mixture_mean)
+            * internal_mixture_precision;
+        total_precision += internal_mixture_precision;
       }
-      dp->set_state_model_offset(state_contribution);
+      dp->set_latent_data(precision_weighted_sum / total_precision,
+                          total_precision,
+                          j);
     }
+    dp->set_state_model_offset(state_contribution);
   }
 
   void SSPPS::clear_complete_data_sufficient_statistics() {
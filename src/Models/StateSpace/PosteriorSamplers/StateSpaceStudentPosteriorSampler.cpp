@@ -53,25 +53,39 @@ namespace BOOM {
     model_->register_data_observer(
         new StateSpace::StudentSufstatManager(this));
     observation_model_sampler_->fix_latent_data(true);
+    set_number_of_workers(1);
+    reassign_data_each_time(true);
   }
 
   void SSSPS::impute_nonstate_latent_data() {
-    const std::vector<Ptr<AugmentedData> > &data(model_->dat());
-    for (int t = 0; t < data.size(); ++t) {
-      Ptr<AugmentedData> dp = data[t];
-      double state_contribution = model_->observation_matrix(t).dot(
-          model_->state(t));
-      for (int j = 0; j < dp->sample_size(); ++j) {
-        const RegressionData &observation(dp->regression_data(j));
-        double regression_contribution =
-            model_->observation_model()->predict(observation.x());
-        double weight = data_imputer_.impute(
-            rng(),
-            observation.y() - regression_contribution - state_contribution,
-            model_->observation_model()->sigma(),
-            model_->observation_model()->nu());
-        dp->set_weight(weight, j);
-      }
+    state_means_ = StateSpace::state_means(*model_);
+    impute_latent_data();
+  }
+
+  Ptr<StateSpace::TimeSeriesImputeWorker> SSSPS::create_worker(
+      std::mutex &m) {
+    return new StateSpace::TimeSeriesImputeWorker(
+        [this](int t, RNG &rng) {this->impute_latent_data_at_time(t, rng);},
+        m, nullptr, rng());
+  }
+
+  void SSSPS::assign_data_to_workers() {
+    StateSpace::assign_time_points_to_workers(model_->dat(), workers());
+  }
+
+  void SSSPS::impute_latent_data_at_time(int t, RNG &rng) {
+    Ptr<AugmentedData> dp = model_->dat()[t];
+    double state_contribution = state_means_[t];
+    for (int j = 0; j < dp->sample_size(); ++j) {
+      const RegressionData &observation(dp->regression_data(j));
+      double regression_contribution =
+          model_->observation_model()->predict(observation.x());
+      double weight = data_imputer_.impute(
+          rng,
+          observation.y() - regression_contribution - state_contribution,
+          model_->observation_model()->sigma(),
+          model_->observation_model()->nu());
+      dp->set_weight(weight, j);
     }
   }
 
@@ -0,0 +1,74 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Models/StateSpace/RegressionPredictionCache.hpp>
+#include <cpputil/report_error.hpp>
+
+namespace BOOM {
+  namespace StateSpace {
+
+    RegressionPredictionCache::RegressionPredictionCache()
+        : design_is_current_(false),
+          predictions_are_current_(false)
+    {}
+
+    void RegressionPredictionCache::set_design(
+        const std::vector<int> &sample_sizes,
+        const std::function<const Vector &(int, int)> &predictors) {
+      row_start_.assign(sample_sizes.size() + 1, 0);
+      for (int t = 0; t < sample_sizes.size(); ++t) {
+        row_start_[t + 1] = row_start_[t] + sample_sizes[t];
+      }
+      int total_sample_size = row_start_.back();
+      int xdim = 0;
+      for (int t = 0; t < sample_sizes.size(); ++t) {
+        if (sample_sizes[t] > 0) {
+          xdim = predictors(t, 0).size();
+          break;
+        }
+      }
+      design_.resize(total_sample_size, xdim);
+      for (int t = 0; t < sample_sizes.size(); ++t) {
+        for (int i = 0; i < sample_sizes[t]; ++i) {
+          design_.row(row_start_[t] + i) = predictors(t, i);
+        }
+      }
+      predictions_.resize(total_sample_size);
+      design_is_current_ = true;
+      predictions_are_current_ = false;
+    }
+
+    ConstVectorView RegressionPredictionCache::predictions(
+        int t, const GlmCoefs &coefficients) {
+      if (!design_is_current_) {
+        report_error("The design matrix in RegressionPredictionCache "
+                     "must be set before predictions can be computed.");
+      }
+      if (!predictions_are_current_) {
+        if (design_.nrow() > 0) {
+          coefficients.predict(design_, predictions_);
+        }
+        predictions_are_current_ = true;
+      }
+      return ConstVectorView(predictions_.data() + row_start_[t],
+                             row_start_[t + 1] - row_start_[t],
+                             1);
+    }
+
+  }  // namespace StateSpace
+}  // namespace BOOM
@@ -41,6 +41,15 @@ namespace BOOM{
         && d <= latest_influence(holiday_date);
   }
 
+  int Holiday::window_position(const Date &d)const{
+    Date holiday_date(nearest(d));
+    Date earliest(earliest_influence(holiday_date));
+    if (d < earliest || d > latest_influence(holiday_date)) {
+      return -1;
+    }
+    return d - earliest;
+  }
+
   //======================================================================
 
   OrdinaryAnnualHoliday::OrdinaryAnnualHoliday(int days_before, int days_after)
@@ -53,11 +62,16 @@ namespace BOOM{
 
   Date OrdinaryAnnualHoliday::earliest_influence(const Date &holiday_date)const{
     int year = holiday_date.year();
-    std::map<Year, Date>::iterator it = earliest_influence_by_year_.find(year);
-    if(it != earliest_influence_by_year_.end()){
-      return it->second;
+    {
+      std::lock_guard<std::mutex> lock(table_mutex_);
+      std::map<Year, Date>::iterator it =
+          earliest_influence_by_year_.find(year);
+      if(it != earliest_influence_by_year_.end()){
+        return it->second;
+      }
     }
     Date ans = date(year) - days_before_;
+    std::lock_guard<std::mutex> lock(table_mutex_);
     earliest_influence_by_year_[year] = ans;
     // Note that year refers to the year of the holiday, and
     // earliest_influence_by_year_[year] contains a Date whose year()
@@ -68,11 +82,15 @@ namespace BOOM{
 
   Date OrdinaryAnnualHoliday::latest_influence(const Date &holiday_date)const{
     int year = holiday_date.year();
-    std::map<Year, Date>::iterator it = latest_influence_by_year_.find(year);
-    if(it != latest_influence_by_year_.end()){
-      return it->second;
+    {
+      std::lock_guard<std::mutex> lock(table_mutex_);
+      std::map<Year, Date>::iterator it = latest_influence_by_year_.find(year);
+      if(it != latest_influence_by_year_.end()){
+        return it->second;
+      }
     }
     Date ans = date(year) + days_after_;
+    std::lock_guard<std::mutex> lock(table_mutex_);
     latest_influence_by_year_[year] = ans;
     return ans;
   }
@@ -82,11 +100,15 @@ namespace BOOM{
   }
 
   Date OrdinaryAnnualHoliday::date(int year)const{
-    std::map<Year, Date>::iterator it = date_lookup_table_.find(year);
-    if(it != date_lookup_table_.end()){
-      return it->second;
+    {
+      std::lock_guard<std::mutex> lock(table_mutex_);
+      std::map<Year, Date>::iterator it = date_lookup_table_.find(year);
+      if(it != date_lookup_table_.end()){
+        return it->second;
+      }
     }
     Date ans = compute_date(year);
+    std::lock_guard<std::mutex> lock(table_mutex_);
     date_lookup_table_[year] = ans;
     return ans;
   }
@@ -38,6 +38,7 @@ namespace BOOM{
   LLSM::LocalLevelStateModel(const LocalLevelStateModel &rhs)
       : Model(rhs),
         StateModel(rhs),
+        ZeroMeanGaussianModel(rhs),
         state_transition_matrix_(rhs.state_transition_matrix_),
         state_variance_matrix_(
             new ConstantMatrixParamView(1, Sigsq_prm())),
@@ -59,8 +60,8 @@ namespace BOOM{
 
   uint LLSM::state_dimension() const {return 1;}
 
-  void LLSM::simulate_state_error(VectorView eta, int) const {
-    eta[0] = rnorm(0, sigma());
+  void LLSM::simulate_state_error(RNG &rng, VectorView eta, int) const {
+    eta[0] = rnorm_mt(rng, 0, sigma());
   }
 
   void LLSM::simulate_initial_state(VectorView eta) const {
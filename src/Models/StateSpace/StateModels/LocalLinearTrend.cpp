@@ -40,7 +40,7 @@ namespace BOOM{
         StateModel(rhs),
         observation_matrix_(rhs.observation_matrix_),
         state_transition_matrix_(rhs.state_transition_matrix_),
-        state_variance_matrix_(rhs.state_variance_matrix_->clone()),
+        state_variance_matrix_(new DenseSpdParamView(Sigma_prm())),
         state_error_expander_(rhs.state_error_expander_->clone()),
         initial_state_mean_(rhs.initial_state_mean_),
         initial_state_variance_(rhs.initial_state_variance_)
@@ -72,8 +72,8 @@ namespace BOOM{
     }
   }
 
-  void LLTSM::simulate_state_error(VectorView eta, int t)const{
-    eta = ZeroMeanMvnModel::sim();
+  void LLTSM::simulate_state_error(RNG &rng, VectorView eta, int t)const{
+    eta = rmvn_mt(rng, ZeroMeanMvnModel::mu(), ZeroMeanMvnModel::Sigma());
   }
 
   Ptr<SparseMatrixBlock> LLTSM::state_transition_matrix(int t)const{
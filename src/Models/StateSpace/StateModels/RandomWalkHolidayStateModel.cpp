@@ -21,6 +21,7 @@
 #include <distributions.hpp>
 #include <cpputil/report_error.hpp>
 #include <cpputil/math_utils.hpp>
+#include <algorithm>
 
 namespace BOOM {
   typedef RandomWalkHolidayStateModel RWHSM;
@@ -33,6 +34,30 @@ namespace BOOM {
     initial_state_variance_.resize(dim);
     identity_transition_matrix_ = new IdentityMatrix(dim);
     zero_state_variance_matrix_ = new ZeroMatrix(dim);
+    build_active_state_variance_matrices();
+  }
+
+  RWHSM::RandomWalkHolidayStateModel(const RWHSM &rhs)
+      : Model(rhs),
+        StateModel(rhs),
+        ZeroMeanGaussianModel(rhs),
+        holiday_(rhs.holiday_),
+        time_zero_(rhs.time_zero_),
+        initial_state_mean_(rhs.initial_state_mean_),
+        initial_state_variance_(rhs.initial_state_variance_),
+        identity_transition_matrix_(rhs.identity_transition_matrix_),
+        zero_state_variance_matrix_(rhs.zero_state_variance_matrix_),
+        window_position_table_(rhs.window_position_table_)
+  {
+    build_active_state_variance_matrices();
+  }
+
+  RandomWalkHolidayStateModel * RWHSM::clone()const{
+    return new RandomWalkHolidayStateModel(*this);}
+
+  void RWHSM::build_active_state_variance_matrices() {
+    int dim = state_dimension();
+    active_state_variance_matrix_.clear();
     for(int i = 0; i < dim; ++i){
       NEW(SingleSparseDiagonalElementMatrixParamView, variance_matrix)(
           dim, Sigsq_prm(), i);
@@ -40,16 +65,38 @@ namespace BOOM {
     }
   }
 
-  RandomWalkHolidayStateModel * RWHSM::clone()const{
-    return new RandomWalkHolidayStateModel(*this);}
+  void RWHSM::observe_time_dimension(int max_time) {
+    if (max_time > window_position_table_.size()) {
+      extend_window_position_table(max_time);
+    }
+  }
+
+  int RWHSM::window_position(int t) const {
+    if (t < 0) {
+      return holiday_->window_position(time_zero_ + t);
+    }
+    if (t >= window_position_table_.size()) {
+      // Grow geometrically so that stepping through a forecast
+      // horizon one day at a time does not refill the table each step.
+      extend_window_position_table(
+          std::max<int>(t + 1, 2 * window_position_table_.size()));
+    }
+    return window_position_table_[t];
+  }
+
+  void RWHSM::extend_window_position_table(int size) const {
+    int old_size = window_position_table_.size();
+    window_position_table_.resize(size);
+    for (int t = old_size; t < size; ++t) {
+      window_position_table_[t] = holiday_->window_position(time_zero_ + t);
+    }
+  }
 
   void RWHSM::observe_state(const ConstVectorView then,
                             const ConstVectorView now,
                             int time_now){
-    Date today = time_zero_ + time_now;
-    if(holiday_->active(today)){
-      Date holiday_date = holiday_->nearest(today);
-      int position = today - holiday_->earliest_influence(holiday_date);
+    int position = window_position(time_now);
+    if(position >= 0){
       double delta = now[position] - then[position];
       suf()->update_raw(delta);
     }
@@ -59,13 +106,11 @@ namespace BOOM {
     return holiday_->maximum_window_width();
   }
 
-  void RWHSM::simulate_state_error(VectorView eta, int t)const{
-    Date now = time_zero_ + t;
+  void RWHSM::simulate_state_error(RNG &rng, VectorView eta, int t)const{
     eta = 0;
-    if(holiday_->active(now)){
-      Date holiday_date(holiday_->nearest(now));
-      int position = now - holiday_->earliest_influence(holiday_date);
-      eta[position] = rnorm(0, sigma());
+    int position = window_position(t);
+    if(position >= 0){
+      eta[position] = rnorm_mt(rng, 0, sigma());
     }
   }
 
@@ -74,10 +119,8 @@ namespace BOOM {
   }
 
   Ptr<SparseMatrixBlock> RWHSM::state_variance_matrix(int t)const{
-    Date now = time_zero_ + t;
-    if(holiday_->active(now)){
-      Date holiday_date(holiday_->nearest(now));
-      int position = now - holiday_->earliest_influence(holiday_date);
+    int position = window_position(t);
+    if(position >= 0){
       return active_state_variance_matrix_[position];
     }
     return zero_state_variance_matrix_;
@@ -92,11 +135,9 @@ namespace BOOM {
   }
 
   SparseVector RWHSM::observation_matrix(int t)const{
-    Date now = time_zero_ + t;
     SparseVector ans(state_dimension());
-    if(holiday_->active(now)){
-      Date holiday_date(holiday_->nearest(now));
-      int position = now - holiday_->earliest_influence(holiday_date);
+    int position = window_position(t);
+    if(position >= 0){
       ans[position] = 1.0;
     }
     return ans;
@@ -136,6 +177,7 @@ namespace BOOM {
 
   void RWHSM::set_time_zero(const Date &time_zero){
     time_zero_ = time_zero;
+    window_position_table_.clear();
   }
 
 }  // namespace BOOM
@@ -59,9 +59,10 @@ namespace BOOM{
         duration_(rhs.duration_),
         time_of_first_observation_(rhs.time_of_first_observation_),
         T0_(rhs.T0_),
-        RQR0_(rhs.RQR0_->clone()),
+        RQR0_(new UpperLeftCornerMatrixParamView(
+            state_dimension(), Sigsq_prm())),
         state_error_variance_at_new_season_(
-            rhs.state_error_variance_at_new_season_->clone()),
+            new UpperLeftCornerMatrixParamView(1, Sigsq_prm())),
         T1_(rhs.T1_),
         RQR1_(rhs.RQR1_),
         state_error_variance_in_season_interior_(
@@ -127,7 +128,9 @@ namespace BOOM{
     return nseasons_ - 1;
   }
 
-  void SSM::simulate_state_error(VectorView state_error, int t)const{
+  void SSM::simulate_state_error(RNG &rng,
+                                 VectorView state_error,
+                                 int t)const{
     if(initial_state_mean_.size() != state_dimension()
        || initial_state_variance_.nrow() != state_dimension()){
       ostringstream err;
@@ -144,7 +147,7 @@ namespace BOOM{
     if(new_season(t+1)){
       // If next time period is the start of a new season, then an
       // update is needed.  Otherwise, the state error is zero.
-      state_error[0] = rnorm(0, sigma());
+      state_error[0] = rnorm_mt(rng, 0, sigma());
     }
   }
 
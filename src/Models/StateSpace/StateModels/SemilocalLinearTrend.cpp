@@ -168,9 +168,9 @@ namespace BOOM{
                  "be part of an EM algorithm.");
   }
 
-  void SLLT::simulate_state_error(VectorView eta, int t) const {
-    eta[0] = rnorm(0, level_->sigma());
-    eta[1] = rnorm(0, slope_->sigma());
+  void SLLT::simulate_state_error(RNG &rng, VectorView eta, int t) const {
+    eta[0] = rnorm_mt(rng, 0, level_->sigma());
+    eta[1] = rnorm_mt(rng, 0, slope_->sigma());
     eta[2] = 0;
   }
 
@@ -109,6 +109,16 @@ namespace BOOM {
     return ans / total_precision;
   }
 
+  double ABRD::adjusted_observation(const ConstVectorView &predictions) const {
+    double total_precision = 0;
+    double ans = 0;
+    for (int i = 0; i < binomial_data_.size(); ++i) {
+      ans += precisions_[i] * (latent_continuous_values_[i] - predictions[i]);
+      total_precision += precisions_[i];
+    }
+    return ans / total_precision;
+  }
+
   double ABRD::latent_data_overall_variance() const {
     return 1.0 / sum(precisions_);
   }
@@ -120,6 +130,8 @@ namespace BOOM {
   //======================================================================
   void SSLM::setup() {
     observe(observation_model_->coef_prm());
+    prediction_cache_.observe(observation_model_->coef_prm(),
+                              static_cast<DataPolicy &>(*this));
   }
 
   SSLM::StateSpaceLogitModel(int xdim)
@@ -158,7 +170,9 @@ namespace BOOM {
   SSLM::StateSpaceLogitModel(const SSLM &rhs)
       : StateSpaceNormalMixture(rhs),
         observation_model_(rhs.observation_model_->clone())
-  {}
+  {
+    setup();
+  }
 
   SSLM * SSLM::clone() const {return new SSLM(*this);}
 
@@ -174,7 +188,16 @@ namespace BOOM {
     if (is_missing_observation(t)) {
       return negative_infinity();
     }
-    return dat()[t]->adjusted_observation(observation_model_->coef());
+    return dat()[t]->adjusted_observation(regression_predictions(t));
+  }
+
+  ConstVectorView SSLM::regression_predictions(int t) const {
+    return prediction_cache_.predictions(
+        t, dat(),
+        [](const ABRD &data_point, int i) -> const Vector & {
+          return data_point.binomial_data(i).x();
+        },
+        observation_model_->coef());
   }
 
   bool SSLM::is_missing_observation(int t) const {
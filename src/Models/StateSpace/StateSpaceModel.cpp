@@ -20,6 +20,7 @@
 #include <stats/moments.hpp>
 #include <distributions.hpp>
 #include <Models/StateSpace/Filters/SparseKalmanTools.hpp>
+#include <Models/StateSpace/MultiDrawForecastSimulator.hpp>
 #include <cpputil/math_utils.hpp>
 
 namespace BOOM{
@@ -202,6 +203,18 @@ namespace BOOM{
     return ans;
   }
 
+  Matrix SSM::simulate_forecasts(int horizon,
+                                 const Matrix &parameter_draws,
+                                 const Matrix &final_states,
+                                 int number_of_threads,
+                                 const Vector &quantiles) const {
+    StateSpace::MultiDrawForecastSimulator simulator(this, number_of_threads);
+    Matrix ans = simulator.simulate_forecasts(
+        horizon, parameter_draws, final_states);
+    if (quantiles.empty()) return ans;
+    return StateSpace::forecast_quantiles(ans, quantiles);
+  }
+
   Vector SSM::simulate_forecast_given_observed_data(
       int n, const Vector &observed_data) {
     StateSpaceModelBase::set_state_model_behavior(StateModel::MARGINAL);
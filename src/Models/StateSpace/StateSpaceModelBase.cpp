@@ -19,6 +19,7 @@
 #include <functional>
 #include <distributions.hpp>
 #include <Models/StateSpace/StateSpaceModelBase.hpp>
+#include <Models/StateSpace/ParallelLogLikelihoodEvaluator.hpp>
 #include <Models/StateSpace/Filters/SparseKalmanTools.hpp>
 #include <cpputil/report_error.hpp>
 #include <LinAlg/SubMatrix.hpp>
@@ -37,7 +38,6 @@ namespace BOOM{
         state_positions_(1, 0),
         state_error_positions_(1, 0),
         state_is_fixed_(false),
-        mcmc_kalman_storage_is_current_(false),
         kalman_filter_is_current_(false),
         default_state_transition_matrix_(new BlockDiagonalMatrix),
         default_state_variance_matrix_(new BlockDiagonalMatrix),
@@ -53,7 +53,6 @@ namespace BOOM{
         state_positions_(1, 0),
         state_error_positions_(1, 0),
         state_is_fixed_(rhs.state_is_fixed_),
-        mcmc_kalman_storage_is_current_(false),
         kalman_filter_is_current_(false),
         default_state_transition_matrix_(new BlockDiagonalMatrix),
         default_state_variance_matrix_(new BlockDiagonalMatrix),
@@ -116,9 +115,8 @@ namespace BOOM{
       resize_state();
       clear_client_data();
       simulate_forward();
-      Vector r0_sim = smooth_disturbances_fast(light_kalman_storage_);
-      Vector r0_obs = smooth_disturbances_fast(supplemental_kalman_storage_);
-      propagate_disturbances(r0_sim, r0_obs, true);
+      Vector r0 = smooth_disturbances_fast(light_kalman_storage_);
+      propagate_disturbances(r0, true);
     }
   }
 
@@ -136,64 +134,47 @@ namespace BOOM{
   }
 
   //----------------------------------------------------------------------
-  // Simulate alpha_+ and y_* = y - y_+.  While simulating y_*,
-  // feed it into the light (no storage for P) Kalman filter.  The
-  // simulated state is stored in state_, while kalman_storage_ holds
-  // the output of the Kalman filter.
+  // Simulate alpha_+ and y_+ from the model, and run the light (no
+  // storage for P) Kalman filter on y_* = y - y_+ in the same loop.
+  // The simulated state is stored in state_, while
+  // light_kalman_storage_ holds the output of the Kalman filter.
   //
-  // y_+ and alpha_+ will be simulated in parallel with
-  // Kalman filtering and disturbance smoothing of y, and the results
-  // will be subtracted to compute y_*.
+  // This is the "mean corrected" simulation smoother of Durbin and
+  // Koopman (2002).  The smoothed state mean is linear in the data, so
+  // E(alpha | y) - E(alpha_+ | y_+) = E(alpha | y_*) when the latter
+  // is computed with a zero initial state mean.  Only one Kalman
+  // filter (and one disturbance smoother) is needed, rather than
+  // separate passes over y and y_+.
   void SSMB::simulate_forward() {
     check_light_kalman_storage(light_kalman_storage_);
-    check_light_kalman_storage(supplemental_kalman_storage_);
-    log_likelihood_ = 0;
     for (int t = 0; t < time_dimension(); ++t) {
       // simulate_state at time t
       if (t == 0) {
         simulate_initial_state(state_.col(0));
-        a_ = initial_state_mean();
+        a_.resize(state_dimension());
+        a_ = 0.0;
         P_ = initial_state_variance();
-        supplemental_a_ = a_;
-        supplemental_P_ = P_;
       }else{
         simulate_next_state(state_.col(t-1), state_.col(t), t);
       }
       double y_sim = simulate_adjusted_observation(t);
+      bool missing = is_missing_observation(t);
+      double y_star = missing ? 0.0 : adjusted_observation(t) - y_sim;
       sparse_scalar_kalman_update(
-          y_sim,
+          y_star,
           a_,
           P_,
           light_kalman_storage_[t].K,
           light_kalman_storage_[t].F,
           light_kalman_storage_[t].v,
-          is_missing_observation(t),
+          missing,
           observation_matrix(t),
           observation_variance(t),
           *state_transition_matrix(t),
           *state_variance_matrix(t));
-        ////////////////////////
-        // TODO(stevescott): The actual one step ahead prediction
-        // errors are being stored in supplemental_kalman_storage_,
-        // and not light_kalman_storage_.  We should eventually keep
-        // the prediction errors in the right place.
-      log_likelihood_ += sparse_scalar_kalman_update(
-          adjusted_observation(t),
-          supplemental_a_,
-          supplemental_P_,
-          supplemental_kalman_storage_[t].K,
-          supplemental_kalman_storage_[t].F,
-          supplemental_kalman_storage_[t].v,
-          is_missing_observation(t),
-          observation_matrix(t),
-          observation_variance(t),
-          (*state_transition_matrix(t)),
-          (*state_variance_matrix(t)));
-
       // The Kalman update sets a_ to a[t+1] and P to P[t+1], so they
       // will be current for the next iteration.
     }
-    mcmc_kalman_storage_is_current_ = true;
   }
 
   //----------------------------------------------------------------------
@@ -227,11 +208,11 @@ namespace BOOM{
       Vector &K(kalman_storage[t].K);
       double coefficient = (v/F) - K.dot(r);
 
-      // Now produce r[t-1]
-      Vector rt_1 = state_transition_matrix(t)->Tmult(r);
-      observation_matrix(t).add_this_to(rt_1, coefficient);
-      K = r;
-      r = rt_1;
+      // Now produce r[t-1].  K is no longer needed, so its storage
+      // is used to build r[t-1], and then swapped with r.
+      state_transition_matrix(t)->Tmult(VectorView(K), r);
+      observation_matrix(t).add_this_to(K, coefficient);
+      K.swap(r);
     }
     return r;
   }
@@ -239,29 +220,24 @@ namespace BOOM{
   //----------------------------------------------------------------------
   // After a call to smooth_disturbances_fast() puts r[t] in
   // light_kalman_storage_[t].K, this function propagates the r's
-  // forward to get E(alpha | y), and add it to the simulated state.
-  void SSMB::propagate_disturbances(
-      const Vector &r0_sim, const Vector & r0_obs, bool observe) {
-    // TODO(stevescott): Two linear operations are being performed in
-    // parallel.  Can they be replaced by a single linear operation on
-    // the difference?
+  // forward to get E(alpha | y_*), and adds it to the simulated state.
+  // E(alpha | y_*) is computed with a zero initial state mean.  See
+  // the comments in simulate_forward().
+  void SSMB::propagate_disturbances(const Vector &r0, bool observe) {
     if (state_.ncol() <= 0) return;
-    SpdMatrix P0 = initial_state_variance();
-    Vector state_mean_sim = initial_state_mean() + P0*r0_sim;
-    Vector state_mean_obs = initial_state_mean() + P0*r0_obs;
-
-    state_.col(0) += state_mean_obs - state_mean_sim;
+    Vector state_mean = initial_state_variance() * r0;
+    state_.col(0) += state_mean;
     if (observe) {
       observe_state(0);
       observe_data_given_state(0);
     }
+    Vector workspace(state_dimension());
     for (int t = 1; t < time_dimension(); ++t) {
-      state_mean_sim = (*state_transition_matrix(t-1)) * state_mean_sim
-          + (*state_variance_matrix(t-1)) * light_kalman_storage_[t-1].K;
-      state_mean_obs = (*state_transition_matrix(t-1)) * state_mean_obs
-          + (*state_variance_matrix(t-1)) * supplemental_kalman_storage_[t-1].K;
-
-      state_.col(t).axpy(state_mean_obs - state_mean_sim);
+      state_transition_matrix(t-1)->multiply_inplace(VectorView(state_mean));
+      state_variance_matrix(t-1)->multiply(
+          VectorView(workspace), light_kalman_storage_[t-1].K);
+      state_mean += workspace;
+      state_.col(t) += state_mean;
       if (observe) {
         observe_state(t);
         observe_data_given_state(t);
@@ -296,16 +272,6 @@ namespace BOOM{
     int n = time_dimension();
     Vector errors(n);
     if (n == 0) return errors;
-
-    if (mcmc_kalman_storage_is_current_) {
-      for (int i = 0; i < n; ++i) {
-        // TODO(stevescott): Clean up this hack by making sure the one
-        // step prediction errors are stored in light_kalman_storage_
-        // instead of supplemental_kalman_storage_.
-        errors[i] = supplemental_kalman_storage_[i].v;
-      }
-      return errors;
-    }
     log_likelihood_ = 0;
     initialize_final_kalman_storage();
     ScalarKalmanStorage &ks(final_kalman_storage_);
@@ -486,16 +452,14 @@ namespace BOOM{
   }
 
   double SSMB::log_likelihood(const Vector &parameters) const {
-    StateSpaceUtils::LogLikelihoodEvaluator evaluator(this);
+    StateSpaceUtils::ParallelLogLikelihoodEvaluator evaluator(this);
     return evaluator.evaluate_log_likelihood(parameters);
   }
 
   double SSMB::log_likelihood_derivatives(const Vector &parameters,
                                           Vector &gradient) const {
-    StateSpaceUtils::LogLikelihoodEvaluator evaluator(this);
-    return evaluator.evaluate_log_likelihood_derivatives(
-        ConstVectorView(parameters),
-        VectorView(gradient));
+    StateSpaceUtils::ParallelLogLikelihoodEvaluator evaluator(this);
+    return evaluator.evaluate_log_likelihood_derivatives(parameters, gradient);
   }
 
   double SSMB::log_likelihood_derivatives(VectorView gradient) {
@@ -575,8 +539,17 @@ namespace BOOM{
   void SSMB::simulate_next_state(ConstVectorView last,
                                  VectorView next,
                                  int t) const {
-    next= (*state_transition_matrix(t-1)) * last;
-    next += simulate_state_error(t-1);
+    simulate_next_state(GlobalRng::rng, last, next, t);
+  }
+
+  void SSMB::simulate_next_state(RNG &rng,
+                                 ConstVectorView last,
+                                 VectorView next,
+                                 int t) const {
+    state_transition_matrix(t-1)->multiply(next, last);
+    Vector eta(next.size());
+    simulate_state_error(rng, VectorView(eta), t-1);
+    next += eta;
   }
 
   //----------------------------------------------------------------------
@@ -590,14 +563,19 @@ namespace BOOM{
   }
 
   //----------------------------------------------------------------------
-  Vector SSMB::simulate_state_error(int t) const {
+  void SSMB::simulate_state_error(RNG &rng, VectorView eta, int t) const {
     // simulate N(0, RQR) for the state at time t+1, using the
     // variance matrix at time t.
-    Vector ans(state_dimension_, 0);
+    eta = 0;
     for (int s = 0; s < state_models_.size(); ++s) {
-      VectorView eta(state_component(ans, s));
-      state_model(s)->simulate_state_error(eta, t);
+      state_model(s)->simulate_state_error(
+          rng, state_component(eta, s), t);
     }
+  }
+
+  Vector SSMB::simulate_state_error(int t) const {
+    Vector ans(state_dimension(), 0);
+    simulate_state_error(GlobalRng::rng, VectorView(ans), t);
     return ans;
   }
   //----------------------------------------------------------------------
@@ -937,6 +915,7 @@ namespace BOOM{
 
     Vector r(state_dimension(), 0.0);
     SpdMatrix N(state_dimension(), 0.0);
+    Vector smoother_workspace(2 * state_dimension());
     for (int t = time_dimension() - 1; t >= 0; --t) {
       // From this point, up until
       // sparse_scalar_kalman_disturbance_smoother_update, r is r_t,
@@ -974,7 +953,7 @@ namespace BOOM{
       // Kalman smoother: convert r[t] to r[t-1] and N[t] to N[t-1].
       sparse_scalar_kalman_disturbance_smoother_update(
           r, N, (*state_transition_matrix(t)),
-          K, observation_matrix(t), F, v);
+          K, observation_matrix(t), F, v, VectorView(smoother_workspace));
 
       // The E step contribution for the observation at time t
       // involves the mean and the variance of the state error from
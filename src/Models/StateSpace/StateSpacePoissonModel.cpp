@@ -101,6 +101,22 @@ namespace BOOM {
     return ans / total_precision;
   }
 
+  double APRD::adjusted_observation(const ConstVectorView &predictions) const {
+    if (latent_continuous_values_.empty()) {
+      return negative_infinity();
+    }
+    double ans = 0;
+    double total_precision = 0;
+    for (int i = 0; i < latent_continuous_values_.size(); ++i) {
+      ans += precisions_[i] * (latent_continuous_values_[i] - predictions[i]);
+      total_precision += precisions_[i];
+    }
+    if (total_precision <= 0 || !std::isfinite(total_precision)) {
+      return negative_infinity();
+    }
+    return ans / total_precision;
+  }
+
   double APRD::latent_data_overall_variance() const {
     double total_precision = sum(precisions_);
     if (total_precision <= 0 || !std::isfinite(total_precision)) {
@@ -117,7 +133,9 @@ namespace BOOM {
   SSPM::StateSpacePoissonModel(int xdim)
       : StateSpaceNormalMixture(xdim > 1),
         observation_model_(new PoissonRegressionModel(xdim))
-  {}
+  {
+    setup();
+  }
 
   SSPM::StateSpacePoissonModel(const Vector &counts,
                                const Vector &exposure,
@@ -126,6 +144,7 @@ namespace BOOM {
       : StateSpaceNormalMixture(ncol(design) > 0),
         observation_model_(new PoissonRegressionModel(ncol(design)))
   {
+    setup();
     if ((ncol(design) == 1) &&
         (var(design.col(0)) < std::numeric_limits<double>::epsilon())) {
       set_regression_flag(false);
@@ -152,12 +171,20 @@ namespace BOOM {
   SSPM::StateSpacePoissonModel(const SSPM &rhs)
       : StateSpaceNormalMixture(rhs),
         observation_model_(rhs.observation_model_->clone())
-  {}
+  {
+    setup();
+  }
 
   SSPM * SSPM::clone() const {
     return new SSPM(*this);
   }
 
+  void SSPM::setup() {
+    observe(observation_model_->coef_prm());
+    prediction_cache_.observe(observation_model_->coef_prm(),
+                              static_cast<DataPolicy &>(*this));
+  }
+
   int SSPM::time_dimension() const {
     return dat().size();
   }
@@ -170,7 +197,16 @@ namespace BOOM {
     if (is_missing_observation(t)) {
       return negative_infinity();
     }
-    return dat()[t]->adjusted_observation(observation_model_->coef());
+    return dat()[t]->adjusted_observation(regression_predictions(t));
+  }
+
+  ConstVectorView SSPM::regression_predictions(int t) const {
+    return prediction_cache_.predictions(
+        t, dat(),
+        [](const APRD &data_point, int i) -> const Vector & {
+          return data_point.poisson_data(i).x();
+        },
+        observation_model_->coef());
   }
 
   bool SSPM::is_missing_observation(int t) const {
@@ -18,6 +18,7 @@
 #include <Models/StateSpace/StateSpaceRegressionModel.hpp>
 #include <Models/StateSpace/StateModels/StateModel.hpp>
 #include <Models/StateSpace/Filters/SparseKalmanTools.hpp>
+#include <Models/StateSpace/MultiDrawForecastSimulator.hpp>
 #include <Models/DataTypes.hpp>
 #include <distributions.hpp>
 
@@ -67,6 +68,14 @@ namespace BOOM{
     return ans / sample_size();
   }
 
+  double MRD::adjusted_observation(const ConstVectorView &predictions) const {
+    double ans = 0;
+    for (int i = 0; i < regression_data_.size(); ++i) {
+      ans += regression_data(i).y() - predictions[i];
+    }
+    return ans / sample_size();
+  }
+
   const RegressionData &MRD::regression_data(int i) const {
     return *(regression_data_[i]);
   }
@@ -79,22 +88,33 @@ namespace BOOM{
   void SSRM::setup() {
     observe(regression_->coef_prm());
     observe(regression_->Sigsq_prm());
+    prediction_cache_.observe(regression_->coef_prm(),
+                              static_cast<DataPolicy &>(*this));
+    DataPolicy::add_observer([this]() {this->invalidate_data_summaries();});
     regression_->only_keep_sufstats(true);
   }
 
+  void SSRM::invalidate_data_summaries() {
+    data_summaries_are_current_ = false;
+    Ptr<NeRegSuf> suf = regression_->suf().dcast<NeRegSuf>();
+    if (!!suf) suf->fix_xtx(false);
+  }
+
   SSRM::StateSpaceRegressionModel(int xdim)
-      : regression_(new RegressionModel(xdim))
+      : regression_(new RegressionModel(xdim)),
+        data_summaries_are_current_(false)
   {
     setup();
     // Note that in this constructor the regression model will still
-    // need to have data added, so we can't call fix_xtx().  This
-    // means that the xtx matrix will be re-computed with each trip
-    // through the data.
+    // need to have data added, so xtx can't be fixed yet.  It is
+    // computed once, the first time observe_data_given_state() is
+    // called after data has been added.
   }
 
   SSRM::StateSpaceRegressionModel(const Vector &y, const Matrix &X,
                                   const std::vector<bool> &observed)
-      : regression_(new RegressionModel(ncol(X)))
+      : regression_(new RegressionModel(ncol(X))),
+        data_summaries_are_current_(false)
   {
     setup();
     int n = y.size();
@@ -114,10 +134,7 @@ namespace BOOM{
       }
       add_data(dp);
     }
-
-    // The cast is necessary because the regression model stores a Ptr
-    // to a base class that does not supply fix_xtx();
-    regression_->suf().dcast<NeRegSuf>()->fix_xtx();
+    refresh_data_summaries();
   }
 
   SSRM::StateSpaceRegressionModel(const SSRM &rhs)
@@ -125,7 +142,8 @@ namespace BOOM{
         StateSpaceModelBase(rhs),
         DataPolicy(rhs),
         PriorPolicy(rhs),
-        regression_(rhs.regression_->clone())
+        regression_(rhs.regression_->clone()),
+        data_summaries_are_current_(false)
   {
     setup();
   }
@@ -159,6 +177,7 @@ namespace BOOM{
     for (int i = 0; i < dp->sample_size(); ++i) {
       regression_model()->add_data(dp->regression_data_ptr(i));
     }
+    invalidate_data_summaries();
   }
 
   double SSRM::observation_variance(int t) const {
@@ -174,7 +193,16 @@ namespace BOOM{
   }
 
   double SSRM::adjusted_observation(int t) const {
-    return dat()[t]->adjusted_observation(regression_->coef());
+    return dat()[t]->adjusted_observation(regression_predictions(t));
+  }
+
+  ConstVectorView SSRM::regression_predictions(int t) const {
+    return prediction_cache_.predictions(
+        t, dat(),
+        [](const MRD &data_point, int i) -> const Vector & {
+          return data_point.regression_data(i).x();
+        },
+        regression_->coef());
   }
 
   bool SSRM::is_missing_observation(int t) const {
@@ -183,16 +211,90 @@ namespace BOOM{
 
   void SSRM::observe_data_given_state(int t) {
     if (!is_missing_observation(t)) {
-      Ptr<MRD> dp(dat()[t]);
       double state_mean = observation_matrix(t).dot(state(t));
-      for (int i = 0; i < dp->sample_size(); ++i) {
-        const RegressionData &observation(dp->regression_data(i));
-        regression_->suf()->add_mixture_data(
-            observation.y() - state_mean, observation.x(), 1.0);
+      Ptr<NeRegSuf> suf = regression_->suf().dcast<NeRegSuf>();
+      if (!!suf) {
+        if (!data_summaries_are_current_) refresh_data_summaries();
+        const DataSummary &summary(data_summaries_[t]);
+        suf->add_offset_group(summary.xty, summary.x_sums, summary.yty,
+                              summary.ysum, summary.n, state_mean);
+      } else {
+        Ptr<MRD> dp(dat()[t]);
+        for (int i = 0; i < dp->sample_size(); ++i) {
+          const RegressionData &observation(dp->regression_data(i));
+          regression_->suf()->add_mixture_data(
+              observation.y() - state_mean, observation.x(), 1.0);
+        }
       }
     }
   }
 
+  void SSRM::clear_client_data() {
+    StateSpaceModelBase::clear_client_data();
+    if (data_summaries_are_current_) {
+      const std::vector<Ptr<MRD>> &data(dat());
+      if (data_summaries_.size() != data.size()) {
+        invalidate_data_summaries();
+      } else {
+        for (int t = 0; t < data.size(); ++t) {
+          if (data_summaries_[t].observed == is_missing_observation(t)) {
+            invalidate_data_summaries();
+            break;
+          }
+        }
+      }
+    }
+    if (data_summaries_are_current_) refresh_response_summaries();
+  }
+
+  void SSRM::refresh_response_summaries() {
+    const std::vector<Ptr<MRD>> &data(dat());
+    for (int t = 0; t < data.size(); ++t) {
+      DataSummary &summary(data_summaries_[t]);
+      summary.xty = 0.0;
+      summary.yty = 0;
+      summary.ysum = 0;
+      for (int i = 0; i < data[t]->sample_size(); ++i) {
+        const RegressionData &observation(data[t]->regression_data(i));
+        double y = observation.y();
+        summary.xty.axpy(observation.x(), y);
+        summary.yty += y * y;
+        summary.ysum += y;
+      }
+    }
+  }
+
+  void SSRM::refresh_data_summaries() {
+    const std::vector<Ptr<MRD>> &data(dat());
+    int xdim = regression_->xdim();
+    SpdMatrix xtx(xdim, 0.0);
+    data_summaries_.resize(data.size());
+    for (int t = 0; t < data.size(); ++t) {
+      DataSummary &summary(data_summaries_[t]);
+      summary.xty.assign(xdim, 0.0);
+      summary.x_sums.assign(xdim, 0.0);
+      summary.yty = 0;
+      summary.ysum = 0;
+      summary.n = data[t]->sample_size();
+      bool observed = !is_missing_observation(t);
+      summary.observed = observed;
+      for (int i = 0; i < data[t]->sample_size(); ++i) {
+        const RegressionData &observation(data[t]->regression_data(i));
+        const Vector &x(observation.x());
+        double y = observation.y();
+        summary.xty.axpy(x, y);
+        summary.x_sums += x;
+        summary.yty += y * y;
+        summary.ysum += y;
+        if (observed) xtx.add_outer(x, 1.0, false);
+      }
+    }
+    xtx.reflect();
+    Ptr<NeRegSuf> suf = regression_->suf().dcast<NeRegSuf>();
+    if (!!suf) suf->fix_xtx(xtx);
+    data_summaries_are_current_ = true;
+  }
+
   Matrix SSRM::forecast(const Matrix &newX) const {
     ScalarKalmanStorage ks = filter();
     Matrix ans(nrow(newX), 2);
@@ -232,6 +334,29 @@ namespace BOOM{
     return ans;
   }
 
+  Matrix SSRM::simulate_forecasts(const Matrix &newX,
+                                  const Matrix &parameter_draws,
+                                  const Matrix &final_states,
+                                  int number_of_threads,
+                                  const Vector &quantiles) const {
+    StateSpace::MultiDrawForecastSimulator simulator(this, number_of_threads);
+    simulator.set_mean_offset(
+        [&newX](const StateSpaceModelBase &model, int horizon) {
+          const RegressionModel *regression =
+              dynamic_cast<const StateSpaceRegressionModel &>(model)
+              .observation_model();
+          Vector ans(horizon);
+          for (int t = 0; t < horizon; ++t) {
+            ans[t] = regression->predict(newX.row(t));
+          }
+          return ans;
+        });
+    Matrix ans = simulator.simulate_forecasts(
+        nrow(newX), parameter_draws, final_states);
+    if (quantiles.empty()) return ans;
+    return StateSpace::forecast_quantiles(ans, quantiles);
+  }
+
   Vector SSRM::simulate_forecast(const Matrix &newX) {
     StateSpaceModelBase::set_state_model_behavior(StateModel::MARGINAL);
     ScalarKalmanStorage kalman_storage = filter();
@@ -87,6 +87,17 @@ namespace BOOM {
     return ans / total_precision;
   }
 
+  double AugmentedData::adjusted_observation(
+      const ConstVectorView &predictions) const {
+    double ans = 0;
+    double total_precision = 0;
+    for (int i = 0; i < regression_data_.size(); ++i) {
+      ans += weights_[i] * (regression_data(i).y() - predictions[i]);
+      total_precision += weights_[i];
+    }
+    return ans / total_precision;
+  }
+
   double AugmentedData::sum_of_weights() const {
     return sum(weights_);
   }
@@ -138,7 +149,9 @@ namespace BOOM {
         DataPolicy(rhs),
         PriorPolicy(rhs),
         observation_model_(rhs.observation_model_->clone())
-  {}
+  {
+    set_observers();
+  }
 
   SSSRM * SSSRM::clone() const {return new SSSRM(*this);}
 
@@ -162,7 +175,16 @@ namespace BOOM {
     if (is_missing_observation(t)) {
       return negative_infinity();
     }
-    return dat()[t]->adjusted_observation(observation_model_->coef());
+    return dat()[t]->adjusted_observation(regression_predictions(t));
+  }
+
+  ConstVectorView SSSRM::regression_predictions(int t) const {
+    return prediction_cache_.predictions(
+        t, dat(),
+        [](const AugmentedData &data_point, int i) -> const Vector & {
+          return data_point.regression_data(i).x();
+        },
+        observation_model_->coef());
   }
 
   bool SSSRM::is_missing_observation(int t) const {
@@ -256,6 +278,8 @@ namespace BOOM {
     observe(observation_model_->coef_prm());
     observe(observation_model_->Sigsq_prm());
     observe(observation_model_->Nu_prm());
+    prediction_cache_.observe(observation_model_->coef_prm(),
+                              static_cast<DataPolicy &>(*this));
   }
 
 }  // namespace BOOM
@@ -0,0 +1,204 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <Samplers/MultivariateLangevinSampler.hpp>
+#include <distributions.hpp>
+#include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
+#include <cmath>
+
+namespace BOOM {
+
+  MultivariateLangevinSampler::MultivariateLangevinSampler(
+      Ptr<dTargetFun> logf,
+      int xdim,
+      double initial_step_size,
+      RNG *rng)
+      : Sampler(rng),
+        logf_(logf),
+        step_size_(1.0),
+        preconditioner_(xdim, 1.0),
+        preconditioner_chol_(xdim, xdim, 0.0),
+        adapt_step_size_(false),
+        adapt_preconditioner_(false),
+        preconditioner_update_frequency_(100),
+        target_acceptance_rate_(0.574),
+        number_of_draws_(0),
+        number_of_accepted_draws_(0),
+        number_of_observed_draws_(0),
+        running_mean_(xdim, 0.0),
+        running_sum_of_squares_(xdim, 0.0),
+        current_logp_(negative_infinity())
+  {
+    if (xdim <= 0) {
+      report_error("MultivariateLangevinSampler needs a positive dimension.");
+    }
+    set_step_size(initial_step_size);
+    preconditioner_chol_.diag() = 1.0;
+  }
+
+  Vector MultivariateLangevinSampler::draw(const Vector &x) {
+    if (x.size() != preconditioner_.nrow()) {
+      report_error("Argument to MultivariateLangevinSampler::draw has "
+                   "the wrong dimension.");
+    }
+    // The target is re-evaluated at x on each call, because when this
+    // sampler is used inside a Gibbs sampler the target can change
+    // between calls even if x does not.
+    current_x_ = x;
+    // Target functions may accumulate into the gradient, so it must be
+    // sized and zeroed before each call.
+    current_gradient_.resize(x.size());
+    current_gradient_ = 0.0;
+    current_logp_ = logf(current_x_, current_gradient_);
+
+    Vector proposal_center = proposal_mean(current_x_, current_gradient_);
+    Vector z(x.size());
+    for (int i = 0; i < z.size(); ++i) {
+      z[i] = rnorm_mt(rng());
+    }
+    Vector proposal = proposal_center + sqrt(step_size_) * (preconditioner_chol_ * z);
+
+    Vector proposal_gradient(x.size(), 0.0);
+    double logp_proposal = logf(proposal, proposal_gradient);
+    double log_acceptance_ratio = negative_infinity();
+    if (std::isfinite(logp_proposal)) {
+      log_acceptance_ratio =
+          logp_proposal
+          - log_proposal_density(proposal, current_x_, current_gradient_)
+          - current_logp_
+          + log_proposal_density(current_x_, proposal, proposal_gradient);
+    }
+
+    ++number_of_draws_;
+    if (log(runif_mt(rng())) < log_acceptance_ratio) {
+      ++number_of_accepted_draws_;
+      current_x_ = proposal;
+      current_logp_ = logp_proposal;
+      current_gradient_ = proposal_gradient;
+    }
+
+    if (adapt_step_size_) {
+      adapt_step_size(log_acceptance_ratio);
+    }
+    if (adapt_preconditioner_) {
+      update_running_moments(current_x_);
+    }
+    return current_x_;
+  }
+
+  void MultivariateLangevinSampler::set_step_size(double step_size) {
+    if (step_size <= 0) {
+      report_error("step_size must be positive");
+    }
+    step_size_ = step_size;
+  }
+
+  void MultivariateLangevinSampler::set_preconditioner(const SpdMatrix &M) {
+    if (M.nrow() != preconditioner_.nrow()) {
+      report_error("Preconditioning matrix is the wrong size.");
+    }
+    bool ok = true;
+    Matrix L = M.chol(ok);
+    if (!ok) {
+      report_error("Preconditioning matrix must be positive definite.");
+    }
+    preconditioner_ = M;
+    preconditioner_chol_ = L;
+  }
+
+  void MultivariateLangevinSampler::allow_adaptation(bool okay_to_adapt) {
+    adapt_step_size_ = okay_to_adapt;
+  }
+
+  void MultivariateLangevinSampler::allow_preconditioner_adaptation(
+      bool okay_to_adapt, int update_frequency) {
+    if (update_frequency <= 0) {
+      report_error("update_frequency must be positive.");
+    }
+    adapt_preconditioner_ = okay_to_adapt;
+    preconditioner_update_frequency_ = update_frequency;
+  }
+
+  void MultivariateLangevinSampler::set_target_acceptance_rate(double rate) {
+    if (rate <= 0 || rate >= 1) {
+      report_error("Target acceptance rate must be strictly between 0 and 1.");
+    }
+    target_acceptance_rate_ = rate;
+  }
+
+  double MultivariateLangevinSampler::acceptance_rate() const {
+    if (number_of_draws_ == 0) return 0.0;
+    return static_cast<double>(number_of_accepted_draws_) / number_of_draws_;
+  }
+
+  double MultivariateLangevinSampler::log_proposal_density(
+      const Vector &to, const Vector &from, const Vector &from_gradient) const {
+    // With M = L L^T, the quadratic form in the proposal density is
+    // |L^{-1} (to - mu)|^2 / h.  The normalizing constant depends
+    // only on h and M, so it cancels in the MH ratio.
+    Vector residual = to - proposal_mean(from, from_gradient);
+    Lsolve_inplace(preconditioner_chol_, residual);
+    return -0.5 * residual.normsq() / step_size_;
+  }
+
+  Vector MultivariateLangevinSampler::proposal_mean(
+      const Vector &x, const Vector &gradient) const {
+    Vector ans = preconditioner_ * gradient;
+    ans *= 0.5 * step_size_;
+    ans += x;
+    return ans;
+  }
+
+  void MultivariateLangevinSampler::update_running_moments(const Vector &x) {
+    // Welford's algorithm for the running mean and sum of squared
+    // deviations.
+    ++number_of_observed_draws_;
+    Vector delta = x - running_mean_;
+    running_mean_.axpy(delta, 1.0 / number_of_observed_draws_);
+    running_sum_of_squares_.add_outer2(delta, x - running_mean_, 0.5);
+
+    int dim = x.size();
+    if (number_of_observed_draws_ > 2 * dim
+        && number_of_observed_draws_ % preconditioner_update_frequency_ == 0) {
+      SpdMatrix variance =
+          running_sum_of_squares_ / (number_of_observed_draws_ - 1.0);
+      // A small ridge keeps the preconditioner positive definite if
+      // the chain has not yet moved in some direction.
+      variance.diag() += 1e-8 * (1.0 + variance.trace() / dim);
+      bool ok = true;
+      Matrix L = variance.chol(ok);
+      if (ok) {
+        preconditioner_ = variance;
+        preconditioner_chol_ = L;
+      }
+    }
+  }
+
+  void MultivariateLangevinSampler::adapt_step_size(
+      double log_acceptance_ratio) {
+    // A Robbins-Monro update of log(h) with a decaying gain, so the
+    // amount of adaptation vanishes as the chain runs.
+    double acceptance_probability =
+        log_acceptance_ratio >= 0 ? 1.0 : exp(log_acceptance_ratio);
+    double gain = 1.0 / pow(number_of_draws_ + 1.0, 0.6);
+    step_size_ *= exp(gain * (acceptance_probability
+                              - target_acceptance_rate_));
+  }
+
+}  // namespace BOOM
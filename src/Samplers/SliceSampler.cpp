@@ -25,13 +25,51 @@
 #include <stdexcept>
 
 namespace BOOM {
+
+  ParallelBatchTarget::ParallelBatchTarget(const Func &f,
+                                           int number_of_threads)
+      : f_(f),
+        pool_(new ThreadWorkerPool(number_of_threads > 1 ?
+                                   number_of_threads : 0))
+  {}
+
+  Vector ParallelBatchTarget::operator()(const Matrix &points) const {
+    int n = points.nrow();
+    Vector ans(n);
+    int nthreads = pool_->number_of_threads();
+    if (nthreads <= 1 || n <= 1) {
+      for (int i = 0; i < n; ++i) {
+        ans[i] = f_(points.row(i));
+      }
+      return ans;
+    }
+    int chunk_size = (n + nthreads - 1) / nthreads;
+    int nchunks = (n + chunk_size - 1) / chunk_size;
+    pool_->run_jobs(nchunks, [this, &points, &ans, chunk_size, n](int chunk) {
+        int start = chunk * chunk_size;
+        int end = std::min(n, start + chunk_size);
+        for (int i = start; i < end; ++i) {
+          ans[i] = f_(points.row(i));
+        }
+      });
+    return ans;
+  }
+
+  //======================================================================
   SliceSampler::SliceSampler(Func F, bool Unimodal)
       : unimodal_(Unimodal),
-        logp_(F)
+        logp_(F),
+        batch_size_(1)
   {
     hi_ = lo_ = scale_ = 1.0;
   }
 
+  void SliceSampler::set_batch_target(const BatchFunc &batch_logp,
+                                      int batch_size) {
+    batch_logp_ = batch_logp;
+    batch_size_ = batch_logp ? batch_size : 1;
+  }
+
   // To be called as part of draw().  Set up the bits that define the
   // slice, and make sure everything is finite.
   void SliceSampler::initialize() {
@@ -146,9 +184,102 @@ namespace BOOM {
     }
   }
 
+  // Plans up to batch_size_ doublings, assuming each one leaves the
+  // search unfinished, evaluates them in one batch, and then applies
+  // them in order until the sequential algorithm would have stopped.
+  // The choice of which endpoint to double is either random
+  // (independent of the density values) or, in the unimodal case,
+  // fixed until the endpoint leaves the slice, so the planned points
+  // are exactly those the sequential algorithm would visit.
+  void SliceSampler::find_limits_batched() {
+    int dim = last_position_.size();
+    while (logphi_ > log_p_slice_ || logplo_ > log_p_slice_) {
+      std::vector<bool> upper;
+      std::vector<double> values;
+      double hi = hi_;
+      double lo = lo_;
+      bool unimodal_side = logphi_ > log_p_slice_;
+      for (int j = 0; j < batch_size_; ++j) {
+        bool side = unimodal_ ? unimodal_side : runif_mt(rng(), -1, 1) > 0;
+        double &value(side ? hi : lo);
+        if (value <= 0.0 || !std::isfinite(2.0 * value)) break;
+        value *= 2.0;
+        upper.push_back(side);
+        values.push_back(value);
+      }
+      if (upper.empty()) {
+        // Let the sequential algorithm handle the edge cases.
+        doubling(unimodal_ ? unimodal_side : runif_mt(rng(), -1, 1) > 0);
+        continue;
+      }
+
+      Matrix points(upper.size(), dim);
+      for (int j = 0; j < upper.size(); ++j) {
+        double step = upper[j] ? values[j] : -values[j];
+        points.row(j) = last_position_ + step * random_direction_;
+      }
+      Vector logp = batch_logp_(points);
+
+      for (int j = 0; j < upper.size(); ++j) {
+        if (j > 0 && logphi_ <= log_p_slice_ && logplo_ <= log_p_slice_) {
+          break;
+        }
+        if (std::isnan(logp[j])) {
+          // doubling() knows how to back off from a NaN.
+          doubling(upper[j]);
+          break;
+        }
+        if (upper[j]) {
+          hi_ = values[j];
+          logphi_ = logp[j];
+          if (unimodal_ && logphi_ <= log_p_slice_) break;
+        } else {
+          lo_ = values[j];
+          logplo_ = logp[j];
+          if (unimodal_ && logplo_ <= log_p_slice_) break;
+        }
+      }
+    }
+  }
+
+  // Draws batch_size_ candidates at a time, each from the slice that
+  // would remain if every earlier candidate in the batch were
+  // rejected.  The first acceptable candidate is returned, after
+  // contracting the slice for the rejected candidates before it.
+  Vector SliceSampler::draw_from_slice_batched() {
+    int dim = last_position_.size();
+    Vector lambda(batch_size_);
+    Matrix points(batch_size_, dim);
+    while (true) {
+      double lo = lo_;
+      double hi = hi_;
+      for (int j = 0; j < batch_size_; ++j) {
+        lambda[j] = runif_mt(rng(), -lo, hi);
+        points.row(j) = last_position_ + lambda[j] * random_direction_;
+        if (lambda[j] < 0) {
+          lo = fabs(lambda[j]);
+        } else if (lambda[j] > 0) {
+          hi = lambda[j];
+        }
+      }
+      Vector logp = batch_logp_(points);
+      for (int j = 0; j < batch_size_; ++j) {
+        if (!(logp[j] < log_p_slice_)) {
+          scale_ = hi_ + lo_;
+          return points.row(j);
+        }
+        contract(lambda[j], logp[j]);
+      }
+    }
+  }
+
   Vector SliceSampler::draw(const Vector &theta) {
     last_position_ = theta;
     initialize();
+    if (batch_size_ > 1) {
+      find_limits_batched();
+      return draw_from_slice_batched();
+    }
     find_limits();
     Vector candidate;
     double logp_candidate = log_p_slice_ -1;
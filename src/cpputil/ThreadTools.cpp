@@ -17,6 +17,8 @@
 */
 
 #include <cpputil/ThreadTools.hpp>
+#include <exception>
+#include <vector>
 
 namespace BOOM {
 
@@ -82,6 +84,34 @@ namespace BOOM {
     }
   }
 
+  void ThreadWorkerPool::run_jobs(int number_of_jobs,
+                                  const std::function<void(int)> &job) {
+    if (no_threads()) {
+      for (int i = 0; i < number_of_jobs; ++i) {
+        job(i);
+      }
+      return;
+    }
+    std::vector<std::future<void>> futures;
+    futures.reserve(number_of_jobs);
+    for (int i = 0; i < number_of_jobs; ++i) {
+      futures.emplace_back(submit([&job, i]() { job(i); }));
+    }
+    // Wait for every job before rethrowing, so that no job is left
+    // running with references to the caller's data.
+    std::exception_ptr error;
+    for (int i = 0; i < futures.size(); ++i) {
+      try {
+        futures[i].get();
+      } catch (...) {
+        if (!error) error = std::current_exception();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
   void ThreadWorkerPool::worker_thread() {
     while (!done_) {
       MoveOnlyTaskWrapper task;
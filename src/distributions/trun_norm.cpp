@@ -20,6 +20,7 @@
 #include <distributions.hpp>
 #include <cpputil/math_utils.hpp>
 #include <cpputil/report_error.hpp>
+#include <LinAlg/VectorView.hpp>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -116,6 +117,14 @@
     update_cdf();
   }
   //----------------------------------------------------------------------
+  void TnSampler::reset(double a){
+    x.assign(1, a);
+    logf.assign(1, f(a));
+    dlogf.assign(1, df(a));
+    knots.assign(1, a);
+    update_cdf();
+  }
+  //----------------------------------------------------------------------
   void TnSampler::add_point(double z){
     //  cout << "about to add a point: " << endl;
     //  this->print(cout);
@@ -242,6 +251,62 @@
     return sam.draw(rng);
   }
 
+  namespace {
+    // Draw from the standard normal truncated to (a, infinity), as in
+    // trun_norm_mt, but with a caller-supplied envelope for the tail
+    // case.
+    inline double trun_norm_mt(RNG &rng, double a, TnSampler &sampler){
+      if(a <= 0){
+        while(1){
+          double x = rnorm_mt(rng, 0, 1);
+          if(x > a) return x;}}
+      sampler.reset(a);
+      return sampler.draw(rng);
+    }
+  }  // namespace
+
+  void rtrun_norm_mt(RNG &rng, double mu, double sigma, double cutpoint,
+                     bool positive_support, VectorView output){
+    // Work with the standardized truncation point on the upper tail.
+    double a = positive_support ? (cutpoint - mu) / sigma
+        : (mu - cutpoint) / sigma;
+    double sign = positive_support ? 1.0 : -1.0;
+    int n = output.size();
+    if (a <= 0) {
+      for (int i = 0; i < n; ++i) {
+        double z = rnorm_mt(rng, 0, 1);
+        while (z <= a) z = rnorm_mt(rng, 0, 1);
+        output[i] = mu + sign * sigma * z;
+      }
+    } else if (n > 0) {
+      TnSampler sampler(a);
+      for (int i = 0; i < n; ++i) {
+        output[i] = mu + sign * sigma * sampler.draw(rng);
+      }
+    }
+  }
+
+  void rtrun_norm_mt(RNG &rng, const ConstVectorView &mu, double sigma,
+                     double cutpoint,
+                     const std::vector<bool> &positive_support,
+                     VectorView output){
+    int n = mu.size();
+    if (positive_support.size() != n || output.size() != n) {
+      report_error("The arguments to the vector version of rtrun_norm_mt "
+                   "must all have the same size.");
+    }
+    TnSampler sampler(1.0);
+    for (int i = 0; i < n; ++i) {
+      if (positive_support[i]) {
+        output[i] = mu[i] + sigma * trun_norm_mt(
+            rng, (cutpoint - mu[i]) / sigma, sampler);
+      } else {
+        output[i] = mu[i] - sigma * trun_norm_mt(
+            rng, (mu[i] - cutpoint) / sigma, sampler);
+      }
+    }
+  }
+
   void trun_norm_moments(double mu, double sigma,
                          double cutpoint, bool positive_support,
                          double *mean, double *variance) {
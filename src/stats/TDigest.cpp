@@ -0,0 +1,266 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <stats/TDigest.hpp>
+#include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace BOOM {
+
+  namespace {
+    // The "k2" scale function from Dunning and Ertl, which maps a
+    // quantile q to a scale on which each centroid may span at most
+    // one unit.  The log-odds transform makes centroids in both tails
+    // small, and the normalizer depends weakly on the total weight so
+    // that the number of centroids stays close to the compression.
+    inline double scale_normalizer(double compression, double total) {
+      return compression / (4 * log(std::max(total / compression, 1.0)) + 24);
+    }
+
+    inline double k_scale(double q, double normalizer) {
+      q = std::max(1e-15, std::min(q, 1 - 1e-15));
+      return normalizer * log(q / (1 - q));
+    }
+
+    inline double k_scale_inverse(double k, double normalizer) {
+      double w = exp(k / normalizer);
+      return w / (1 + w);
+    }
+  }  // namespace
+
+  TDigest::TDigest(double compression)
+      : compression_(compression),
+        max_buffer_size_(std::max<int>(10, lround(5 * compression))),
+        min_(infinity()),
+        max_(negative_infinity())
+  {
+    if (compression < 1) {
+      report_error("TDigest compression must be at least 1.");
+    }
+  }
+
+  void TDigest::add(double x, double weight) {
+    if (std::isnan(x)) {
+      report_error("NaN values cannot be added to a TDigest.");
+    }
+    if (weight <= 0) return;
+    buffer_means_.push_back(x);
+    buffer_weights_.push_back(weight);
+    min_ = std::min(min_, x);
+    max_ = std::max(max_, x);
+    if (buffer_means_.size() >= max_buffer_size_) {
+      compress();
+    }
+  }
+
+  void TDigest::add_batch(const std::vector<double> &x) {
+    for (int i = 0; i < x.size(); ++i) {
+      add(x[i]);
+    }
+  }
+
+  void TDigest::add_batch(const ConstVectorView &x) {
+    for (int i = 0; i < x.size(); ++i) {
+      add(x[i]);
+    }
+  }
+
+  void TDigest::merge(const TDigest &other) {
+    if (&other == this) {
+      TDigest copy(other);
+      merge(copy);
+      return;
+    }
+    other.compress();
+    for (int i = 0; i < other.means_.size(); ++i) {
+      buffer_means_.push_back(other.means_[i]);
+      buffer_weights_.push_back(other.weights_[i]);
+    }
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    compress();
+  }
+
+  double TDigest::total_weight() const {
+    return std::accumulate(weights_.begin(), weights_.end(), 0.0)
+        + std::accumulate(buffer_weights_.begin(), buffer_weights_.end(), 0.0);
+  }
+
+  int TDigest::number_of_centroids() const {
+    compress();
+    return means_.size();
+  }
+
+  void TDigest::clear() {
+    means_.clear();
+    weights_.clear();
+    buffer_means_.clear();
+    buffer_weights_.clear();
+    min_ = infinity();
+    max_ = negative_infinity();
+  }
+
+  double TDigest::quantile(double prob) const {
+    if (prob < 0 || prob > 1) {
+      report_error("Probability argument to TDigest::quantile must be "
+                   "between 0 and 1.");
+    }
+    compress();
+    int n = means_.size();
+    if (n == 0) {
+      report_error("Quantiles cannot be computed from an empty TDigest.");
+    }
+    if (n == 1) {
+      return min_ + prob * (max_ - min_);
+    }
+    double total = total_weight();
+    double index = prob * total;
+
+    // Each centroid is treated as having its mean at the center of
+    // the cumulative weight it covers.  Quantiles between centers are
+    // linearly interpolated.  The tails interpolate between the
+    // extreme centroids and the observed min and max.
+    double first_center = weights_[0] / 2;
+    if (index <= first_center) {
+      return min_ + (means_[0] - min_) * index / first_center;
+    }
+    double center = first_center;
+    for (int i = 0; i + 1 < n; ++i) {
+      double gap = (weights_[i] + weights_[i + 1]) / 2;
+      if (index <= center + gap) {
+        return means_[i] + (means_[i + 1] - means_[i]) * (index - center) / gap;
+      }
+      center += gap;
+    }
+    double last_half_weight = weights_[n - 1] / 2;
+    double fraction = std::min(1.0, (index - center) / last_half_weight);
+    return means_[n - 1] + (max_ - means_[n - 1]) * fraction;
+  }
+
+  double TDigest::cdf(double x) const {
+    compress();
+    int n = means_.size();
+    if (n == 0) {
+      report_error("The CDF cannot be computed from an empty TDigest.");
+    }
+    if (x < min_) return 0.0;
+    if (x >= max_) return 1.0;
+    if (n == 1) {
+      return (x - min_) / (max_ - min_);
+    }
+    double total = total_weight();
+    double first_center = weights_[0] / 2;
+    if (x < means_[0]) {
+      return first_center * (x - min_) / (means_[0] - min_) / total;
+    }
+    double center = first_center;
+    for (int i = 0; i + 1 < n; ++i) {
+      double gap = (weights_[i] + weights_[i + 1]) / 2;
+      if (x < means_[i + 1]) {
+        double width = means_[i + 1] - means_[i];
+        double fraction = width > 0 ? (x - means_[i]) / width : 0.5;
+        return (center + gap * fraction) / total;
+      }
+      center += gap;
+    }
+    double last_half_weight = weights_[n - 1] / 2;
+    return (center + last_half_weight * (x - means_[n - 1])
+            / (max_ - means_[n - 1])) / total;
+  }
+
+  Vector TDigest::serialize() const {
+    compress();
+    int n = means_.size();
+    Vector ans(4 + 2 * n);
+    ans[0] = compression_;
+    ans[1] = min_;
+    ans[2] = max_;
+    ans[3] = n;
+    std::copy(means_.begin(), means_.end(), ans.begin() + 4);
+    std::copy(weights_.begin(), weights_.end(), ans.begin() + 4 + n);
+    return ans;
+  }
+
+  void TDigest::deserialize(const ConstVectorView &state) {
+    if (state.size() < 4) {
+      report_error("Serialized TDigest is too short.");
+    }
+    int n = lround(state[3]);
+    if (n < 0 || state.size() != 4 + 2 * n) {
+      report_error("Serialized TDigest has the wrong size.");
+    }
+    clear();
+    compression_ = state[0];
+    max_buffer_size_ = std::max<int>(10, lround(5 * compression_));
+    min_ = state[1];
+    max_ = state[2];
+    for (int i = 0; i < n; ++i) {
+      means_.push_back(state[4 + i]);
+      weights_.push_back(state[4 + n + i]);
+    }
+  }
+
+  void TDigest::compress() const {
+    if (buffer_means_.empty()) return;
+    std::vector<double> means(means_);
+    std::vector<double> weights(weights_);
+    means.insert(means.end(), buffer_means_.begin(), buffer_means_.end());
+    weights.insert(weights.end(), buffer_weights_.begin(),
+                   buffer_weights_.end());
+    buffer_means_.clear();
+    buffer_weights_.clear();
+
+    std::vector<int> order(means.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&means](int i, int j) { return means[i] < means[j]; });
+    double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+    means_.clear();
+    weights_.clear();
+    double current_mean = means[order[0]];
+    double current_weight = weights[order[0]];
+    double weight_so_far = 0;
+    double normalizer = scale_normalizer(compression_, total);
+    double q_limit = k_scale_inverse(
+        k_scale(0.0, normalizer) + 1, normalizer);
+    for (int i = 1; i < order.size(); ++i) {
+      double mean = means[order[i]];
+      double weight = weights[order[i]];
+      double q = (weight_so_far + current_weight + weight) / total;
+      if (q <= q_limit) {
+        current_weight += weight;
+        current_mean += weight * (mean - current_mean) / current_weight;
+      } else {
+        means_.push_back(current_mean);
+        weights_.push_back(current_weight);
+        weight_so_far += current_weight;
+        q_limit = k_scale_inverse(
+            k_scale(weight_so_far / total, normalizer) + 1, normalizer);
+        current_mean = mean;
+        current_weight = weight;
+      }
+    }
+    means_.push_back(current_mean);
+    weights_.push_back(current_weight);
+  }
+
+}  // namespace BOOM
@@ -0,0 +1,302 @@
+/*
+  Copyright (C) 2005-2017 Steven L. Scott
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include <stats/mcmc_convergence.hpp>
+#include <cpputil/math_utils.hpp>
+#include <cpputil/report_error.hpp>
+#include <LinAlg/Vector.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace BOOM {
+
+  namespace {
+    // Summaries of the split chains shared by split_rhat and
+    // effective_sample_size.
+    struct SplitChainSummary {
+      // Each half-chain.
+      std::vector<ConstVectorView> halves;
+      // The mean of each half chain.
+      Vector means;
+      // The average within-chain variance.
+      double within;
+      // The "pooled" variance estimate var+ from BDA3 equation 11.3.
+      double pooled;
+      // Length of each half chain.
+      int length;
+    };
+
+    SplitChainSummary summarize_split_chains(
+        const std::vector<ConstVectorView> &chains) {
+      if (chains.empty()) {
+        report_error("At least one chain is needed to compute "
+                     "convergence diagnostics.");
+      }
+      int n = chains[0].size();
+      for (int i = 1; i < chains.size(); ++i) {
+        if (chains[i].size() != n) {
+          report_error("All chains must be the same length.");
+        }
+      }
+      if (n < 4) {
+        report_error("Chains must have at least 4 draws to compute "
+                     "convergence diagnostics.");
+      }
+
+      SplitChainSummary ans;
+      ans.length = n / 2;
+      // If n is odd the first draw is discarded, so that the halves
+      // are the same length and the most recent draws are kept.
+      int offset = n - 2 * ans.length;
+      for (int i = 0; i < chains.size(); ++i) {
+        ans.halves.push_back(ConstVectorView(chains[i], offset, ans.length));
+        ans.halves.push_back(
+            ConstVectorView(chains[i], offset + ans.length, ans.length));
+      }
+
+      int m = ans.halves.size();
+      double L = ans.length;
+      ans.means.resize(m);
+      ans.within = 0;
+      for (int i = 0; i < m; ++i) {
+        const ConstVectorView &chain(ans.halves[i]);
+        double mu = chain.sum() / L;
+        ans.means[i] = mu;
+        double ss = 0;
+        for (int j = 0; j < ans.length; ++j) {
+          double d = chain[j] - mu;
+          ss += d * d;
+        }
+        ans.within += ss / (L - 1);
+      }
+      ans.within /= m;
+
+      double grand_mean = ans.means.sum() / m;
+      double between = 0;  // This is B / L in BDA3 notation.
+      for (int i = 0; i < m; ++i) {
+        double d = ans.means[i] - grand_mean;
+        between += d * d;
+      }
+      between /= (m - 1);
+      ans.pooled = ((L - 1) / L) * ans.within + between;
+      return ans;
+    }
+  }  // namespace
+
+  double split_rhat(const std::vector<ConstVectorView> &chains) {
+    SplitChainSummary summary = summarize_split_chains(chains);
+    if (summary.within <= 0) {
+      return summary.pooled <= 0 ? 1.0 : infinity();
+    }
+    return sqrt(summary.pooled / summary.within);
+  }
+
+  double effective_sample_size(const std::vector<ConstVectorView> &chains) {
+    SplitChainSummary summary = summarize_split_chains(chains);
+    int m = summary.halves.size();
+    int L = summary.length;
+    double total_draws = static_cast<double>(m) * L;
+    if (summary.pooled <= 0) {
+      return total_draws;
+    }
+
+    // Autocorrelation at lag t, combining information across chains
+    // (BDA3 equation 11.7).
+    auto autocorrelation = [&summary, m, L](int lag) {
+      double average_autocovariance = 0;
+      for (int i = 0; i < m; ++i) {
+        const ConstVectorView &chain(summary.halves[i]);
+        double mu = summary.means[i];
+        double acov = 0;
+        for (int j = 0; j + lag < L; ++j) {
+          acov += (chain[j] - mu) * (chain[j + lag] - mu);
+        }
+        average_autocovariance += acov / L;
+      }
+      average_autocovariance /= m;
+      return 1.0 - (summary.within - average_autocovariance) / summary.pooled;
+    };
+
+    // Geyer's initial monotone sequence: sum pairs of autocorrelations
+    // while the pair sums are positive, forcing them to be
+    // non-increasing.
+    double tau = -1.0;
+    double previous_pair = infinity();
+    for (int lag = 0; lag + 1 < L; lag += 2) {
+      double pair = autocorrelation(lag) + autocorrelation(lag + 1);
+      if (pair <= 0) break;
+      pair = std::min(pair, previous_pair);
+      tau += 2 * pair;
+      previous_pair = pair;
+    }
+    tau = std::max(tau, 1.0 / log10(total_draws + 1.0));
+    return total_draws / tau;
+  }
+
+  //======================================================================
+  void StreamingConvergenceDiagnostics::Batch::add(double value) {
+    ++count;
+    double delta = value - mean;
+    mean += delta / count;
+    sum_of_squares += delta * (value - mean);
+  }
+
+  void StreamingConvergenceDiagnostics::Batch::combine(const Batch &rhs) {
+    double total = count + rhs.count;
+    if (total <= 0) return;
+    double delta = rhs.mean - mean;
+    sum_of_squares += rhs.sum_of_squares + delta * delta * count * rhs.count
+        / total;
+    mean += delta * rhs.count / total;
+    count = total;
+  }
+
+  //----------------------------------------------------------------------
+  StreamingConvergenceDiagnostics::StreamingConvergenceDiagnostics(
+      int number_of_chains, int max_batches)
+      : max_batches_(max_batches),
+        chains_(number_of_chains)
+  {
+    if (number_of_chains < 1) {
+      report_error("At least one chain is needed to compute "
+                   "convergence diagnostics.");
+    }
+    if (max_batches < 4) {
+      report_error("max_batches must be at least 4.");
+    }
+  }
+
+  void StreamingConvergenceDiagnostics::clear() {
+    for (int i = 0; i < chains_.size(); ++i) {
+      chains_[i] = ChainSummary();
+    }
+  }
+
+  void StreamingConvergenceDiagnostics::add(int chain, double value) {
+    ChainSummary &summary(chains_[chain]);
+    summary.current.add(value);
+    if (summary.current.count < summary.batch_size) return;
+    summary.batches.push_back(summary.current);
+    summary.current = Batch();
+    if (summary.batches.size() >= 2 * max_batches_) {
+      for (int i = 0; i < max_batches_; ++i) {
+        summary.batches[i] = summary.batches[2 * i];
+        summary.batches[i].combine(summary.batches[2 * i + 1]);
+      }
+      summary.batches.resize(max_batches_);
+      summary.batch_size *= 2;
+    }
+  }
+
+  int StreamingConvergenceDiagnostics::number_of_draws(int chain) const {
+    return chains_[chain].batches.size() * chains_[chain].batch_size;
+  }
+
+  bool StreamingConvergenceDiagnostics::enough_batches() const {
+    for (int i = 0; i < chains_.size(); ++i) {
+      if (chains_[i].batches.size() < 4) return false;
+    }
+    return true;
+  }
+
+  double StreamingConvergenceDiagnostics::split_rhat() const {
+    if (!enough_batches()) return infinity();
+    std::vector<Batch> halves;
+    for (int i = 0; i < chains_.size(); ++i) {
+      const std::vector<Batch> &batches(chains_[i].batches);
+      int half = batches.size() / 2;
+      int offset = batches.size() - 2 * half;
+      Batch first, second;
+      for (int b = 0; b < half; ++b) {
+        first.combine(batches[offset + b]);
+        second.combine(batches[offset + half + b]);
+      }
+      halves.push_back(first);
+      halves.push_back(second);
+    }
+    int m = halves.size();
+    double L = 0;
+    double within = 0;
+    double grand_mean = 0;
+    for (int i = 0; i < m; ++i) {
+      L += halves[i].count;
+      within += halves[i].sum_of_squares / (halves[i].count - 1);
+      grand_mean += halves[i].mean;
+    }
+    L /= m;
+    within /= m;
+    grand_mean /= m;
+    double between = 0;  // B / L in BDA3 notation.
+    for (int i = 0; i < m; ++i) {
+      double d = halves[i].mean - grand_mean;
+      between += d * d;
+    }
+    between /= (m - 1);
+    double pooled = ((L - 1) / L) * within + between;
+    if (within <= 0) {
+      return pooled <= 0 ? 1.0 : infinity();
+    }
+    return sqrt(pooled / within);
+  }
+
+  double StreamingConvergenceDiagnostics::effective_sample_size() const {
+    if (!enough_batches()) return 0.0;
+    double total_draws = 0;
+    double average_asymptotic_variance = 0;
+    Batch pooled;
+    for (int i = 0; i < chains_.size(); ++i) {
+      const ChainSummary &summary(chains_[i]);
+      const std::vector<Batch> &batches(summary.batches);
+      // Group the stored batches so that each group holds about
+      // sqrt(n) draws, keeping at least 4 groups.
+      double n = batches.size() * summary.batch_size;
+      int group_size = std::max<int>(
+          1, lround(sqrt(n) / summary.batch_size));
+      group_size = std::min<int>(group_size, batches.size() / 4);
+      int number_of_groups = batches.size() / group_size;
+      int offset = batches.size() - number_of_groups * group_size;
+      Vector group_means(number_of_groups);
+      Batch chain_total;
+      for (int g = 0; g < number_of_groups; ++g) {
+        Batch group;
+        for (int b = 0; b < group_size; ++b) {
+          group.combine(batches[offset + g * group_size + b]);
+        }
+        group_means[g] = group.mean;
+        chain_total.combine(group);
+      }
+      double mean_of_means = group_means.sum() / number_of_groups;
+      double ss = 0;
+      for (int g = 0; g < number_of_groups; ++g) {
+        double d = group_means[g] - mean_of_means;
+        ss += d * d;
+      }
+      average_asymptotic_variance += group_size * summary.batch_size
+          * ss / (number_of_groups - 1);
+      total_draws += chain_total.count;
+      pooled.combine(chain_total);
+    }
+    average_asymptotic_variance /= chains_.size();
+    double variance = pooled.sum_of_squares / (pooled.count - 1);
+    if (average_asymptotic_variance <= 0 || variance <= 0) {
+      return total_draws;
+    }
+    return total_draws * variance / average_asymptotic_variance;
+  }
+
+}  // namespace BOOM